@@ -133,6 +133,9 @@ enum ValueFlags
   VF_complete = 0x0400,   ///< CHECK called
   VF_marked   = 0x0800,   ///< marked to detect stale
   VF_temp     = 0x1000,   ///< computed value
+  VF_lazy     = 0x2000,   ///< ravel not yet computed (see Value::is_lazy())
+  VF_fused    = 0x4000,   ///< ravel not yet computed (see Value::is_fused())
+  VF_leaf     = 0x8000,   ///< argument of a fused value (see ScalarFusion)
 };
 
 extern ostream & print_flags(ostream & out, ValueFlags flags);
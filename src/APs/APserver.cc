@@ -19,6 +19,11 @@
 */
 
 // #define USE_POLL   /* use poll() instead of select() */
+// #define USE_SELECT /* use select() instead of epoll() on GNU/Linux */
+
+#if defined(__linux__) && !defined(USE_POLL) && !defined(USE_SELECT)
+# define USE_EPOLL   /* use epoll() with persistent fd registrations */
+#endif
 
 #include <errno.h>
 #include <limits.h>
@@ -31,7 +36,9 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
-#ifdef USE_POLL
+#ifdef USE_EPOLL
+# include <sys/epoll.h>
+#elif defined(USE_POLL)
 # include <poll.h>
 #else
 # include <sys/select.h>
@@ -44,6 +51,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <map>
 #include <sstream>
 #include <vector>
 
@@ -85,21 +93,13 @@ prog_name()
 extern vector<AP3_fd> connected_procs;
 vector<AP3_fd> connected_procs;
 //-----------------------------------------------------------------------------
-struct key_value
-{
-   key_value(SV_key k)
-   : key(k)
-   {}
+/// the current value of all shared variables, indexed by their key
+map<SV_key, string> var_values;
 
-   /// the key for the variable
-  SV_key key;
-
-   /// the value of the variable
-  string var_value;
-};
-
-/// the current value of all shared variables
-vector<key_value> var_values;
+#ifdef USE_EPOLL
+/// the epoll instance watching listen_sock and the connected processors
+static int epoll_fd = -1;
+#endif
 //-----------------------------------------------------------------------------
 
 const char * prog = "????";
@@ -354,18 +354,7 @@ TCP_socket removed_fd2 = NO_TCP_SOCKET;
 
    // retract offers made by the removed processor
    //
-   for (size_t o = 0; o < db.offered_vars.size(); ++o)
-       {
-         Svar_record & svar = db.offered_vars[o];
-
-         if (svar.accepting.id == removed_AP)      svar.remove_accepting();
-         if (svar.offering.id == removed_AP)       svar.remove_offering();
-         if (svar.get_coupling() == NO_COUPLING)
-            {
-              db.offered_vars.erase(db.offered_vars.begin() + o);
-              --o;
-            }
-       }
+   db.retract_processor(removed_AP);
 
    // disconnect dependent processors...
    //
@@ -418,6 +407,22 @@ TCP_socket removed_fd2 = NO_TCP_SOCKET;
       }
 }
 //-----------------------------------------------------------------------------
+/// start (if \b watch) or stop watching \b fd for incoming data
+static void
+watch_fd(int fd, bool watch)
+{
+#ifdef USE_EPOLL
+struct epoll_event event;
+   memset(&event, 0, sizeof(event));
+   event.events = EPOLLIN | EPOLLPRI;
+   event.data.fd = fd;
+
+   if (epoll_ctl(epoll_fd, watch ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, fd, &event))
+      cerr << prog << ": epoll_ctl() failed for fd " << fd << ": "
+           << strerror(errno) << endl;
+#endif
+}
+//-----------------------------------------------------------------------------
 static void
 new_connection(TCP_socket fd)
 {
@@ -428,6 +433,29 @@ AP3_fd ap3_fd;
    ap3_fd.fd         = fd;
 
    connected_procs.push_back(ap3_fd);
+   watch_fd(fd, true);
+}
+//-----------------------------------------------------------------------------
+static void
+accept_connection(int listen_sock)
+{
+struct sockaddr_in from;
+socklen_t from_len = sizeof(sockaddr_in);
+const int new_fd = ::accept(listen_sock, (sockaddr *)&from, &from_len);
+
+   // disable nagle
+   {
+     const int ndelay = 1;
+     setsockopt(new_fd, 6, TCP_NODELAY, &ndelay, sizeof(int));
+   }
+
+   if (new_fd == -1)
+      {
+        cerr << prog << ": ::accept() failed: " << strerror(errno) << endl;
+        exit(1);
+      }
+
+   new_connection((TCP_socket)new_fd);
 }
 //-----------------------------------------------------------------------------
 static void
@@ -496,6 +524,10 @@ AP3_fd * ap_fd = 0;
                           AP3_fd & ap_fd1 = connected_procs[j];
                           if (ap_fd1.ap3 == ap3)
                              {
+                               // fd is only read when APserver waits for
+                               // a response on it (see sid_GET_VALUE)
+                               //
+                               watch_fd(fd, false);
                                ap_fd1.fd2 = fd;
                                connected_procs.erase(connected_procs.begin()
                                            + (ap_fd - &connected_procs[0]));
@@ -653,29 +685,7 @@ AP3_fd * ap_fd = 0;
                debug && *debug << "writing var data for key 0x"
                                << hex << key << dec << endl;
 
-               bool existing = false;
-               for (size_t vv = 0; vv < var_values.size(); ++vv)
-                   {
-                     if (var_values[vv].key == key)
-                        {
-                          existing = true;
-                          var_values[vv].var_value =
-                                    request->get__ASSIGN_WSWS_VAR__cdr_value();
-                          break;
-                        }
-                   }
-
-               if (!existing)   // new variable
-                  {
-                    // in order to avoid unnecessary copying of the new_value
-                    // we first append key with an empty string and then
-                    // update its var_value
-                    //
-                    const key_value kv(key);
-                    var_values.push_back(kv);
-                    var_values.back().var_value =
-                                    request->get__ASSIGN_WSWS_VAR__cdr_value();
-                  }
+               var_values[key] = request->get__ASSIGN_WSWS_VAR__cdr_value();
 
                Svar_record * svar = db.find_var(key, LOC);
                if (svar)   svar->set_state(false, LOC);
@@ -689,18 +699,16 @@ AP3_fd * ap_fd = 0;
                debug && *debug << "reading var data for key 0x"
                                << hex << key << dec << endl;
 
-               for (size_t vv = 0; vv < var_values.size(); ++vv)
-                   {
-                     if (var_values[vv].key == key)
-                        {
-                          WSWS_VALUE_IS_c(fd, var_values[vv].var_value);
+               map<SV_key, string>::const_iterator vv = var_values.find(key);
+               if (vv != var_values.end())
+                  {
+                    WSWS_VALUE_IS_c(fd, vv->second);
 
-                          Svar_record * svar = db.find_var(key, LOC);
-                          if (svar)   svar->set_state(true, LOC);
-                          else cerr << "*** key not in db at " << LOC << endl;
-                          return;
-                        }
-                   }
+                    Svar_record * svar = db.find_var(key, LOC);
+                    if (svar)   svar->set_state(true, LOC);
+                    else cerr << "*** key not in db at " << LOC << endl;
+                    return;
+                  }
                cerr << "*** data not in db at " << LOC << endl;
                string empty;
                WSWS_VALUE_IS_c(fd, empty);
@@ -713,8 +721,8 @@ AP3_fd * ap_fd = 0;
                Svar_record * svar = db.find_var(key, LOC);
                if (svar)
                   {
-                    svar->retract();
-                    if (svar->get_coupling() != NO_COUPLING &&
+                    svar = db.retract_var(svar);
+                    if (svar && svar->get_coupling() != NO_COUPLING &&
                         svar->offering.id.proc < AP_FIRST_USER)
                        {
                     const TCP_socket sock = get_TCP_for_key(key);
@@ -767,17 +775,8 @@ AP3_fd * ap_fd = 0;
                //
                if (allowed && svar && svar->is_ws_to_ws())
                   {
-                    bool have_value = false;
-                    for (size_t vv = 0; vv < var_values.size(); ++vv)
-                        {
-                          if (var_values[vv].key == key)
-                             {
-                               have_value = true;
-                               break;
-                             }
-                        }
-
-                    if (!have_value)   allowed = false;
+                    if (var_values.find(key) == var_values.end())
+                       allowed = false;   // no value yet
                   }
 
                YES_NO_c(fd, allowed);
@@ -897,7 +896,7 @@ struct sockaddr_un local;
         return -13;
       }
 
-   if (::listen(listen_sock, 10))
+   if (::listen(listen_sock, SOMAXCONN))
       {
         cerr << prog << ": ::listen(\""
              << listen_name << "\") failed:" << strerror(errno) << endl;
@@ -940,7 +939,7 @@ sockaddr_in local;
         return -13;
       }
 
-   if (::listen(listen_sock, 10))
+   if (::listen(listen_sock, SOMAXCONN))
       {
         cerr << prog << ": ::listen(fd "
              << listen_sock << ") failed:" << strerror(errno) << endl;
@@ -1094,11 +1093,58 @@ const int listen_sock = got_path ? open_UNIX_socket(listen_name)
 
    if (auto_start && fork())   return 0;         // parent returns (daemonize)
 
-   memset(&db, 0, sizeof(db));
+   (verbosity > 0) && cerr << prog << ": entering main loop..." << endl;
 
+#ifdef USE_EPOLL
+   // the fds of the connected processors are registered once (when they
+   // connect) rather than in every iteration of the main loop.
+   //
+   epoll_fd = epoll_create(100);   // the size is ignored
+   if (epoll_fd == -1)
+      {
+        cerr << prog << ": epoll_create() failed: " << strerror(errno) << endl;
+        return 3;
+      }
+   watch_fd(listen_sock, true);
+
+   for (;;)
+      {
+        struct epoll_event events[100];
+        const int count = epoll_wait(epoll_fd, events, 100, -1);
+        if (count < 0)
+           {
+             if (errno == EINTR)   continue;
+
+             cerr << prog << ": count < 0 in epoll_wait(): "
+                  << strerror(errno) << endl;
+             return 3;
+           }
+
+        for (int e = 0; e < count; ++e)
+           {
+             const TCP_socket fd = (TCP_socket)events[e].data.fd;
+             if (fd == listen_sock)
+                {
+                  accept_connection(listen_sock);
+                  continue;
+                }
+
+             // fd may have been closed by an earlier event (e.g. when a
+             // parent processor has closed its connection)
+             //
+             for (size_t j = 0; j < connected_procs.size(); ++j)
+                 {
+                   if (connected_procs[j].fd == fd)
+                      {
+                        connection_readable(fd);
+                        break;
+                      }
+                 }
+           }
+      }
+#else // select() or poll()
 int max_fd = listen_sock;
 
-   (verbosity > 0) && cerr << prog << ": entering main loop..." << endl;
    for (;;)
       {
         fd_set read_fds;
@@ -1209,26 +1255,7 @@ int max_fd = listen_sock;
         //
         if (FD_ISSET(listen_sock, &read_fds))
            {
-             struct sockaddr_in from;
-             socklen_t from_len = sizeof(sockaddr_in);
-             const int new_fd = ::accept(listen_sock, (sockaddr *)&from,
-                                         &from_len);
-
-             // disable nagle
-             {
-               const int ndelay = 1;
-               setsockopt(new_fd, 6, TCP_NODELAY, &ndelay, sizeof(int));
-             }
-
-             if (new_fd == -1)
-                {
-                  cerr << prog << ": ::accept() failed: "
-                       << strerror(errno) << endl;
-                  exit(1);
-                  continue;
-                }
-
-             new_connection((TCP_socket)new_fd);
+             accept_connection(listen_sock);
              continue;
            }
 
@@ -1240,6 +1267,7 @@ int max_fd = listen_sock;
               if (FD_ISSET(fd, &read_fds))   connection_readable(fd);
             }
       }
+#endif // USE_EPOLL
 }
 //-----------------------------------------------------------------------------
 void
@@ -1283,9 +1311,10 @@ print_db(ostream & out)
 "║     │ ║ Offering  │   │  ║ Accepting │   │  ║OAOA│          ║\n"
 "║ Seq │C║ Proc,par  │Fd2│Fl║ Proc,par  │Fd2│Fl║SSUU│ Varname  ║\n"
 "╠═════╪═╬═══════════╪═══╪══╬═══════════╪═══╪══╬════╪══════════╣\n";
-   for (size_t o = 0; o < db.offered_vars.size(); ++o)
+   for (map<SV_key, Svar_record>::const_iterator it =
+            db.offered_vars.begin(); it != db.offered_vars.end(); ++it)
        {
-         const Svar_record & svar = db.offered_vars[o];
+         const Svar_record & svar = it->second;
          if (svar.valid())   svar.print(out);
        }
 
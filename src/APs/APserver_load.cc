@@ -0,0 +1,421 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2015  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+    A load test for APserver (make load_test).
+
+    A number of processes ("processors") connect to a running APserver,
+    register themselves, and offer some shared variables. Then all of
+    them send the same mix of requests (the requests that an APL
+    interpreter sends most often) as fast as they can. The request
+    throughput and the latencies of the requests are reported.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "config.h"   // for HAVE_ macros
+#ifdef HAVE_SYS_UN_H
+#include <sys/un.h>
+#endif
+
+#include <iostream>
+#include <iomanip>
+
+#define __COMMON_HH_DEFINED__ // to avoid #error in APL_types.hh
+#define AP_NUM /* simple AP_NUM */
+
+#include "APL_types.hh"
+#include "SystemLimits.hh"
+#include "Svar_record.hh"
+#include "Svar_signals.hh"
+
+using namespace std;
+
+const char * prog = "APserver_load";
+
+/// the first processor number used by the load test
+enum { FIRST_PROC = 2000 };
+
+/// number of latency histogram buckets (4 per power of 2 nanoseconds)
+enum { BUCKETS = 4*40 };
+
+/// the results of one processor
+struct Load_result
+{
+   /// the number of requests sent
+   uint64_t requests;
+
+   /// the number of failed requests (no or wrong response)
+   uint64_t failed;
+
+   /// the sum of all latencies (nanoseconds)
+   uint64_t total_ns;
+
+   /// the largest latency (nanoseconds)
+   uint64_t max_ns;
+
+   /// latency histogram: bucket b counts latencies below 2⋆(b+1)÷4 ns
+   uint32_t histogram[BUCKETS];
+};
+
+static int port = APSERVER_PORT;
+static const char * path = 0;
+static int procs = 50;
+static int vars = 2;
+static int requests = 2000;
+
+//-----------------------------------------------------------------------------
+static uint64_t
+now_ns()
+{
+timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+//-----------------------------------------------------------------------------
+static int
+connect_to_APserver()
+{
+#ifdef HAVE_SYS_UN_H
+   if (path)
+      {
+        const int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un remote;
+        memset(&remote, 0, sizeof(sockaddr_un));
+        remote.sun_family = AF_UNIX;
+        strncpy(remote.sun_path + ABSTRACT_OFFSET, path,
+                sizeof(remote.sun_path) - ABSTRACT_OFFSET - 1);
+        if (::connect(sock, (sockaddr *)&remote, sizeof(remote)) == 0)
+           return sock;
+
+        ::close(sock);
+        return -1;
+      }
+#endif
+
+const int sock = socket(AF_INET, SOCK_STREAM, 0);
+
+   // disable nagle
+   {
+     const int ndelay = 1;
+     setsockopt(sock, 6, TCP_NODELAY, &ndelay, sizeof(int));
+   }
+
+sockaddr_in remote;
+   memset(&remote, 0, sizeof(sockaddr_in));
+   remote.sin_family = AF_INET;
+   remote.sin_port = htons(port);
+   remote.sin_addr.s_addr = htonl(0x7F000001);
+
+   if (::connect(sock, (sockaddr *)&remote, sizeof(remote)) == 0)
+      return sock;
+
+   ::close(sock);
+   return -1;
+}
+//-----------------------------------------------------------------------------
+/// receive the response to a request, return false if none was received
+static bool
+response(int sock, Signal_id expected)
+{
+char * del = 0;
+char buffer[2*MAX_SIGNAL_CLASS_SIZE + 40000];
+Signal_base * resp = Signal_base::recv_TCP(sock, buffer, sizeof(buffer),
+                                           del, 0);
+const bool ok = resp && resp->get_sigID() == expected;
+   delete resp;
+   if (del)   delete del;
+   return ok;
+}
+//-----------------------------------------------------------------------------
+/// the work of one processor: setup, wait for \b go, then send requests
+static void
+run_processor(int num, int ready_fd, int go_fd, int result_fd)
+{
+   // a lost connection shall fail the processor rather than kill it
+   //
+   signal(SIGPIPE, SIG_IGN);
+
+const int sock = connect_to_APserver();
+   if (sock == -1)
+      {
+        cerr << prog << ": connect() to APserver failed: "
+             << strerror(errno) << endl;
+        const char failed = 'F';
+        if (write(ready_fd, &failed, 1) != 1)   ;
+        exit(1);
+      }
+
+const AP_num proc = (AP_num)(FIRST_PROC + num);
+   { REGISTER_PROCESSOR_c(sock, proc, 0, 0, false, string(prog)); }
+
+   // offer vars variables (general offers)
+   //
+SV_key * keys = new SV_key[vars];
+bool setup_ok = true;
+   for (int v = 0; v < vars; ++v)
+       {
+         char cname[MAX_SVAR_NAMELEN];
+         snprintf(cname, sizeof(cname), "V%d_%d", num, v);
+         uint32_t vname[MAX_SVAR_NAMELEN];
+         memset(vname, 0, sizeof(vname));
+         for (int c = 0; cname[c]; ++c)   vname[c] = cname[c];
+         const string name((const char *)vname, sizeof(vname));
+
+         { MATCH_OR_MAKE_c(sock, name, AP_GENERAL, 0, 0, proc, 0, 0); }
+
+         char * del = 0;
+         char buffer[2*MAX_SIGNAL_CLASS_SIZE + 16];
+         Signal_base * resp = Signal_base::recv_TCP(sock, buffer,
+                                                    sizeof(buffer), del, 0);
+         keys[v] = resp ? resp->get__MATCH_OR_MAKE_RESULT__key() : 0;
+         delete resp;
+         if (del)   delete del;
+         if (keys[v] == 0)   setup_ok = false;
+       }
+
+   // tell the master that we are ready (or not) and wait until all are
+   //
+char cc = setup_ok ? 0 : 'F';
+   if (write(ready_fd, &cc, 1) != 1 || read(go_fd, &cc, 1) != 1)   exit(1);
+
+Load_result result;
+   memset(&result, 0, sizeof(result));
+
+   for (int r = 0; r < requests; ++r)
+       {
+         const SV_key key = vars ? keys[r % vars] : 0;
+         const uint64_t start = now_ns();
+         bool ok = false;
+         switch(r % 5)
+            {
+              case 0: { GET_EVENTS_c(sock, proc, 0, 0); }
+                      ok = response(sock, sid_EVENTS_ARE);
+                      break;
+
+              case 1: { FIND_OFFERING_ID_c(sock, key); }
+                      ok = response(sock, sid_OFFERING_ID_IS);
+                      break;
+
+              case 2: { READ_SVAR_RECORD_c(sock, key); }
+                      ok = response(sock, sid_SVAR_RECORD_IS);
+                      break;
+
+              case 3: { IS_REGISTERED_ID_c(sock, FIRST_PROC + (r % procs),
+                                           0, 0); }
+                      ok = response(sock, sid_YES_NO);
+                      break;
+
+              default: { GET_OFFERED_VARS_c(sock, proc, 0); }
+                       ok = response(sock, sid_OFFERED_VARS_ARE);
+                       break;
+            }
+
+         const uint64_t ns = now_ns() - start;
+         ++result.requests;
+         if (!ok)   ++result.failed;
+         result.total_ns += ns;
+         if (result.max_ns < ns)   result.max_ns = ns;
+
+         int bucket = ns ? (int)(4*log2(double(ns))) : 0;
+         if (bucket >= BUCKETS)   bucket = BUCKETS - 1;
+         ++result.histogram[bucket];
+       }
+
+   // Load_result is smaller than PIPE_BUF, so that the results of
+   // different processors are not mixed up
+   //
+   if (write(result_fd, &result, sizeof(result)) != sizeof(result))   exit(1);
+   delete [] keys;
+   ::close(sock);
+   exit(0);
+}
+//-----------------------------------------------------------------------------
+/// return the latency (in µs) below which \b percent of the requests were
+static double
+percentile(const Load_result & total, double percent)
+{
+const uint64_t wanted = (uint64_t)(total.requests * percent / 100.0);
+uint64_t count = 0;
+   for (int b = 0; b < BUCKETS; ++b)
+       {
+         count += total.histogram[b];
+         if (count >= wanted)   return pow(2.0, (b + 1)/4.0) / 1000.0;
+       }
+
+   return total.max_ns / 1000.0;
+}
+//-----------------------------------------------------------------------------
+static void
+usage()
+{
+   cerr <<
+"usage: " << prog << " [options]\n"
+"    options: \n"
+"    -h, --help             print this help\n"
+"    --path <unix-sock>     connect to APserver on unix-sock\n"
+"    --port <tcp-port>      connect to APserver on TCP port tcp-port\n"
+"    --procs <n>            number of processors (default: " << procs << ")\n"
+"    --vars <n>             variables offered per processor (default: "
+                            << vars << ")\n"
+"    --requests <n>         requests per processor (default: "
+                            << requests << ")\n";
+}
+//-----------------------------------------------------------------------------
+int
+main(int argc, char * argv[])
+{
+   for (int a = 1; a < argc; ++a)
+       {
+         const char * opt = argv[a];
+         const char * val = (a < argc - 1) ? argv[a + 1] : 0;
+
+         if (!strcmp(opt, "-h") || !strcmp(opt, "--help"))
+            {
+              usage();
+              return 0;
+            }
+
+         if (val == 0)
+            {
+              cerr << prog << ": missing value for option " << opt << endl;
+              usage();
+              return 1;
+            }
+
+         ++a;
+         if      (!strcmp(opt, "--path"))       path     = val;
+         else if (!strcmp(opt, "--port"))       port     = atoi(val);
+         else if (!strcmp(opt, "--procs"))      procs    = atoi(val);
+         else if (!strcmp(opt, "--vars"))       vars     = atoi(val);
+         else if (!strcmp(opt, "--requests"))   requests = atoi(val);
+         else
+            {
+              cerr << prog << ": unknown command line option " << opt << endl;
+              usage();
+              return 1;
+            }
+       }
+
+   if (procs < 1 || vars < 0 || requests < 1)
+      {
+        usage();
+        return 1;
+      }
+
+int ready_pipe[2];
+int go_pipe[2];
+int result_pipe[2];
+   if (pipe(ready_pipe) || pipe(go_pipe) || pipe(result_pipe))
+      {
+        cerr << prog << ": pipe() failed: " << strerror(errno) << endl;
+        return 2;
+      }
+
+   cerr << prog << ": starting " << procs << " processors with "
+        << vars << " shared variables each..." << endl;
+
+   for (int p = 0; p < procs; ++p)
+       {
+         const pid_t pid = fork();
+         if (pid == -1)
+            {
+              cerr << prog << ": fork() failed: " << strerror(errno) << endl;
+              return 2;
+            }
+
+         if (pid == 0)   // child
+            {
+              // close the master's pipe ends so that the child sees EOF
+              // on go_pipe if the master gives up
+              //
+              ::close(ready_pipe[0]);
+              ::close(go_pipe[1]);
+              ::close(result_pipe[0]);
+              run_processor(p, ready_pipe[1], go_pipe[0], result_pipe[1]);
+            }
+       }
+
+   // wait until all processors are set up, then start them
+   //
+char cc;
+   for (int p = 0; p < procs; ++p)
+       {
+         if (read(ready_pipe[0], &cc, 1) != 1 || cc)
+            {
+              cerr << prog << ": a processor has failed" << endl;
+              return 3;
+            }
+       }
+
+const uint64_t start = now_ns();
+   for (int p = 0; p < procs; ++p)
+       {
+         if (write(go_pipe[1], &cc, 1) != 1)   return 3;
+       }
+
+Load_result total;
+   memset(&total, 0, sizeof(total));
+   for (int p = 0; p < procs; ++p)
+       {
+         Load_result result;
+         if (read(result_pipe[0], &result, sizeof(result)) != sizeof(result))
+            {
+              cerr << prog << ": a processor has failed" << endl;
+              return 3;
+            }
+
+         total.requests += result.requests;
+         total.failed   += result.failed;
+         total.total_ns += result.total_ns;
+         if (total.max_ns < result.max_ns)   total.max_ns = result.max_ns;
+         for (int b = 0; b < BUCKETS; ++b)
+             total.histogram[b] += result.histogram[b];
+       }
+const double seconds = (now_ns() - start) / 1E9;
+
+   while (wait(0) > 0)   ;
+
+   cout << setprecision(4)
+        << "processors:   " << procs << endl
+        << "variables:    " << procs * vars << endl
+        << "requests:     " << total.requests
+        << " (" << total.failed << " failed)" << endl
+        << "throughput:   " << total.requests / seconds
+        << " requests/sec" << endl
+        << "latency (µs): mean " << total.total_ns / 1000.0 / total.requests
+        << ", p50 " << percentile(total, 50)
+        << ", p99 " << percentile(total, 99)
+        << ", max " << total.max_ns / 1000.0 << endl;
+
+   return total.failed ? 4 : 0;
+}
+//-----------------------------------------------------------------------------
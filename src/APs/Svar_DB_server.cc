@@ -42,6 +42,103 @@ extern TCP_socket get_tcp2_for_id();
 extern uint16_t get_udp_port_for_id(const AP_num3 & id);
 extern TCP_socket get_tcp_fd2_for_id(const AP_num3 & id);
 
+//-----------------------------------------------------------------------------
+string
+Svar_DB_server::name_key(const uint32_t * UCS_varname, bool & wild)
+{
+string key;
+   wild = false;
+   for (int v = 0; v < MAX_SVAR_NAMELEN && UCS_varname[v]; ++v)
+       {
+         const uint32_t uni = UCS_varname[v];
+         if (uni == '*' || uni == 0x22C6)   // ⋆
+            {
+              wild = true;
+              break;
+            }
+         key.append((const char *)&uni, sizeof(uni));
+       }
+
+   return key;
+}
+//-----------------------------------------------------------------------------
+void
+Svar_DB_server::index_var(const Svar_record & svar)
+{
+bool wild;
+const string name = name_key(svar.varname, wild);
+
+   if (wild)   wildcard_vars.insert(svar.key);
+   else        name_index.insert(pair<const string, SV_key>(name, svar.key));
+
+   proc_index[svar.offering.id.proc].insert(svar.key);
+   proc_index[svar.accepting.id.proc].insert(svar.key);
+}
+//-----------------------------------------------------------------------------
+void
+Svar_DB_server::unindex_var(SV_key key, const Svar_record & svar)
+{
+bool wild;
+const string name = name_key(svar.varname, wild);
+
+   if (wild)
+      {
+        wildcard_vars.erase(key);
+      }
+   else
+      {
+        typedef multimap<string, SV_key>::iterator It;
+        const pair<It, It> range = name_index.equal_range(name);
+        for (It it = range.first; it != range.second; ++it)
+            {
+              if (it->second == key)
+                 {
+                   name_index.erase(it);
+                   break;
+                 }
+            }
+      }
+
+   proc_index[svar.offering.id.proc].erase(key);
+   if (proc_index[svar.offering.id.proc].size() == 0)
+      proc_index.erase(svar.offering.id.proc);
+
+   proc_index[svar.accepting.id.proc].erase(key);
+   if (proc_index[svar.accepting.id.proc].size() == 0)
+      proc_index.erase(svar.accepting.id.proc);
+}
+//-----------------------------------------------------------------------------
+void
+Svar_DB_server::candidates(const uint32_t * UCS_varname,
+                           vector<SV_key> & keys) const
+{
+bool wild;
+const string name = name_key(UCS_varname, wild);
+
+   if (wild)   // UCS_varname may match any variable
+      {
+        for (map<SV_key, Svar_record>::const_iterator it = offered_vars.begin();
+             it != offered_vars.end(); ++it)   keys.push_back(it->first);
+        return;
+      }
+
+typedef multimap<string, SV_key>::const_iterator It;
+const pair<It, It> range = name_index.equal_range(name);
+   for (It it = range.first; it != range.second; ++it)
+       keys.push_back(it->second);
+
+   for (set<SV_key>::const_iterator it = wildcard_vars.begin();
+        it != wildcard_vars.end(); ++it)   keys.push_back(*it);
+}
+//-----------------------------------------------------------------------------
+const set<SV_key> &
+Svar_DB_server::vars_of(AP_num proc) const
+{
+static const set<SV_key> no_vars;
+
+map<AP_num, set<SV_key> >::const_iterator it = proc_index.find(proc);
+   return it == proc_index.end() ? no_vars : it->second;
+}
 //-----------------------------------------------------------------------------
 Svar_event
 Svar_DB_server::clear_all_events(AP_num3 id)
@@ -50,9 +147,10 @@ int ret = SVE_NO_EVENTS;
 
    // clear event bit in all shared variables
    //
-   for (size_t o = 0; o < offered_vars.size(); ++o)
+const set<SV_key> & keys = vars_of(id.proc);
+   for (set<SV_key>::const_iterator k = keys.begin(); k != keys.end(); ++k)
        {
-         Svar_record & svar = offered_vars[o];
+         Svar_record & svar = offered_vars[*k];
          if (id == svar.offering.id)
             {
               ret |= svar.offering.events;
@@ -73,9 +171,10 @@ Svar_DB_server::get_events(Svar_event & events, AP_num3 proc) const
 {
    // return the first key with an event for proc (if any)
    //
-   for (size_t o = 0; o < offered_vars.size(); ++o)
+const set<SV_key> & keys = vars_of(proc.proc);
+   for (set<SV_key>::const_iterator k = keys.begin(); k != keys.end(); ++k)
        {
-         const Svar_record & svar = offered_vars[o];
+         const Svar_record & svar = offered_vars.find(*k)->second;
          if (proc == svar.offering.id)
             {
               if (svar.offering.events != SVE_NO_EVENTS)    return svar.key;
@@ -116,9 +215,29 @@ Svar_DB_server::find_pairing_key(SV_key key) const
 const Svar_record * svar1 = find_var(key, LOC);
    if (svar1 == 0)   return 0;
 
-   for (size_t o = 0; o < offered_vars.size(); ++o)
+   // the partner of Cxxx is Dxxx and vice versa, and CTL pairs with DAT.
+   // Collect the keys of the variables with these names.
+   //
+vector<SV_key> keys;
+uint32_t partner[MAX_SVAR_NAMELEN + 1];
+   memcpy(partner, svar1->varname, sizeof(partner));
+   partner[MAX_SVAR_NAMELEN] = 0;
+
+   if (partner[0] == 'C')        partner[0] = 'D';
+   else if (partner[0] == 'D')   partner[0] = 'C';
+   else                          return 0;   // neither Cxxx nor Dxxx
+   candidates(partner, keys);
+
+static const uint32_t CTL[] = { 'C', 'T', 'L', 0 };
+static const uint32_t DAT[] = { 'D', 'A', 'T', 0 };
+bool wild;
+const string name = name_key(svar1->varname, wild);
+   if      (name == name_key(CTL, wild))   candidates(DAT, keys);
+   else if (name == name_key(DAT, wild))   candidates(CTL, keys);
+
+   loop(k, keys.size())
        {
-         const Svar_record & svar2 = offered_vars[o];
+         const Svar_record & svar2 = offered_vars.find(keys[k])->second;
          if (!svar2.valid())     continue;
          if (svar2.key == key)   continue;   // don't compare svar1 with svar1
           if (compare_ctl_dat_etc(svar1->varname, svar2.varname))
@@ -137,11 +256,8 @@ Svar_DB_server::find_var(SV_key key, const char * loc) const
         return 0;
       }
 
-   for (size_t o = 0; o < offered_vars.size(); ++o)
-       {
-         const Svar_record & svar = offered_vars[o];
-         if (key == svar.key)   return (Svar_record *)&svar;
-       }
+map<SV_key, Svar_record>::const_iterator it = offered_vars.find(key);
+   if (it != offered_vars.end())   return (Svar_record *)&it->second;
 
    cerr << "*** key 0x" << hex << key << dec
         << " not found in find_var() called from " << loc << endl;
@@ -163,49 +279,26 @@ void
 Svar_DB_server::get_offering_processors(AP_num to_proc,
                                         vector<AP_num> & processors)
 {
-vector<AP_num> procs;
+set<AP_num> procs;   // sorted and without duplicates
 
    // return pending AND matched offers, general or to to_proc
    //
-   for (size_t o = 0; o < offered_vars.size(); ++o)
+set<SV_key> keys(vars_of(to_proc));
+   keys.insert(vars_of(AP_GENERAL).begin(), vars_of(AP_GENERAL).end());
+
+   for (set<SV_key>::const_iterator k = keys.begin(); k != keys.end(); ++k)
        {
-         Svar_record & svar = offered_vars[o];
+         const Svar_record & svar = offered_vars[*k];
          if (!svar.valid())         continue;
 
          if (svar.accepting.id.proc == to_proc)   // specific offer
-             procs.push_back(svar.offering.id.proc);
+             procs.insert(svar.offering.id.proc);
 
          else if (svar.accepting.id.proc == 0)   // general offer
-             procs.push_back(svar.offering.id.proc);
+             procs.insert(svar.offering.id.proc);
        }
 
-   // remove duplicates...
-   //
-   while (procs.size())
-       {
-          // find smallest proc, append it to the result, and remove it
-          //
-          AP_num smallest = procs[0];
-          for (size_t p = 1; p < procs.size(); ++p)
-              {
-                if (smallest > procs[p])   smallest = procs[p];
-              }
-
-         // append to result
-         //
-         processors.push_back(smallest);
-
-         // remove smallest
-         //
-          loop(p, procs.size())
-              {
-                if (smallest == procs[p])
-                   {
-                     procs[p] = procs.back();
-                     procs.pop_back();
-                   }
-              }
-       }
+   processors.insert(processors.end(), procs.begin(), procs.end());
 }
 //-----------------------------------------------------------------------------
 void
@@ -214,9 +307,12 @@ Svar_DB_server::get_offered_variables(AP_num to_proc, AP_num from_proc,
 {
    // return pending variables but not matched offers, general or to to_proc
    //
-   for (size_t o = 0; o < offered_vars.size(); ++o)
+set<SV_key> keys(vars_of(to_proc));
+   keys.insert(vars_of(AP_GENERAL).begin(), vars_of(AP_GENERAL).end());
+
+   for (set<SV_key>::const_iterator k = keys.begin(); k != keys.end(); ++k)
        {
-         const Svar_record & svar = offered_vars[o];
+         const Svar_record & svar = offered_vars.find(*k)->second;
          if (!svar.valid())         continue;
 
          if (svar.accepting.id.proc == to_proc)   // specific offer
@@ -309,9 +405,11 @@ Svar_DB_server::match_pending_offer(const uint32_t * UCS_varname,
 {
 Svar_record * pending_offer = 0;
 
-   for (size_t o = 0; o < offered_vars.size(); ++o)
+vector<SV_key> keys;
+   candidates(UCS_varname, keys);
+   loop(k, keys.size())
        {
-         Svar_record & svar = offered_vars[o];
+         Svar_record & svar = offered_vars[keys[k]];
          if (svar.get_coupling() != SV_OFFERED)                       continue;
          if (!svar.match_name(UCS_varname))                           continue;
 
@@ -342,9 +440,11 @@ Svar_record * pending_offer = 0;
 
    if (pending_offer)
       {
+         unindex_var(pending_offer->key, *pending_offer);
          pending_offer->accepting = from;
          pending_offer->accepting.tcp_fd = tcp2;
          pending_offer->offering.events = SVE_OFFER_MATCHED;
+         index_var(*pending_offer);
          return pending_offer;            // match found
       }
 
@@ -359,12 +459,11 @@ Svar_DB_server::create_offer(const uint32_t * UCS_varname, const AP_num3 & to,
    // is non-general (i.e. 'to' is a specific processor) then to should
    // get an offer mismatch event.
    //
-   offered_vars.push_back(Svar_record());
-Svar_record * svar = &offered_vars.back();
-
 SV_key key  = from.id.proc;   key <<= 16;
        key |= ++seq;
 
+Svar_record * svar = &offered_vars[key];
+
    svar->key = key;
    for (int v = 0; v < (MAX_SVAR_NAMELEN + 1); ++v)
        {
@@ -377,6 +476,7 @@ SV_key key  = from.id.proc;   key <<= 16;
    svar->offering.tcp_fd = tcp2;
 
    svar->accepting.id = to;
+   index_var(*svar);
 
    // if to is registered then send a signal
    //
@@ -389,3 +489,38 @@ const TCP_socket peer = get_tcp_fd2_for_id(to);
    return svar;   // success
 }
 //-----------------------------------------------------------------------------
+Svar_record *
+Svar_DB_server::retract_var(Svar_record * svar)
+{
+const SV_key key = svar->key;
+
+   unindex_var(key, *svar);
+   svar->retract();
+
+   if (svar->get_coupling() == NO_COUPLING)   // no partner left
+      {
+        offered_vars.erase(key);
+        return 0;
+      }
+
+   index_var(*svar);
+   return svar;
+}
+//-----------------------------------------------------------------------------
+void
+Svar_DB_server::retract_processor(const AP_num3 & removed_AP)
+{
+const set<SV_key> keys(vars_of(removed_AP.proc));   // copy (is modified)
+
+   for (set<SV_key>::const_iterator k = keys.begin(); k != keys.end(); ++k)
+       {
+         Svar_record & svar = offered_vars[*k];
+         unindex_var(*k, svar);
+
+         if (svar.accepting.id == removed_AP)      svar.remove_accepting();
+         if (svar.offering.id == removed_AP)       svar.remove_offering();
+         if (svar.get_coupling() == NO_COUPLING)   offered_vars.erase(*k);
+         else                                      index_var(svar);
+       }
+}
+//-----------------------------------------------------------------------------
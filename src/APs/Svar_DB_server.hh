@@ -23,15 +23,25 @@
 
 #include <stdint.h>
 
+#include <map>
+#include <set>
+#include <string>
 #include <vector>
 
 #include "config.h"   // for HAVE_ macros
 #include "Svar_record.hh"
 
 //-----------------------------------------------------------------------------
-/// the Svar database in the server
+/// the Svar database in the server. The variables are indexed by their
+/// key, by their name, and by the processors that offer or accept them,
+/// so that requests do not scan all variables.
 struct Svar_DB_server
 {
+   /// constructor: empty database
+   Svar_DB_server()
+   : seq(0)
+   {}
+
    /// see Svar_DB::match_or_make()
    SV_key match_or_make(const uint32_t * UCS_varname, const AP_num3 & to,
                         const Svar_partner & from, TCP_socket tcp2);
@@ -77,12 +87,47 @@ struct Svar_DB_server
    /// find offering processor id of the variable with key \b key
    AP_num3 find_offering_id(SV_key key) const;
 
-   /// the offered variables
-   vector<Svar_record> offered_vars;
+   /// retract \b svar on behalf of ProcessorID::get_id() (⎕SVR). Return
+   /// \b svar, or 0 if svar was removed because no partner is left.
+   Svar_record * retract_var(Svar_record * svar);
+
+   /// retract all offers made by and to processor \b removed_AP (which has
+   /// closed its connection)
+   void retract_processor(const AP_num3 & removed_AP);
+
+   /// the shared variables, indexed by their key
+   map<SV_key, Svar_record> offered_vars;
 
 protected:
+   /// return the key of \b UCS_varname in \b name_index and set \b wild
+   /// if the name contains a wildcard (* or ⋆)
+   static string name_key(const uint32_t * UCS_varname, bool & wild);
+
+   /// add \b svar to name_index (or wildcard_vars) and to proc_index
+   void index_var(const Svar_record & svar);
+
+   /// remove \b svar (with key \b key) from the indexes
+   void unindex_var(SV_key key, const Svar_record & svar);
+
+   /// return the keys of all variables whose names may match \b UCS_varname
+   /// (see Svar_record::match_name())
+   void candidates(const uint32_t * UCS_varname, vector<SV_key> & keys) const;
+
+   /// return the keys of all variables offered by or to processor \b proc
+   const set<SV_key> & vars_of(AP_num proc) const;
+
    /// a sequence number helping to create unique keys
    uint32_t seq;
+
+   /// the keys of all variables with a wildcard-free name, indexed by name
+   multimap<string, SV_key> name_index;
+
+   /// the keys of all variables with a wildcard in their name
+   set<SV_key> wildcard_vars;
+
+   /// the keys of all variables, indexed by their offering and by their
+   /// accepting processor
+   map<AP_num, set<SV_key> > proc_index;
 };
 //-----------------------------------------------------------------------------
 /// one connected processors
@@ -162,13 +162,20 @@ unsigned int parent_vid = -1;
 
    if (values[sub_vid]._par)   parent_vid = find_vid(*values[sub_vid]._par);
 
-   out << " parent=\"" << parent_vid << "\" rk=\"" << v.get_rank()<< "\"";
+   out << " parent=\"" << parent_vid << "\"";
+   if (values[sub_vid]._shared)   out << " shared=\"1\"";
+   out << " rk=\"" << v.get_rank()<< "\"";
 
    loop (r, v.get_rank())
       {
         out << " sh-" << r << "=\"" << v.get_shape_item(r) << "\"";
       }
 
+   // a lazy value (e.g. ⍳N on the SI) is saved as its start and step
+   //
+   if (v.is_lazy())   out << " lazy-start=\"" << v.get_lazy_start()
+                          << "\" lazy-step=\""  << v.get_lazy_step() << "\"";
+
    out << "/>" << endl;
    return *this;
 }
@@ -183,9 +190,12 @@ char cc[80];
    out << decr(space, cc);
 
    ++indent;
-const ShapeItem len = v.nz_element_count();
-const Cell * C = &v.get_ravel(0);
-   loop(l, len)   emit_cell(*C++, space);
+   if (!v.is_lazy())   // a lazy value has no ravel (see save_shape())
+      {
+        const ShapeItem len = v.nz_element_count();
+        const Cell * C = &v.get_ravel(0);
+        loop(l, len)   emit_cell(*C++, space);
+      }
 
    space -= leave_char_mode();
    out<< "\"/>" << endl;
@@ -550,7 +560,8 @@ XML_Saving_Archive::emit_token_val(const Token & tok)
         case TV_LIN:   out << " line=\"" << tok.get_fun_line() << "\"";
                        break;
 
-        case TV_VAL:   { const int vid = find_vid(*tok.get_apl_val());
+        case TV_VAL:   { const int vid =
+                                 find_vid(*tok.get_deferred_apl_val());
                          out << " vid=\"" << vid << "\"";
                        }
                        break;
@@ -621,6 +632,28 @@ XML_Saving_Archive::save_vstack_item(const ValueStackItem & vsi)
 XML_Saving_Archive &
 XML_Saving_Archive::save()
 {
+   // collect all values to be saved. We mark the values to avoid
+   // saving of stale values and unmark the used values. This is done
+   // before anything is written, so that a WS FULL (when computing fused
+   // values, see copy_fused_values()) leaves the output unchanged.
+   //
+   Value::mark_all_dynamic_values();
+   Workspace::unmark_all_values();
+
+   for (const DynamicObject * obj = DynamicObject::get_all_values()->get_next();
+        obj != DynamicObject::get_all_values(); obj = obj->get_next())
+       {
+         const Value & val(*(const Value *)obj);
+
+         if (val.is_marked())    continue;   // stale
+
+         val.unmark();
+         values.push_back(_val_par(val));
+       }
+
+   set_parents();
+   copy_fused_values();
+
 tm * t;
    {
      timeval now;
@@ -652,6 +685,7 @@ const int offset = Workspace::get_v_Quad_TZ().get_offset();   // timezone offset
 "        <!ATTLIST Value flg    CDATA #REQUIRED>\n"
 "        <!ATTLIST Value vid    CDATA #REQUIRED>\n"
 "        <!ATTLIST Value parent CDATA #IMPLIED>\n"
+"        <!ATTLIST Value shared CDATA #IMPLIED>\n"
 "        <!ATTLIST Value rk     CDATA #REQUIRED>\n"
 "        <!ATTLIST Value sh-0   CDATA #IMPLIED>\n"
 "        <!ATTLIST Value sh-1   CDATA #IMPLIED>\n"
@@ -661,6 +695,8 @@ const int offset = Workspace::get_v_Quad_TZ().get_offset();   // timezone offset
 "        <!ATTLIST Value sh-5   CDATA #IMPLIED>\n"
 "        <!ATTLIST Value sh-6   CDATA #IMPLIED>\n"
 "        <!ATTLIST Value sh-7   CDATA #IMPLIED>\n"
+"        <!ATTLIST Value lazy-start CDATA #IMPLIED>\n"
+"        <!ATTLIST Value lazy-step  CDATA #IMPLIED>\n"
 "\n"
 "        <!ELEMENT Ravel (#PCDATA)>\n"
 "        <!ATTLIST Ravel vid    CDATA #REQUIRED>\n"
@@ -762,57 +798,14 @@ const int offset = Workspace::get_v_Quad_TZ().get_offset();   // timezone offset
 
    ++indent;
 
-   // collect all values to be saved. We mark the values to avoid
-   // saving of stale values and unmark the used values
-   //
-   Value::mark_all_dynamic_values();
-   Workspace::unmark_all_values();
-
-   for (const DynamicObject * obj = DynamicObject::get_all_values()->get_next();
-        obj != DynamicObject::get_all_values(); obj = obj->get_next())
-       {
-         const Value & val(*(const Value *)obj);
-
-         if (val.is_marked())    continue;   // stale
-
-         val.unmark();
-         values.push_back(_val_par(val));
-       }
-
-   // set up parents of values
-   //
-   loop(p, values.size())
-      {
-        const Value & parent = values[p]._val;
-        const ShapeItem ec = parent.nz_element_count();
-        const Cell * cP = &parent.get_ravel(0);
-        loop(e, ec)
-            {
-              if (cP->is_pointer_cell())
-                 {
-                   const Value & sub = *cP->get_pointer_value().get();
-                   Assert1(&sub);
-                   const int sub_idx = find_vid(sub);
-                   Assert(sub_idx < (int)values.size());
-                   Assert(!values[sub_idx]._par);
-                   values[sub_idx] = _val_par(values[sub_idx]._val, &parent);
-                 }
-              else if (cP->is_lval_cell())
-                 {
-                   Log(LOG_archive)
-                      CERR << "LVAL CELL in " << p << " at " LOC << endl;
-                 }
-              ++cP;
-            }
-      }
-
    // save all values (without their ravel)
    //
    for (vid = 0; vid < (int)values.size(); ++vid)  save_shape(values[vid]._val);
 
    // save ravels of all values
    //
-   for (vid = 0; vid < (int)values.size(); ++vid)   save_Ravel(values[vid]._val);
+   for (vid = 0; vid < (int)values.size(); ++vid)
+       save_Ravel(get_ravel_value(vid));
 
    // save user defined symbols
    //
@@ -864,6 +857,176 @@ const int offset = Workspace::get_v_Quad_TZ().get_offset();   // timezone offset
 
    return *this;
 }
+//-----------------------------------------------------------------------------
+XML_Saving_Archive &
+XML_Saving_Archive::save_delta()
+{
+   // an incremental )SAVE appends a <Delta> element to the workspace file
+   // written by the last full )SAVE (which must have had an empty SI). The
+   // element contains the user-defined symbols that were changed (or
+   // erased) since the last )SAVE, and the system variables. Everything
+   // is collected before the element is written (see save()).
+   //
+
+   // collect the changed symbols
+   //
+const SymbolTable & symtab = Workspace::get_symbol_table();
+int symbol_count = symtab.symbols_allocated();
+DynArray(Symbol *, all_symbols, symbol_count);
+   symtab.get_all_symbols(&all_symbols[0], symbol_count);
+
+vector<const Symbol *> changed;
+   loop(s, symbol_count)
+      {
+        if (all_symbols[s]->is_dirty())   changed.push_back(all_symbols[s]);
+      }
+
+   // collect the values of the changed symbols and of the system variables
+   //
+   loop(c, changed.size())   add_symbol_values(*changed[c]);
+
+#define rw_sv_def(x, _str, _txt) add_symbol_values(Workspace::get_v_ ## x());
+#define ro_sv_def(x, _str, _txt) add_symbol_values(Workspace::get_v_ ## x());
+#include "SystemVariable.def"
+
+   set_parents();
+   copy_fused_values();
+
+tm * t;
+   {
+     timeval now;
+     gettimeofday(&now, 0);
+     t = gmtime(&now.tv_sec);
+   }
+
+const int offset = Workspace::get_v_Quad_TZ().get_offset();   // timezone offset
+
+   out << "<Delta wsid=\""    << Workspace::get_WS_name()
+       << "\" year=\""        << (t->tm_year + 1900)
+       << "\" month=\""       << (t->tm_mon  + 1)
+       << "\" day=\""         <<  t->tm_mday
+       << "\" hour=\""        <<  t->tm_hour
+       << "\" minute=\""      <<  t->tm_min
+       << "\" second=\""      <<  t->tm_sec
+       << "\" timezone=\""    << offset
+       << "\" saving_SVN=\""  << ARCHIVE_SVN
+       << "\">\n" << endl;
+
+   ++indent;
+
+   for (vid = 0; vid < (int)values.size(); ++vid)  save_shape(values[vid]._val);
+   for (vid = 0; vid < (int)values.size(); ++vid)
+       save_Ravel(get_ravel_value(vid));
+
+   // erased symbols are saved as unused names
+   //
+   loop(c, changed.size())   save_symbol(*changed[c]);
+
+#define rw_sv_def(x, _str, _txt) save_symbol(Workspace::get_v_ ## x());
+#define ro_sv_def(x, _str, _txt) save_symbol(Workspace::get_v_ ## x());
+#include "SystemVariable.def"
+
+   --indent;
+
+   do_indent();
+   out << "</Delta>" << endl
+       << char(0) << char(0) <<char(0) <<char(0) << endl;
+
+   return *this;
+}
+//-----------------------------------------------------------------------------
+void
+XML_Saving_Archive::add_symbol_values(const Symbol & sym)
+{
+   loop(v, sym.value_stack_size())
+      {
+        const ValueStackItem & vsi = sym[v];
+        if (vsi.name_class != NC_VARIABLE)   continue;
+
+        if (!!vsi.apl_val)   add_value(vsi.apl_val);
+      }
+}
+//-----------------------------------------------------------------------------
+void
+XML_Saving_Archive::add_value(Value_P val)
+{
+   if (find_vid(*val) != -1)   return;   // already added
+
+   values.push_back(_val_par(*val));
+   if (val->is_lazy() || val->is_fused())   return;   // no sub-values
+
+const ShapeItem ec = val->nz_element_count();
+const Cell * C = &val->get_ravel(0);
+   loop(e, ec)
+      {
+        if (C[e].is_pointer_cell())   add_value(C[e].get_pointer_value());
+      }
+}
+//-----------------------------------------------------------------------------
+void
+XML_Saving_Archive::set_parents()
+{
+   // a sub-value with only one owner is saved with its parent so that
+   // )COPY can find the variable that owns it. Sub-values are shared
+   // between cells (see Cell::init()), so a sub-value may also have several
+   // parents, or be the value of a variable as well. Such a value is saved
+   // only once, and marked as shared (see XML_Loading_Archive::read_Value()).
+   //
+   loop(p, values.size())
+      {
+        const Value & parent = values[p]._val;
+        if (parent.is_lazy() || parent.is_fused())   continue;   // no ravel
+
+        const ShapeItem ec = parent.nz_element_count();
+        const Cell * cP = &parent.get_ravel(0);
+        loop(e, ec)
+            {
+              if (cP->is_pointer_cell())
+                 {
+                   const Value & sub = *cP->get_pointer_value().get();
+                   Assert1(&sub);
+                   const int sub_idx = find_vid(sub);
+                   Assert(sub_idx != -1);
+                   if (values[sub_idx]._par == 0)
+                      values[sub_idx]._par = &parent;
+                 }
+              else if (cP->is_lval_cell())
+                 {
+                   Log(LOG_archive)
+                      CERR << "LVAL CELL in " << p << " at " LOC << endl;
+                 }
+              ++cP;
+            }
+      }
+
+   loop(v, values.size())
+      {
+        _val_par & vp = values[v];
+        if (vp._par && vp._val.get_owner_count() > 1)
+           {
+             vp._par = 0;
+             vp._shared = true;
+           }
+      }
+}
+//-----------------------------------------------------------------------------
+void
+XML_Saving_Archive::copy_fused_values()
+{
+   // the ravel of a lazy value (see Value::is_lazy()) is written from its
+   // start and step, but a fused value (see Value::is_fused()) is computed
+   // into a copy owned by this archive. The value itself remains fused.
+   //
+   loop(v, values.size())
+      {
+        const Value & val = values[v]._val;
+        if (!val.is_fused())   continue;
+
+        Value_P copy = val.fused_copy(LOC);
+        ravel_copies.push_back(copy);
+        values[v]._ravel = copy.get();
+      }
+}
 //=============================================================================
 XML_Loading_Archive::XML_Loading_Archive(const char * _filename, int & dump_fd)
    : fd(-1),
@@ -878,6 +1041,9 @@ XML_Loading_Archive::XML_Loading_Archive(const char * _filename, int & dump_fd)
      copying(false),
      protection(false),
      reading_vids(false),
+     reading_delta(false),
+     delta_count(0),
+     base_length(0),
      have_allowed_objects(false),
      filename(_filename),
      file_is_complete(false)
@@ -1229,11 +1395,13 @@ bool prev_month = false;
 
    Log(LOG_archive)   CERR << "read_Workspace() " << endl;
 
-   // quick check that the file is complete
+   // quick check that the file is complete. The file ends with
+   // </Workspace> or, after incremental )SAVEs, with </Delta>
    //
    for (const UTF8 * c = file_end - 12; (c > data) && (c > file_end - 200); --c)
        {
-         if (!strncmp((const char *)c, "</Workspace>", 12))
+         if (!strncmp((const char *)c, "</Workspace>", 12) ||
+             !strncmp((const char *)c, "</Delta>", 8))
             {
               file_is_complete = true;
               break;
@@ -1290,6 +1458,15 @@ const char ** tag_pos = tag_order;
          else    /* complain */               expect_tag("UNEXPECTED", LOC);
        }
 
+   // apply the changes appended by incremental )SAVEs (if any)
+   //
+   if (!reading_vids)
+      {
+        if (!is_tag("/Workspace"))   skip_to_tag("/Workspace");
+        base_length = data - file_start;
+        while (!next_tag(LOC) && is_tag("Delta"))   read_Delta();
+      }
+
    // loaded workspace can contain stale variables, e.g. shared vars.
    // remove them.
    //
@@ -1332,13 +1509,14 @@ XML_Loading_Archive::read_Value()
 
 const int  vid = find_int_attr("vid", false, 10);
 const int  parent = find_int_attr("parent", true, 10);
+const bool shared = find_int_attr("shared", true, 10) == 1;
 const int  rk  = find_int_attr("rk",  false, 10);
 
    Log(LOG_archive)   CERR << "  read_Value() vid=" << vid << endl;
 
    if (reading_vids)
       {
-         parents.push_back(parent);
+         parents.push_back(shared ? int(SHARED_VALUE) : parent);
          return;
       }
 
@@ -1356,19 +1534,21 @@ Shape sh_value;
    // values in read_Ravel.
    //
 bool no_copy = false;   // assume the value is needed
-   if (copying)
+   if (copying && !reading_delta)   // Delta values are filtered by symbol
       {
-        // if vid is a sub-value then find its topmost owner
+        // if vid is a sub-value then find its topmost owner. A shared
+        // value may be a sub-value of a copied value even if its own
+        // owner is not copied, so shared values are always read.
         //
         int parent = vid;
         for (;;)
             {
               Assert(parent < (int)parents.size());
-              if (parents[parent] == -1)   break;   // topmost owner found
+              if (parents[parent] < 0)   break;   // topmost owner found
               parent = parents[parent];
             }
 
-        no_copy = true;   // assume the value is not needed
+        no_copy = parents[parent] != SHARED_VALUE;
         loop(v, vids_COPY.size())
            {
               if (parent == vids_COPY[v])   // vid is in the list: copy
@@ -1387,8 +1567,18 @@ bool no_copy = false;   // assume the value is needed
       {
         Assert(vid == (int)values.size());
 
-        Value_P val(sh_value, LOC);
-        values.push_back(val);
+        if (find_attr("lazy-start", true))   // lazy value (no ravel)
+           {
+             const APL_Integer start = find_int_attr("lazy-start", false, 10);
+             const APL_Integer step  = find_int_attr("lazy-step",  false, 10);
+             values.push_back(Value::progression(sh_value.get_volume(),
+                                                 start, step, LOC));
+           }
+        else
+           {
+             Value_P val(sh_value, LOC);
+             values.push_back(val);
+           }
       }
 }
 //-----------------------------------------------------------------------------
@@ -1568,6 +1758,8 @@ Value_P val = values[vid];
         return;
       }
 
+   if (val->is_lazy())   return;   // no ravel (see read_Value())
+
 const ShapeItem count = val->nz_element_count();
 Cell * C = &val->get_ravel(0);
 Cell * end = C + count;
@@ -1787,8 +1979,11 @@ Symbol * symbol = Workspace::lookup_existing_symbol(name_ucs);
    // 1. )PCOPY and the symbol exists, or 
    // 2.  there is an object list and this symbol is not contained in the list
    //
-const bool is_protected = symbol && protection;
-const bool is_selected = name_ucs.contained_in(allowed_objects);
+   // a Delta element may change a symbol that was copied before
+   //
+const bool is_protected = symbol && protection && !is_copied(symbol);
+const bool is_selected = name_ucs.contained_in(allowed_objects) ||
+                         (symbol && is_copied(symbol));
 bool no_copy = is_protected || (have_allowed_objects && !is_selected);
 
    if (reading_vids)
@@ -1875,6 +2070,13 @@ bool no_copy = is_protected || (have_allowed_objects && !is_selected);
       }
    Assert(symbol);
 
+   if (copying)   copied_symbols.push_back(symbol);
+
+   // a Delta element replaces the (global) value of a user-defined symbol.
+   // Erased symbols are saved as unused names.
+   //
+   if (reading_delta && symbol->is_user_defined())   symbol->expunge();
+
    loop(d, depth)
       {
         // for )COPY skip d > 0
@@ -1942,6 +2144,37 @@ const int levels = find_int_attr("levels", false, 10);
 }
 //-----------------------------------------------------------------------------
 void
+XML_Loading_Archive::read_Delta()
+{
+   Log(LOG_archive)   CERR << "read_Delta()" << endl;
+
+   // the vids of a Delta element start at 0
+   //
+   values.clear();
+   reading_delta = true;
+
+   for (;;)
+       {
+         next_tag(LOC);
+         if      (is_tag("Value"))    read_Value();
+         else if (is_tag("Ravel"))    read_Ravel();
+         else if (is_tag("Symbol"))   read_Symbol();
+         else if (is_tag("/Delta"))   break;
+         else    /* complain */       expect_tag("UNEXPECTED", LOC);
+       }
+
+   reading_delta = false;
+   ++delta_count;
+}
+//-----------------------------------------------------------------------------
+bool
+XML_Loading_Archive::is_copied(const Symbol * sym) const
+{
+   loop(c, copied_symbols.size())   if (copied_symbols[c] == sym)   return true;
+   return false;
+}
+//-----------------------------------------------------------------------------
+void
 XML_Loading_Archive::read_SI_entry(int lev)
 {
 const int level = find_int_attr("level", false, 10);
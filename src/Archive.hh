@@ -101,6 +101,10 @@ public:
    /// write entire workspace
    XML_Saving_Archive & save();
 
+   /// write the symbols that have changed since the last )SAVE, to be
+   /// appended to the workspace file written by that )SAVE
+   XML_Saving_Archive & save_delta();
+
 protected:
    /// width of one indentation level
    enum { INDENT_LEN = 2 };
@@ -114,6 +118,24 @@ protected:
    /// return the index of the value that has \b cell in its ravel in \b values
    int find_owner(const Cell * val);
 
+   /// add the values of variable \b sym (and their sub-values) to \b values
+   void add_symbol_values(const Symbol & sym);
+
+   /// add \b val and its sub-values to \b values
+   void add_value(Value_P val);
+
+   /// set the parents of the sub-values in \b values, and find the
+   /// sub-values that are shared (see Cell::init())
+   void set_parents();
+
+   /// compute the fused values in \b values into copies owned by \b this
+   /// archive (see _val_par::_ravel)
+   void copy_fused_values();
+
+   /// return the value whose ravel is written for values[\b v]
+   const Value & get_ravel_value(int v) const
+      { return values[v]._ravel ? *values[v]._ravel : values[v]._val; }
+
    /// emit one unicode character (inside "...")
    void emit_unicode(Unicode uni, int & space);
 
@@ -149,9 +171,12 @@ protected:
    struct _val_par
       {
          /// constructor
-         _val_par(const Value & v, const Value * par = 0)
+         _val_par(const Value & v, const Value * par = 0, bool sh = false,
+                  const Value * rav = 0)
          : _val(v),
-           _par(par)
+           _par(par),
+           _shared(sh),
+           _ravel(rav)
          {}
 
          /// the value
@@ -160,14 +185,25 @@ protected:
          /// the optional parent
          const Value * _par;
 
+         /// true if the value has more than one owner (a sub-value of
+         /// several parents, or also the value of a variable)
+         bool _shared;
+
+         /// the computed ravel of a fused value (or 0)
+         const Value * _ravel;
+
          /// compare with \b other
          void operator=(const _val_par & other)
-            { new (this) _val_par(other._val, other._par); }
+            { new (this) _val_par(other._val, other._par, other._shared,
+                                  other._ravel); }
       };
 
    /// all values in the workspace
    vector<_val_par> values;
 
+   /// the computed ravels of fused values (see copy_fused_values())
+   vector<Value_P> ravel_copies;
+
    /// current value number
    int vid;
 
@@ -205,6 +241,14 @@ public:
    /// read vids of top-level variables
    void read_vids();
 
+   /// return the number of incremental )SAVEs read by read_Workspace()
+   int get_delta_count() const
+      { return delta_count; }
+
+   /// return the length of the file without incremental )SAVEs
+   int64_t get_base_length() const
+      { return base_length; }
+
 protected:
    /// move to next tag, return true if EOF
    bool next_tag(const char * loc);
@@ -246,6 +290,12 @@ protected:
    /// read next StateIndicator element
    void read_StateIndicator();
 
+   /// read next Delta element (written by an incremental )SAVE)
+   void read_Delta();
+
+   /// return \b true if \b sym was created or changed by this )COPY
+   bool is_copied(const Symbol * sym) const;
+
    /// read next StateIndicator entry
    void read_SI_entry(int level);
 
@@ -356,6 +406,19 @@ protected:
    /// true if reading vids (preparation for )COPY or )PCOPY)
    bool reading_vids;
 
+   /// true if reading a Delta element
+   bool reading_delta;
+
+   /// the number of Delta elements read
+   int delta_count;
+
+   /// the length of the file without Delta elements
+   int64_t base_length;
+
+   /// the symbols created or changed by )COPY (so that Delta elements
+   /// can change them again)
+   vector<const Symbol *> copied_symbols;
+
    /// the vids to be copied (empty if all)
    vector<int> vids_COPY;
 
@@ -372,9 +435,13 @@ protected:
        int pvid;   ///< parent's value ID
      };
 
-   /// parents[vid] os the parent of vid, or -1 if vid is a top-level value
+   /// parents[vid] os the parent of vid, -1 if vid is a top-level value,
+   /// or SHARED_VALUE if vid has several owners
    vector<int> parents;
 
+   /// parents[vid] of a shared value
+   enum { SHARED_VALUE = -2 };
+
    /// the file name from which this archive was read
    const char * filename;
 
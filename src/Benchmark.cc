@@ -0,0 +1,533 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2015  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "Benchmark.hh"
+#include "Command.hh"
+#include "Common.hh"
+#include "StateIndicator.hh"
+#include "Symbol.hh"
+#include "UserPreferences.hh"
+#include "Value.icc"
+#include "Workspace.hh"
+
+extern void init_1(const char * argv0, bool log_startup);
+extern void init_2(bool log_startup);
+
+/// the workspace used by the )SAVE and )LOAD benchmarks
+#define BENCH_WS "/tmp/apl_bench_ws"
+
+//-----------------------------------------------------------------------------
+/*
+   The benchmarks. The setup lines are executed once (in order) before the
+   benchmark is measured. The variable N (the --size of the benchmark) is
+   defined before the setup lines are executed.
+ */
+const Benchmark_case Benchmark::all_cases[] =
+{
+   // scalar functions per type
+   //
+   { "scalar", "I+I (int)",     "I←?N⍴1000",         "Z←I+I",     "N" },
+   { "scalar", "F+F (float)",   "F←0.5+?N⍴1000",     "Z←F+F",     "N" },
+   { "scalar", "J+J (complex)", "J←0J1+?N⍴1000",     "Z←J+J",     "N" },
+   { "scalar", "B∧B (bool)",    "B←0=?N⍴2",          "Z←B∧B",     "N" },
+   { "scalar", "C=C (char)",    "C←N⍴'abcdefgh'",    "Z←C=C",     "N" },
+   { "scalar", "I×I (int)",     "I←?N⍴1000",         "Z←I×I",     "N" },
+   { "scalar", "F×F (float)",   "F←0.5+?N⍴1000",     "Z←F×F",     "N" },
+   { "scalar", "F⋆0.5",         "F←0.5+?N⍴1000",     "Z←F⋆0.5",   "N" },
+   { "scalar", "I=I",           "I←?N⍴1000",         "Z←I=I",     "N" },
+   { "scalar", "-F",            "F←0.5+?N⍴1000",     "Z←-F",      "N" },
+   { "scalar", "⌊F",            "F←0.5+?N⍴1000",     "Z←⌊F",      "N" },
+
+   // reductions
+   //
+   { "reduce", "+/I",           "I←?N⍴1000",         "Z←+/I",     "N" },
+   { "reduce", "+/F",           "F←0.5+?N⍴1000",     "Z←+/F",     "N" },
+   { "reduce", "⌈/F",           "F←0.5+?N⍴1000",     "Z←⌈/F",     "N" },
+   { "reduce", "∧/B",           "B←0=?N⍴2",          "Z←∧/B",     "N" },
+   { "reduce", "+/M (rows)",    "M←1000 (⌈N÷1000)⍴?N⍴1000",
+                                                     "Z←+/M",     "×/⍴M" },
+   { "reduce", "+⌿M (columns)", "M←1000 (⌈N÷1000)⍴?N⍴1000",
+                                                     "Z←+⌿M",     "×/⍴M" },
+
+   // scans
+   //
+   { "scan",   "+\\I",          "I←?N⍴1000",         "Z←+\\I",    "N" },
+   { "scan",   "∨\\B",          "B←0=?N⍴2",          "Z←∨\\B",    "N" },
+
+   // grade
+   //
+   { "grade",  "⍋I",            "I←?N⍴1000",         "Z←⍋I",      "N" },
+   { "grade",  "⍋F",            "F←0.5+?N⍴1000",     "Z←⍋F",      "N" },
+   { "grade",  "⍒C",            "C←N⍴'abcdefgh'",    "Z←⍒C",      "N" },
+
+   // index generator and index of
+   //
+   { "iota",   "⍳N",            "",                  "Z←⍳N",      "N" },
+   { "iota",   "K⍳I",           "I←?N⍴1000\nK←⍳1000",
+                                                     "Z←K⍳I",     "N" },
+
+   // membership
+   //
+   { "member", "I∊K",           "I←?N⍴1000\nK←2×⍳500",
+                                                     "Z←I∊K",     "N" },
+
+   // inner and outer products
+   //
+   { "inner",  "X+.×Y",         "S←⌈N⋆÷3\nX←?S S⍴1000\nY←?S S⍴1000",
+                                                     "Z←X+.×Y",   "S×S×S" },
+   { "inner",  "X∧.=Y",         "S←⌈N⋆÷3\nX←?S S⍴2\nY←?S S⍴2",
+                                                     "Z←X∧.=Y",   "S×S×S" },
+   { "outer",  "V∘.×V",         "V←?(⌈N⋆0.5)⍴1000",  "Z←V∘.×V",   "×/⍴V∘.×V" },
+
+   // indexing
+   //
+   { "index",  "I[P]",          "I←?N⍴1000\nP←?N⍴N", "Z←I[P]",    "N" },
+   { "index",  "M[;P]",         "M←1000 (⌈N÷1000)⍴?N⍴1000\nP←⍳⌈N÷1000",
+                                                     "Z←M[;P]",   "×/⍴M" },
+
+   // catenate
+   //
+   { "catenate", "I,I",         "I←?N⍴1000",         "Z←I,I",     "2×N" },
+   { "catenate", "M,M",         "M←1000 (⌈N÷1000)⍴?N⍴1000",
+                                                     "Z←M,M",     "2××/⍴M" },
+   { "catenate", "M⍪M",         "M←1000 (⌈N÷1000)⍴?N⍴1000",
+                                                     "Z←M⍪M",     "2××/⍴M" },
+
+   // format
+   //
+   { "format", "⍕I",            "I←?(⌈N÷10)⍴1000",   "Z←⍕I",      "⍴I" },
+   { "format", "⍕F",            "F←(?(⌈N÷10)⍴1000)÷7",
+                                                     "Z←⍕F",      "⍴F" },
+   { "format", "10 3⍕F",        "F←(?(⌈N÷10)⍴1000)÷7",
+                                                     "Z←10 3⍕F",  "⍴F" },
+
+   // execute
+   //
+   { "execute", "⍎'1+2'",       "",                  "Z←⍎'1+2'",  "1" },
+   { "execute", "⍎⍕I",          "I←?(⌈N÷10)⍴1000\nT←⍕I",
+                                                     "Z←⍎T",      "⍴I" },
+
+   // calls of defined functions (K calls each)
+   //
+   { "call",   "niladic",       "K←⌈N÷100\n⊣⎕FX 'Z←NIL' 'Z←1'\n"
+                                "⊣⎕FX 'Z←CALL0 K' 'Z←0' 'L:→(0>K←K-1)/0'"
+                                " 'Z←NIL' '→L'",
+                                                     "Z←CALL0 K", "K" },
+   { "call",   "monadic",       "K←⌈N÷100\n⊣⎕FX 'Z←MON B' 'Z←B'\n"
+                                "⊣⎕FX 'Z←CALL1 K' 'Z←0' 'L:→(0>K←K-1)/0'"
+                                " 'Z←MON K' '→L'",
+                                                     "Z←CALL1 K", "K" },
+   { "call",   "dyadic",        "K←⌈N÷100\n⊣⎕FX 'Z←A DYA B;C' 'C←A' 'Z←B'\n"
+                                "⊣⎕FX 'Z←CALL2 K' 'Z←0' 'L:→(0>K←K-1)/0'"
+                                " 'Z←K DYA K' '→L'",
+                                                     "Z←CALL2 K", "K" },
+
+   // workspace )SAVE and )LOAD (of a workspace containing N integers)
+   //
+   { "workspace", ")SAVE",      "⊣⎕EX ⊃'B' 'C' 'F' 'J' 'K' 'M' 'P' 'S' 'T'"
+                                " 'V' 'X' 'Y' 'Z' 'BENCH∆'\nI←?N⍴1000\n"
+                                ")WSID " BENCH_WS,
+                                                     ")SAVE " BENCH_WS, "N" },
+   { "workspace", ")LOAD",      "",                  ")LOAD " BENCH_WS, "N" },
+
+   { 0, 0, 0, 0, 0 }
+};
+//=============================================================================
+Benchmark::Benchmark(int reps, int wup, ShapeItem sz)
+   : repetitions(reps),
+     warmup(wup),
+     size(sz)
+{
+}
+//-----------------------------------------------------------------------------
+uint64_t
+Benchmark::now_ns()
+{
+timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return 1000000000ULL*ts.tv_sec + ts.tv_nsec;
+}
+//-----------------------------------------------------------------------------
+void
+Benchmark::execute(const char * statement)
+{
+UTF8_string utf(statement);
+UCS_string line(utf);
+
+   if (line.size() && (line[0] == UNI_ASCII_R_PARENT ||
+                        line[0] == UNI_ASCII_R_BRACK))
+      {
+        // APL command. Discard its output (including the messages that
+        // some commands, e.g. )LOAD, print directly to COUT and CERR)
+        //
+        stringstream out;
+        streambuf * cout_buf = COUT.rdbuf(out.rdbuf());
+        streambuf * cerr_buf = CERR.rdbuf(out.rdbuf());
+        Command::do_APL_command(out, line);
+        COUT.rdbuf(cout_buf);
+        CERR.rdbuf(cerr_buf);
+      }
+   else
+      {
+        Command::do_APL_expression(line);
+      }
+}
+//-----------------------------------------------------------------------------
+ShapeItem
+Benchmark::eval_int(const char * expr)
+{
+UTF8_string statement("BENCH∆←");
+   statement.append_str(expr);
+   execute(statement.c_str());
+
+Symbol * symbol = Workspace::lookup_existing_symbol(
+                                         UCS_string(UTF8_string("BENCH∆")));
+   if (symbol == 0 || !symbol->get_value())   return 0;
+
+Value_P value = symbol->get_value();
+   if (value->element_count() != 1)   return 0;
+   return value->get_ravel(0).get_near_int();
+}
+//-----------------------------------------------------------------------------
+void
+Benchmark::run(const char * filter)
+{
+   for (const Benchmark_case * bc = all_cases; bc->name; ++bc)
+       {
+         if (filter && !strstr(bc->group, filter) && !strstr(bc->name, filter))
+            continue;
+
+         run_case(*bc);
+       }
+
+   unlink(BENCH_WS);
+   unlink(BENCH_WS ".xml");
+}
+//-----------------------------------------------------------------------------
+void
+Benchmark::run_case(const Benchmark_case & bcase)
+{
+   {
+     char cc[100];
+     snprintf(cc, sizeof(cc), "N←%lld", (long long)size);
+     execute(cc);
+   }
+
+   // execute the setup lines
+   //
+   for (const char * setup = bcase.setup; *setup;)
+       {
+         const char * end = strchr(setup, '\n');
+         if (end == 0)   end = setup + strlen(setup);
+         const string line(setup, end - setup);
+         execute(line.c_str());
+         setup = *end ? end + 1 : end;
+       }
+
+   if (Workspace::SI_top())
+      {
+        CERR << "*** setup of benchmark " << bcase.name << " failed" << endl;
+        Workspace::clear_SI(CERR);
+        return;
+      }
+
+Benchmark_result result;
+   result.bcase = &bcase;
+   result.items = eval_int(bcase.items);
+
+   loop(w, warmup)   execute(bcase.expression);
+
+vector<double> samples;
+   loop(r, repetitions)
+       {
+         const uint64_t start = now_ns();
+         execute(bcase.expression);
+         const uint64_t end = now_ns();
+         samples.push_back(end - start);
+       }
+
+   if (Workspace::SI_top())
+      {
+        CERR << "*** benchmark " << bcase.name << " failed" << endl;
+        Workspace::clear_SI(CERR);
+        return;
+      }
+
+   sort(samples.begin(), samples.end());
+
+double sum = 0.0;
+   loop(s, samples.size())   sum += samples[s];
+   result.mean_ns = sum / samples.size();
+
+double sum2 = 0.0;
+   loop(s, samples.size())
+      {
+        const double diff = samples[s] - result.mean_ns;
+        sum2 += diff*diff;
+      }
+   result.stddev_ns = sqrt(sum2 / samples.size());
+   result.min_ns    = samples[0];
+   result.median_ns = samples[samples.size() / 2];
+
+   results.push_back(result);
+}
+//-----------------------------------------------------------------------------
+void
+Benchmark::print(ostream & out) const
+{
+   out << left  << setw(10) << "group"
+               << setw(16) << "benchmark"
+       << right << setw(10) << "items"
+               << setw(14) << "min ns"
+               << setw(14) << "median ns"
+               << setw(8)  << "stdev%"
+               << setw(12) << "ns/item" << endl
+       << string(84, '-') << endl;
+
+   loop(r, results.size())
+       {
+         const Benchmark_result & res = results[r];
+         const UCS_string name(UTF8_string(res.bcase->name));
+         out << left << setw(10) << res.bcase->group << UTF8_string(name);
+         loop(n, 16 - name.size())   out << " ";
+         out << right << setw(10) << res.items
+             << setw(14) << ShapeItem(res.min_ns)
+             << setw(14) << ShapeItem(res.median_ns)
+             << setw(8)  << fixed << setprecision(1)
+             << (res.mean_ns ? 100*res.stddev_ns / res.mean_ns : 0.0)
+             << setw(12) << setprecision(3) << res.ns_per_item()
+             << endl;
+       }
+}
+//-----------------------------------------------------------------------------
+void
+Benchmark::write_CSV(ostream & out) const
+{
+   out << "group,benchmark,expression,items,repetitions,"
+          "min_ns,median_ns,mean_ns,stddev_ns,ns_per_item" << endl;
+
+   loop(r, results.size())
+       {
+         const Benchmark_result & res = results[r];
+         const Benchmark_case & bc = *res.bcase;
+         out << CSV_string(bc.group)          << ","
+             << CSV_string(bc.name)           << ","
+             << CSV_string(bc.expression)     << ","
+             << res.items                     << ","
+             << repetitions                   << ","
+             << fixed << setprecision(0)
+             << res.min_ns                    << ","
+             << res.median_ns                 << ","
+             << res.mean_ns                   << ","
+             << res.stddev_ns                 << ","
+             << setprecision(3) << res.ns_per_item() << endl;
+       }
+}
+//-----------------------------------------------------------------------------
+void
+Benchmark::write_JSON(ostream & out) const
+{
+   out << "{" << endl
+       << "  \"size\": "        << size        << "," << endl
+       << "  \"repetitions\": " << repetitions << "," << endl
+       << "  \"warmup\": "      << warmup      << "," << endl
+       << "  \"benchmarks\": [";
+
+   loop(r, results.size())
+       {
+         const Benchmark_result & res = results[r];
+         const Benchmark_case & bc = *res.bcase;
+         out << (r ? "," : "") << endl
+             << "    { \"group\": "  << JSON_string(bc.group)      << ","
+             << " \"benchmark\": "   << JSON_string(bc.name)       << ","
+             << " \"expression\": "  << JSON_string(bc.expression) << ","
+             << " \"items\": "             << res.items             << ","
+             << fixed << setprecision(0)
+             << " \"min_ns\": "            << res.min_ns            << ","
+             << " \"median_ns\": "         << res.median_ns         << ","
+             << " \"mean_ns\": "           << res.mean_ns           << ","
+             << " \"stddev_ns\": "         << res.stddev_ns         << ","
+             << setprecision(3)
+             << " \"ns_per_item\": "       << res.ns_per_item()     << " }";
+       }
+
+   out << endl << "  ]" << endl << "}" << endl;
+}
+//-----------------------------------------------------------------------------
+string
+Benchmark::JSON_string(const char * str)
+{
+string ret("\"");
+   for (; *str; ++str)
+       {
+         const unsigned char cc = *str;
+         if (cc == '"' || cc == '\\')
+            {
+              ret += '\\';
+              ret += cc;
+            }
+         else if (cc < ' ')
+            {
+              char hex[8];
+              snprintf(hex, sizeof(hex), "\\u%4.4X", cc);
+              ret += hex;
+            }
+         else   ret += cc;   // incl. UTF8 bytes of APL characters
+       }
+
+   ret += '"';
+   return ret;
+}
+//-----------------------------------------------------------------------------
+string
+Benchmark::CSV_string(const char * str)
+{
+string ret("\"");
+   for (; *str; ++str)
+       {
+         if (*str == '"')   ret += '"';
+         ret += *str;
+       }
+
+   ret += '"';
+   return ret;
+}
+//-----------------------------------------------------------------------------
+void
+Benchmark::list(ostream & out)
+{
+   for (const Benchmark_case * bc = all_cases; bc->name; ++bc)
+       out << left << setw(10) << bc->group << " " << bc->expression << endl;
+}
+//=============================================================================
+static void
+usage(const char * prog)
+{
+   CERR <<
+"usage: " << prog << " [options]\n"
+"    options: \n"
+"    -h, --help           print this help\n"
+"    --csv file           write results as comma separated values to file\n"
+"    --filter text        run only benchmarks whose group or name contains text\n"
+"    --json file          write results in JSON format to file\n"
+"    --list               list all benchmarks and exit\n"
+"    --reps count         measure every benchmark count times (default: 10)\n"
+"    --size N             vector length N used by the benchmarks"
+                                                   " (default: 1000000)\n"
+"    --warmup count       count executions before measuring (default: 2)\n"
+       << endl;
+}
+//-----------------------------------------------------------------------------
+int
+main(int argc, const char * argv[])
+{
+int reps = 10;
+int warmup = 2;
+ShapeItem size = 1000000;
+const char * filter = 0;
+const char * csv_file = 0;
+const char * json_file = 0;
+
+   for (int a = 1; a < argc; ++a)
+       {
+         const char * opt = argv[a];
+         const char * val = (a + 1 < argc) ? argv[a + 1] : 0;
+         if (!strcmp(opt, "-h") || !strcmp(opt, "--help"))
+            {
+              usage(argv[0]);
+              return 0;
+            }
+
+         if (!strcmp(opt, "--list"))
+            {
+              Benchmark::list(cout);
+              return 0;
+            }
+
+         if (val == 0)
+            {
+              CERR << "option " << opt << " without argument" << endl;
+              usage(argv[0]);
+              return 1;
+            }
+
+         ++a;
+         if      (!strcmp(opt, "--csv"))      csv_file  = val;
+         else if (!strcmp(opt, "--filter"))   filter    = val;
+         else if (!strcmp(opt, "--json"))     json_file = val;
+         else if (!strcmp(opt, "--reps"))     reps      = atoi(val);
+         else if (!strcmp(opt, "--size"))     size      = atoll(val);
+         else if (!strcmp(opt, "--warmup"))   warmup    = atoi(val);
+         else
+            {
+              CERR << "unknown option '" << opt << "'" << endl;
+              usage(argv[0]);
+              return 1;
+            }
+       }
+
+   if (reps < 1)   reps = 1;
+   if (size < 1)   size = 1;
+
+   // initialize the interpreter like libapl does
+   //
+   uprefs.safe_mode = true;
+   uprefs.user_do_svars = false;
+   uprefs.system_do_svars = false;
+   uprefs.requested_id = 2000;
+   init_1(argv[0], false);
+   init_2(false);
+
+Benchmark bench(reps, warmup, size);
+   bench.run(filter);
+   bench.print(cout);
+
+   if (csv_file)
+      {
+        ofstream out(csv_file, ofstream::out);
+        if (out.is_open())   bench.write_CSV(out);
+        else   CERR << "opening " << csv_file << " failed: "
+                    << strerror(errno) << endl;
+      }
+
+   if (json_file)
+      {
+        ofstream out(json_file, ofstream::out);
+        if (out.is_open())   bench.write_JSON(out);
+        else   CERR << "opening " << json_file << " failed: "
+                    << strerror(errno) << endl;
+      }
+
+   return 0;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,143 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2015  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __BENCHMARK_HH_DEFINED__
+#define __BENCHMARK_HH_DEFINED__
+
+#include <stdint.h>
+
+#include <iostream>
+#include <vector>
+
+#include "Common.hh"
+
+using namespace std;
+
+//-----------------------------------------------------------------------------
+/// one benchmark of the apl_bench suite
+struct Benchmark_case
+{
+   /// the group of the benchmark (scalar, reduce, ...)
+   const char * group;
+
+   /// the name of the benchmark
+   const char * name;
+
+   /// APL statements (one per line) executed once before the benchmark
+   const char * setup;
+
+   /// the APL statement (or command) being measured
+   const char * expression;
+
+   /// an APL expression for the number of items processed by expression
+   const char * items;
+};
+//-----------------------------------------------------------------------------
+/// the result of one benchmark
+struct Benchmark_result
+{
+   /// the benchmark
+   const Benchmark_case * bcase;
+
+   /// the number of items processed by the benchmark
+   ShapeItem items;
+
+   /// the fastest execution (nanoseconds)
+   double min_ns;
+
+   /// the median of all executions (nanoseconds)
+   double median_ns;
+
+   /// the average of all executions (nanoseconds)
+   double mean_ns;
+
+   /// the standard deviation of all executions (nanoseconds)
+   double stddev_ns;
+
+   /// median nanoseconds per item
+   double ns_per_item() const
+      { return items ? median_ns / items : median_ns; }
+};
+//-----------------------------------------------------------------------------
+/**
+    A micro-benchmark harness for APL primitives (make bench). Every
+    benchmark is an APL statement that is executed a number of times
+    (after some warm-up executions). The results are reported in
+    nanoseconds per item and can be written in CSV and JSON format so
+    that they can be compared between releases.
+ **/
+class Benchmark
+{
+public:
+   /// constructor
+   Benchmark(int reps, int warmup, ShapeItem size);
+
+   /// run all benchmarks whose group or name contains \b filter
+   void run(const char * filter);
+
+   /// print the results in human-readable form
+   void print(ostream & out) const;
+
+   /// write the results as comma separated values
+   void write_CSV(ostream & out) const;
+
+   /// write the results in JSON format
+   void write_JSON(ostream & out) const;
+
+   /// list all benchmarks
+   static void list(ostream & out);
+
+protected:
+   /// run one benchmark
+   void run_case(const Benchmark_case & bcase);
+
+   /// execute APL statement or command \b statement
+   static void execute(const char * statement);
+
+   /// return an integer value computed by the APL expression \b expr
+   static ShapeItem eval_int(const char * expr);
+
+   /// the current time in nanoseconds
+   static uint64_t now_ns();
+
+   /// \b str as a quoted JSON string (with \\, \" and control chars escaped)
+   static string JSON_string(const char * str);
+
+   /// \b str as a quoted CSV field (with \" doubled)
+   static string CSV_string(const char * str);
+
+   /// number of measured executions per benchmark
+   const int repetitions;
+
+   /// number of (unmeasured) executions before the measurement
+   const int warmup;
+
+   /// the length of the vectors used by the benchmarks
+   const ShapeItem size;
+
+   /// the results of all benchmarks run
+   vector<Benchmark_result> results;
+
+   /// all benchmarks
+   static const Benchmark_case all_cases[];
+};
+//-----------------------------------------------------------------------------
+
+#endif // __BENCHMARK_HH_DEFINED__
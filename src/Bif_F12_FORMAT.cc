@@ -911,7 +911,12 @@ const ShapeItem len_A = A->is_scalar() ? 1 : A->get_shape_item(0);
         return Z;
       }
 
-PrintBuffer pb;
+   // format every column separately and join them once (appending the
+   // columns one by one would copy the rows of Z over and over again).
+   //
+vector<PrintBuffer> pb_cols;
+   pb_cols.reserve(cols_B);
+ShapeItem pb_w = 0;
 
    loop(col, cols_B)
        {
@@ -934,24 +939,26 @@ PrintBuffer pb;
               precision = A->get_ravel(2*col + 1).get_near_int();
             }
 
-         PrintBuffer pb_col(format_col_spec(col_width, precision,
-                                         &B->get_ravel(col), cols_B, rows_B));
+         pb_cols.push_back(format_col_spec(col_width, precision,
+                                        &B->get_ravel(col), cols_B, rows_B));
+         PrintBuffer & pb_col = pb_cols.back();
 
          if (col_width == 0)   pb_col.pad_l(UNI_ASCII_SPACE, 1);
-
-         if (col)   pb.append_col(pb_col);
-         else       pb = pb_col;
+         pb_w += pb_col.get_width(0);
        }
 
-const ShapeItem pb_w = pb.get_width(0);
-const ShapeItem pb_h = pb.get_height();
 Shape shape_Z(shape_B);
    shape_Z.set_last_shape_item(pb_w);
 
 Value_P Z(shape_Z, LOC);
 
-   loop(h, pb_h)
-   loop(w, pb_w)   new (Z->next_ravel()) CharCell(pb.get_char(w, h));
+   loop(h, rows_B)
+   loop(col, cols_B)
+       {
+         const PrintBuffer & pb_col = pb_cols[col];
+         loop(w, pb_col.get_width(0))
+             new (Z->next_ravel()) CharCell(pb_col.get_char(w, h));
+       }
 
    return Z;
 }
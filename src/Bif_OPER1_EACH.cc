@@ -122,6 +122,15 @@ ShapeItem len_Z = 0;
         if (LO->has_result())   Z = Value_P(A->get_shape(), LOC);
       }
 
+   if (!!Z && len_Z > get_dyadic_threshold() && items_parallel(LO, true))
+      {
+        eval_items_parallel(Z.get(), LO, A.get(), 1, dA,
+                            B.get(), len_Z, dB, false);
+        Z->set_default(*B.get());
+        Z->check_value(LOC);
+        return Token(TOK_APL_VALUE1, Z);
+      }
+
    loop(z, len_Z)
       {
         const Cell * cA = &A->get_ravel(dA * z);
@@ -189,6 +198,16 @@ const ShapeItem len_Z = B->element_count();
 Value_P Z;
    if (LO->has_result())   Z = Value_P(B->get_shape(), LOC);
 
+   if (!!Z && LO->get_fun_valence() != 0 &&
+       len_Z > get_monadic_threshold() && items_parallel(LO, false))
+      {
+        eval_items_parallel(Z.get(), LO, 0, 1, 0,
+                            B.get(), len_Z, 1, false);
+        Z->set_default(*B.get());
+        Z->check_value(LOC);
+        return Token(TOK_APL_VALUE1, Z);
+      }
+
    loop (z, len_Z)
       {
         if (LO->get_fun_valence() == 0)
@@ -28,10 +28,15 @@ Bif_OPER1_REDUCE1   Bif_OPER1_REDUCE1::_fun;
 Bif_OPER1_REDUCE  * Bif_OPER1_REDUCE ::fun = &Bif_OPER1_REDUCE ::_fun;
 Bif_OPER1_REDUCE1 * Bif_OPER1_REDUCE1::fun = &Bif_OPER1_REDUCE1::_fun;
 
+Bif_REDUCE::PJob_bool Bif_REDUCE::compress_job;
+
 //-----------------------------------------------------------------------------
 Token
 Bif_REDUCE::replicate(Value_P A, Value_P B, Axis axis)
 {
+   if (A->is_lazy())   A->materialize();
+   if (B->is_lazy())   B->materialize();
+
    // turn scalar B into ,B
    //
 Shape shape_B = B->get_shape();
@@ -47,8 +52,10 @@ Shape shape_B = B->get_shape();
 const ShapeItem len_B = shape_B.get_shape_item(axis);
 ShapeItem len_A = A->element_count();
 ShapeItem len_Z = 0;
+bool bool_A = len_A != 1;   // A is a boolean vector (i.e. compress)
 vector<ShapeItem> rep_counts;
    rep_counts.reserve(len_B);
+vector<ShapeItem> block_ones;   // for boolean A
    if (len_A == 1)   // single a -> a a ... a (len_B times)
       {
         len_A = len_B;
@@ -62,8 +69,10 @@ vector<ShapeItem> rep_counts;
         ShapeItem geq_A = 0;   // number of items >= 0 in A
         loop(a, len_A)
            {
+             if (!(a % PJob_bool::ONES_BLOCK))   block_ones.push_back(len_Z);
              APL_Integer rep_A = A->get_ravel(a).get_near_int();
              rep_counts.push_back(rep_A);
+             if (rep_A > 1 || rep_A < 0)   bool_A = false;
              if (rep_A > 0)        { len_Z += rep_A;   ++geq_A; }
              else if (rep_A < 0)   len_Z -= rep_A;
              else                  ++geq_A;
@@ -79,6 +88,29 @@ Value_P Z(shape_Z, LOC);
 
 const Shape3 shape_B3(shape_B, axis);
 
+   // boolean A: copy the selected items without computing the index of
+   // every item
+   //
+   if (bool_A && len_A == len_B && len_Z)
+      {
+        PJob_bool & job = compress_job;
+        job.cZ         = &Z->get_ravel(0);
+        job.Z          = Z.get();
+        job.cB         = &B->get_ravel(0);
+        job.bits       = &rep_counts[0];
+        job.block_ones = &block_ones[0];
+        job.len_A      = len_A;
+        job.len_B      = len_B;
+        job.len_Z      = len_Z;
+        job.len_l      = shape_B3.l();
+        job.run(PF_compress, shape_B3.h() * len_B, get_dyadic_threshold(),
+                "compress");
+
+        Z->set_default(*B.get());
+        Z->check_value(LOC);
+        return Token(TOK_APL_VALUE1, Z);
+      }
+
    loop(h, shape_B3.h())
       {
         ShapeItem bm = 0;
@@ -116,6 +148,118 @@ const Shape3 shape_B3(shape_B, axis);
    return Token(TOK_APL_VALUE1, Z);
 }
 //-----------------------------------------------------------------------------
+void
+Bif_REDUCE::PF_compress(Thread_context & tctx)
+{
+PJob_bool & job = compress_job;
+const ShapeItem len_l = job.len_l;
+
+ShapeItem s, end_s;   // s = h×len_B + m
+   while (tctx.PF_next_range(s, end_s))
+      {
+        const ShapeItem h = s / job.len_B;
+        ShapeItem m = s - h*job.len_B;
+
+        // the items of row h are the +/A items from h×+/A on
+        //
+        Cell * cZ = job.cZ + (h*job.len_Z + job.ones_before(m))*len_l;
+        const Cell * cB = job.cB + s*len_l;
+
+        if (len_l == 1)   // the most frequent case
+           {
+             // simple cells are copied without branching: to Z if A[m]
+             // is 1 or else to a scratch cell.
+             //
+             Cell scratch;
+             for (; s < end_s; ++s)
+                 {
+                   const ShapeItem bit = job.bits[m];
+                   if (PJob_bool::is_nested(*cB))
+                      {
+                        if (bit)   job.copy_cells(cZ, cB, 1);
+                      }
+                   else
+                      {
+                        memcpy(bit ? cZ : &scratch, cB, sizeof(Cell));
+                      }
+
+                   cZ += bit;
+                   ++cB;
+                   if (++m == job.len_B)   m = 0;
+                 }
+           }
+        else
+           {
+             for (; s < end_s; ++s)
+                 {
+                   if (job.bits[m])
+                      {
+                        job.copy_cells(cZ, cB, len_l);
+                        cZ += len_l;
+                      }
+
+                   cB += len_l;
+                   if (++m == job.len_B)   m = 0;
+                 }
+           }
+      }
+}
+//-----------------------------------------------------------------------------
+void
+Bif_REDUCE::PJob_bool::copy_cells(Cell * dest, const Cell * src,
+                                  ShapeItem len)
+{
+   loop(c, len)
+      {
+        if (!is_nested(src[c]))   // simple cells can be copied bytewise
+           {
+             memcpy(dest + c, src + c, sizeof(Cell));
+           }
+        else if (parallel)   // init() is not thread-safe
+           {
+             nested = true;
+           }
+        else
+           {
+             dest[c].init(src[c], *Z, LOC);
+           }
+      }
+}
+//-----------------------------------------------------------------------------
+void
+Bif_REDUCE::PJob_bool::run(Thread_context::PoolFunction * do_work,
+                           ShapeItem len, ShapeItem threshold,
+                           const char * jname)
+{
+   nested = false;
+
+#if PARALLEL_ENABLED
+   if (  Parallel::run_parallel
+      && Thread_context::get_active_core_count() > 1
+      && len*len_l > PARALLEL_ITEMS
+      && len > threshold
+      && !is_nested(*cB))
+      {
+        parallel = true;
+        const CoreCount cores = Thread_context::get_active_core_count();
+        Thread_context::M_distribute(len, cores);
+        Thread_context::do_work = do_work;
+        Thread_context::M_fork(jname);   // start pool
+        (*do_work)(Thread_context::get_master());
+        Thread_context::M_join();
+
+        // if B was nested after all then do it again serially (and
+        // overwrite the cells that were copied bytewise)
+        //
+        if (!nested)   return;
+      }
+#endif // PARALLEL_ENABLED
+
+   parallel = false;
+   Thread_context::M_distribute(len, CCNT_1);
+   (*do_work)(Thread_context::get_master());
+}
+//-----------------------------------------------------------------------------
 Token
 Bif_REDUCE::reduce(Token & _LO, Value_P B, Axis axis)
 {
@@ -141,6 +285,13 @@ const Shape shape_Z = B->get_shape().without_axis(axis);
 
    if (m_len == 1)   return Bif_F12_RHO::do_reshape(shape_Z, *B);
 
+   if (B->is_lazy())   // e.g. +/⍳N
+      {
+        Value_P Z = reduce_lazy(LO, *B);
+        if (!!Z)   return Token(TOK_APL_VALUE1, Z);
+        B->materialize();
+      }
+
    // non-trivial reduce (len > 1)
    //
    if (LO->may_push_SI())   // user defined LO
@@ -154,9 +305,38 @@ const Shape3 Z3(B3.h(), 1, B3.l());
    return do_reduce(shape_Z, Z3, B3.m(), LO, axis, B, B->get_shape_item(axis));
 }
 //-----------------------------------------------------------------------------
+Value_P
+Bif_REDUCE::reduce_lazy(const Function * LO, const Value & B)
+{
+const ShapeItem len_B = B.element_count();
+const APL_Integer first = B.get_lazy_start();
+const APL_Integer last = first + (len_B - 1)*B.get_lazy_step();
+
+   if (LO == Bif_F12_PLUS::fun)   // +/B is len_B × the mean of first and last
+      {
+        const APL_Float fsum = 0.5 * len_B * (APL_Float(first) + last);
+        if (fsum > LARGE_INT || fsum < SMALL_INT)
+           return FloatScalar(fsum, LOC);
+
+        // len_B × (first + last) is even and fits into APL_Integer
+        const APL_Integer sum = (len_B & 1) ? len_B * ((first + last) / 2)
+                                            : (len_B / 2) * (first + last);
+        return IntScalar(sum, LOC);
+      }
+
+const bool up = first < last;
+   if (LO == Bif_F12_RND_UP::fun)   return IntScalar(up ? last : first, LOC);
+   if (LO == Bif_F12_RND_DN::fun)   return IntScalar(up ? first : last, LOC);
+
+   return Value_P();
+}
+//-----------------------------------------------------------------------------
 Token
 Bif_REDUCE::reduce_n_wise(Value_P A, Token & _LO, Value_P B, Axis axis)
 {
+   if (A->is_lazy())   A->materialize();
+   if (B->is_lazy())   B->materialize();
+
 Function * LO = _LO.get_function();
    Assert(LO);
    if (!LO->has_result())   DOMAIN_ERROR;
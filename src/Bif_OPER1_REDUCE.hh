@@ -35,10 +35,58 @@ public:
    /// function called when a sub-SI for a user defined LO returns
    static bool eoc_REDUCE(Token & token);
 
+   /// overloaded Function::accepts_lazy()
+   virtual bool accepts_lazy() const   { return true; }
+
    /// common implementation of reduce() and reduce_n_wise.
    static Token do_reduce(const Shape & shape_Z, const Shape3 & Z3, ShapeItem a,
                           Function * LO, Axis axis, Value_P B, ShapeItem bm);
 
+   /// the context for a boolean compress A/B or expand A\B
+   struct PJob_bool
+      {
+        enum
+           {
+             /// arguments with more items are done in parallel
+             PARALLEL_ITEMS = 10000,
+
+             /// the number of items of A per block_ones[] entry
+             ONES_BLOCK = 1024,
+           };
+
+        Cell * cZ;                     ///< result ravel
+        Value * Z;                     ///< result value (for nested cells)
+        const Cell * cB;               ///< right argument ravel
+        const ShapeItem * bits;        ///< A (0 or 1)
+        const ShapeItem * block_ones;  ///< [k] = +/(k×ONES_BLOCK)↑A
+        ShapeItem len_A;               ///< ⍴A
+        ShapeItem len_B;               ///< (⍴B)[axis]
+        ShapeItem len_Z;               ///< (⍴Z)[axis]
+        ShapeItem len_l;               ///< ×/(axis+1)↓⍴B
+        bool parallel;                 ///< the job runs in parallel
+        volatile bool nested;          ///< parallel job found nested cells
+
+        /// return +/m↑A
+        ShapeItem ones_before(ShapeItem m) const
+           {
+             const ShapeItem block = m / ONES_BLOCK;
+             ShapeItem ones = block_ones[block];
+             for (ShapeItem a = block*ONES_BLOCK; a < m; ++a)   ones += bits[a];
+             return ones;
+           }
+
+        /// return true if \b cell cannot be copied bytewise
+        static bool is_nested(const Cell & cell)
+           { return cell.get_cell_type() & (CT_POINTER | CT_CELLREF); }
+
+        /// copy \b len cells from \b src to \b dest
+        void copy_cells(Cell * dest, const Cell * src, ShapeItem len);
+
+        /// run \b do_work for \b len items, in parallel if B is large
+        void run(Thread_context::PoolFunction * do_work, ShapeItem len,
+                 ShapeItem threshold, const char * jname);
+      };
+
 protected:
    /// Replicate B according to A along axis.
    Token replicate(Value_P A, Value_P B, Axis axis);
@@ -49,8 +97,17 @@ protected:
    /// LO-reduce B n-wise along axis.
    Token reduce_n_wise(Value_P A, Token & _LO, Value_P B, Axis axis);
 
+   /// return +/B, ⌈/B, or ⌊/B for a lazy B (or 0 for other functions LO)
+   static Value_P reduce_lazy(const Function * LO, const Value & B);
+
    /// finish one iteration
    static Token finish_REDUCE(EOC_arg & arg, bool first);
+
+   /// the context for a boolean compress
+   static PJob_bool compress_job;
+
+   /// compress the items of compress_job
+   static void PF_compress(Thread_context & tctx);
 };
 //-----------------------------------------------------------------------------
 /** Primitive operator reduce along last axis.
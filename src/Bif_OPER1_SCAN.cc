@@ -30,6 +30,8 @@ Bif_OPER1_SCAN1   Bif_OPER1_SCAN1::_fun;
 Bif_OPER1_SCAN  * Bif_OPER1_SCAN ::fun = &Bif_OPER1_SCAN ::_fun;
 Bif_OPER1_SCAN1 * Bif_OPER1_SCAN1::fun = &Bif_OPER1_SCAN1::_fun;
 
+Bif_REDUCE::PJob_bool Bif_SCAN::expand_job;
+
 //-----------------------------------------------------------------------------
 Token
 Bif_SCAN::expand(Value_P A, Value_P B, Axis axis)
@@ -51,8 +53,11 @@ const ShapeItem ec_A = A->element_count();
 ShapeItem ones_A = 0;
 vector<ShapeItem> rep_counts;
    rep_counts.reserve(ec_A);
+vector<ShapeItem> block_ones;
    loop(a, ec_A)
       {
+        if (!(a % Bif_REDUCE::PJob_bool::ONES_BLOCK))
+           block_ones.push_back(ones_A);
         APL_Integer rep_A = A->get_ravel(a).get_near_int();
         rep_counts.push_back(rep_A);
         if      (rep_A == 0)        ;
@@ -88,6 +93,28 @@ ShapeItem inc_2 = 0;              // increment after result m*l items
          inc_2 = shape_Z3.l();
       }
    else if (ones_A != shape_B.get_shape_item(axis))   LENGTH_ERROR;
+   else if (ones_A && !lval)
+      {
+        // B is not replicated: copy the items of B and fill the others
+        // without computing the index of every item
+        //
+        Bif_REDUCE::PJob_bool & job = expand_job;
+        job.cZ         = &Z->get_ravel(0);
+        job.Z          = Z.get();
+        job.cB         = cB;
+        job.bits       = &rep_counts[0];
+        job.block_ones = &block_ones[0];
+        job.len_A      = ec_A;
+        job.len_B      = ones_A;
+        job.len_Z      = ec_A;
+        job.len_l      = shape_Z3.l();
+        job.run(PF_expand, shape_Z3.h() * ec_A, get_dyadic_threshold(),
+                "expand");
+
+        Z->set_default(*B.get());
+        Z->check_value(LOC);
+        return Token(TOK_APL_VALUE1, Z);
+      }
 
    loop(h, shape_Z3.h())
       {
@@ -124,6 +151,53 @@ ShapeItem inc_2 = 0;              // increment after result m*l items
    return Token(TOK_APL_VALUE1, Z);
 }
 //-----------------------------------------------------------------------------
+void
+Bif_SCAN::PF_expand(Thread_context & tctx)
+{
+Bif_REDUCE::PJob_bool & job = expand_job;
+const ShapeItem len_l = job.len_l;
+
+ShapeItem z, end_z;   // z = h×len_A + m
+   while (tctx.PF_next_range(z, end_z))
+      {
+        ShapeItem h = z / job.len_A;
+        ShapeItem m = z - h*job.len_A;
+
+        // the items of row h of B are copied in order, so only the first
+        // B item of the range needs to be computed
+        //
+        const Cell * cB = job.cB + (h*job.len_B + job.ones_before(m))*len_l;
+        const Cell * fill = job.cB + h*job.len_B*len_l;
+        Cell * cZ = job.cZ + z*len_l;
+
+        for (; z < end_z; ++z)
+            {
+              if (job.bits[m])   // copy items from B
+                 {
+                   job.copy_cells(cZ, cB, len_l);
+                   cB += len_l;
+                 }
+              else               // fill items
+                 {
+                   loop(l, len_l)
+                      {
+                        if (!Bif_REDUCE::PJob_bool::is_nested(fill[l]))
+                           cZ[l].init_type(fill[l], *job.Z, LOC);
+                        else if (job.parallel)   job.nested = true;
+                        else   cZ[l].init_type(fill[l], *job.Z, LOC);
+                      }
+                 }
+
+              cZ += len_l;
+              if (++m == job.len_A)   // next row
+                 {
+                   m = 0;
+                   fill = cB;
+                 }
+            }
+      }
+}
+//-----------------------------------------------------------------------------
 Token
 Bif_SCAN::scan(Token & _LO, Value_P B, Axis axis)
 {
@@ -21,6 +21,7 @@
 #ifndef __Bif_OPER1_SCAN_HH_DEFINED__
 #define __Bif_OPER1_SCAN_HH_DEFINED__
 
+#include "Bif_OPER1_REDUCE.hh"
 #include "PrimitiveOperator.hh"
 
 //-----------------------------------------------------------------------------
@@ -42,6 +43,12 @@ protected:
    /// Compute one scan item and store result in Z.
    static void scan_item(Cell * Z, Function * LO, const Cell * B,
                          uint32_t m_len, uint32_t l_len);
+
+   /// the context for a boolean expand
+   static Bif_REDUCE::PJob_bool expand_job;
+
+   /// expand the items of expand_job
+   static void PF_expand(Thread_context & tctx);
 };
 //-----------------------------------------------------------------------------
 /** Primitive operator \ (scan along last axis)
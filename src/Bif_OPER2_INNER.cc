@@ -192,6 +192,7 @@ const ShapeItem Z_len = job.ZAh * job.ZBl;
       && Z_len > get_dyadic_threshold())
       {
         job.cores = Thread_context::get_active_core_count();
+        Thread_context::M_distribute(Z_len, job.cores);
         Thread_context::do_work = PF_scalar_inner_product;
         Thread_context::M_fork("scalar_inner_product");   // start pool
         PF_scalar_inner_product(Thread_context::get_master());
@@ -201,6 +202,7 @@ const ShapeItem Z_len = job.ZAh * job.ZBl;
 #endif // PARALLEL_ENABLED
       {
         job.cores = CCNT_1;
+        Thread_context::M_distribute(Z_len, job.cores);
         PF_scalar_inner_product(Thread_context::get_master());
       }
 
@@ -215,41 +217,39 @@ const uint64_t end_1 = cycle_counter();
 void
 Bif_OPER2_INNER::PF_scalar_inner_product(Thread_context & tctx)
 {
-const ShapeItem Z_len = job.ZAh * job.ZBl;
-
-const ShapeItem slice_len = (Z_len + job.cores - 1)/job.cores;
-ShapeItem z = tctx.get_N() * slice_len;
-ShapeItem end_z = z + slice_len;
-   if (end_z > Z_len)   end_z = Z_len;
+ShapeItem z, end_z;
 
 Cell product;   // the result of LO, e.g. of × in +/×
 
-   for (; z < end_z; ++z)
-       {
-        const ShapeItem zah = z/job.ZBl;         // z row = A row
-        const ShapeItem zbl = z - zah*job.ZBl;   // z column = B column
-        const Cell * row_A = job.cA + job.incA*(zah * job.LO_len);
-        const Cell * col_B = job.cB + job.incB*zbl;
-        loop(l, job.LO_len)
-           {
-             job.ec = (col_B->*job.RO)(&product, row_A);
-             if (job.ec != E_NO_ERROR)   return;
-
-             if (l == 0)   // first element
-                {
-                  job.ec = (col_B->*job.RO)(job.cZ + z, row_A);
-                  if (job.ec != E_NO_ERROR)   return;
-                }
-             else
-                {
-                  job.ec = (col_B->*job.RO)(&product, row_A);
-                  if (job.ec != E_NO_ERROR)   return;
-                  job.ec = (product.*job.LO)(job.cZ + z, job.cZ + z);
-                  if (job.ec != E_NO_ERROR)   return;
-                }
-            row_A += job.incA;
-            col_B += job.incB*job.ZBl;
-           }
-       }
+   while (tctx.PF_next_range(z, end_z))
+      {
+        for (; z < end_z; ++z)
+            {
+              const ShapeItem zah = z/job.ZBl;         // z row = A row
+              const ShapeItem zbl = z - zah*job.ZBl;   // z column = B column
+              const Cell * row_A = job.cA + job.incA*(zah * job.LO_len);
+              const Cell * col_B = job.cB + job.incB*zbl;
+              loop(l, job.LO_len)
+                 {
+                   job.ec = (col_B->*job.RO)(&product, row_A);
+                   if (job.ec != E_NO_ERROR)   return;
+
+                   if (l == 0)   // first element
+                      {
+                        job.ec = (col_B->*job.RO)(job.cZ + z, row_A);
+                        if (job.ec != E_NO_ERROR)   return;
+                      }
+                   else
+                      {
+                        job.ec = (col_B->*job.RO)(&product, row_A);
+                        if (job.ec != E_NO_ERROR)   return;
+                        job.ec = (product.*job.LO)(job.cZ + z, job.cZ + z);
+                        if (job.ec != E_NO_ERROR)   return;
+                      }
+                   row_A += job.incA;
+                   col_B += job.incB*job.ZBl;
+                 }
+            }
+      }
 }
 //-----------------------------------------------------------------------------
@@ -86,6 +86,15 @@ Value_P Z(A->get_shape() + B->get_shape(), LOC);
 const ShapeItem len_B = B->element_count();
 const ShapeItem len_Z = A->element_count() * len_B;
 
+   if (len_Z > get_dyadic_threshold() && items_parallel(RO, true))
+      {
+        eval_items_parallel(Z.get(), RO, A.get(), len_B, 1,
+                            B.get(), len_B, 1, true);
+        Z->set_default(*B.get());
+        Z->check_value(LOC);
+        return Token(TOK_APL_VALUE1, Z);
+      }
+
 Value_P RO_A;
 Value_P RO_B;
 
@@ -158,6 +167,7 @@ const ShapeItem Z_len = job.ZAh * job.ZBl;
       && Z_len > get_dyadic_threshold())
       {
         job.cores = Thread_context::get_active_core_count();
+        Thread_context::M_distribute(Z_len, job.cores);
         Thread_context::do_work = PF_scalar_outer_product;
         Thread_context::M_fork("scalar_outer_product");   // start pool
         PF_scalar_outer_product(Thread_context::get_master());
@@ -167,6 +177,7 @@ const ShapeItem Z_len = job.ZAh * job.ZBl;
 #endif // PARALLEL_ENABLED
       {
         job.cores = CCNT_1;
+        Thread_context::M_distribute(Z_len, job.cores);
         PF_scalar_outer_product(Thread_context::get_master());
       }
 
@@ -181,19 +192,16 @@ const uint64_t end_1 = cycle_counter();
 void
 Bif_OPER2_OUTER::PF_scalar_outer_product(Thread_context & tctx)
 {
-const ShapeItem Z_len = job.ZAh * job.ZBl;
-
-const ShapeItem slice_len = (Z_len + job.cores - 1)/job.cores;
-ShapeItem z = tctx.get_N() * slice_len;
-ShapeItem end_z = z + slice_len;
-   if (end_z > Z_len)   end_z = Z_len;
-
-   for (; z < end_z; ++z)
-       {
-        const ShapeItem zah = z/job.ZBl;
-        const ShapeItem zbl = z - zah*job.ZBl;
-        job.ec = ((job.cB + zbl)->*job.RO)(job.cZ + z, job.cA + zah);
-        if (job.ec != E_NO_ERROR)   return;
-       }
+ShapeItem z, end_z;
+   while (tctx.PF_next_range(z, end_z))
+      {
+        for (; z < end_z; ++z)
+            {
+              const ShapeItem zah = z/job.ZBl;
+              const ShapeItem zbl = z - zah*job.ZBl;
+              job.ec = ((job.cB + zbl)->*job.RO)(job.cZ + z, job.cA + zah);
+              if (job.ec != E_NO_ERROR)   return;
+            }
+      }
 }
 //-----------------------------------------------------------------------------
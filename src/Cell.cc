@@ -65,7 +65,11 @@ Cell::init(const Cell & other, Value & cell_owner, const char * loc)
 
         case CT_POINTER:
              {
-               Value_P Z = other.get_pointer_value()->clone(loc);
+               // share the sub-value rather than cloning it. Sub-values
+               // are copied (one level at a time) when they are modified,
+               // see PointerCell::get_unshared_pointer_value().
+               //
+               Value_P Z = other.get_pointer_value();
 
                new (this) PointerCell(Z, cell_owner);
              }
@@ -147,11 +151,31 @@ Cell::init_type(const Cell & other, Value & cell_owner, const char * loc)
 void
 Cell::copy(Value & val, const Cell * & src, ShapeItem count)
 {
+   copy_ravel(val.next_ravels(count), src, count, val);
+   src += count;
+}
+//-----------------------------------------------------------------------------
+bool
+Cell::copy_ravel(Cell * dst, const Cell * src, ShapeItem count,
+                 Value & cell_owner)
+{
+bool all_simple = true;
+ShapeItem run = 0;   // start of the current run of simple cells
+
    loop(c, count)
       {
-        Assert1(val.more());
-        val.next_ravel()->init(*src++, val, LOC);
+        if (src[c].is_simple_cell())   continue;
+
+        // src[c] is nested (its owner counts need to be maintained)
+        //
+        memcpy(dst + run, src + run, (c - run) * sizeof(Cell));
+        dst[c].init(src[c], cell_owner, LOC);
+        run = c + 1;
+        all_simple = false;
       }
+
+   memcpy(dst + run, src + run, (count - run) * sizeof(Cell));
+   return all_simple;
 }
 //-----------------------------------------------------------------------------
 bool
@@ -100,6 +100,11 @@ public:
    /// Return the APL value of a cell (Asserts for non-pointer cells)
    virtual Value_P get_pointer_value()  const   { DOMAIN_ERROR; }
 
+   /// Return the APL value of a cell, after making sure that it is not
+   /// shared with other cells (copy-on-write before modifying it)
+   virtual Value_P get_unshared_pointer_value(const char * loc)
+      { DOMAIN_ERROR; }
+
    /// Return the APL value of a cell (Asserts for non-lval cells)
    virtual Cell * get_lval_value() const   { LEFT_SYNTAX_ERROR; }
 
@@ -390,6 +395,12 @@ public:
    /// copy (deep) count cells from src to val (which is under construction))
    static void copy(Value & val, const Cell * & src, ShapeItem count);
 
+   /// copy (deep) count cells from src to dst: runs of simple cells
+   /// bytewise and other cells with init(). Return true if all cells
+   /// were simple (and dst can therefore be copied bytewise as well).
+   static bool copy_ravel(Cell * dst, const Cell * src, ShapeItem count,
+                          Value & cell_owner);
+
    /// true iff value is close to an int (within +- qct)
    static bool is_near_int(APL_Float value);
 
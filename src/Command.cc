@@ -69,6 +69,8 @@ bool eof = false;
 void
 Command::process_line(UCS_string & line)
 {
+   Workspace::poll_async_save(COUT, false);
+
    line.remove_leading_whitespaces();
    if (line.size() == 0)   return;   // empty input line
 
@@ -600,6 +602,12 @@ Command::cmd_KEYB(ostream & out)
 void 
 Command::cmd_PSTAT(ostream & out, const UCS_string & arg)
 {
+   if (arg.starts_iwith("CALIBRATE"))
+      {
+        Performance::calibrate_thresholds(out);
+        return;
+      }
+
 #ifndef PERFORMANCE_COUNTERS_WANTED
    out << "\n"
 << "Command ]PSTAT is not available, since performance counters were not\n"
@@ -1135,6 +1143,7 @@ Command::cmd_MORE(ostream & out)
 void 
 Command::cmd_OFF(int exit_val)
 {
+   Workspace::poll_async_save(COUT, true);
    cleanup(true);
    COUT << endl;
    if (!uprefs.silent)   COUT << "Goodbye." << endl;
@@ -57,7 +57,7 @@ enum ExpandHint
    EH_LOG_NUM,        ///< log facility number
    EH_SYMBOLS,        ///< symbol names...
    EH_oCLEAR,         ///< optional CLEAR
-   EH_oCLEAR_SAVE,    ///< optional CLEAR or SAVE
+   EH_oCLEAR_SAVE,    ///< optional CLEAR, SAVE, or CALIBRATE
    EH_HOSTCMD,        ///< host command
    EH_UCOMMAND,       ///< user-defined command
    EH_COUNT,          ///< count
@@ -220,7 +220,10 @@ ostream &
 print_flags(ostream & out, ValueFlags flags)
 {
    return out << ((flags & VF_marked)   ?  "M" : "-")
-              << ((flags & VF_complete) ?  "C" : "-");
+              << ((flags & VF_complete) ?  "C" : "-")
+              << ((flags & VF_lazy)     ?  "L" : "-")
+              << ((flags & VF_fused)    ?  "F" : "-")
+              << ((flags & VF_leaf)     ?  "A" : "-");
 }
 //-----------------------------------------------------------------------------
 int
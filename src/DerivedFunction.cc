@@ -193,6 +193,18 @@ DerivedFunction::eval_AXB(Value_P A, Value_P X, Value_P B)
       }
 }
 //-----------------------------------------------------------------------------
+bool
+DerivedFunction::is_scalar_reduction() const
+{
+   if (!!axis)                              return false;
+   if (right_fun.get_tag() != TOK_VOID)     return false;
+   if (!left_fun.is_function())             return false;
+   if (!left_fun.get_function()->get_scalar_f2())   return false;
+
+const TokenTag tag = oper->get_token().get_tag();
+   return tag == TOK_OPER1_REDUCE || tag == TOK_OPER1_REDUCE1;
+}
+//-----------------------------------------------------------------------------
 ostream &
 DerivedFunction::print(ostream & out) const
 {
@@ -237,12 +249,14 @@ UCS_string ind(indent, UNI_ASCII_SPACE);
 }
 //=============================================================================
 DerivedFunctionCache::DerivedFunctionCache()
-   : idx(0)
+   : idx(0),
+     constructed(0)
 {
    Log(LOG_FunOperX)
       {
-         CERR << "DerivedFunctionCache created, cache at " << (const void *)cache
-              << "..." << (const void *)(cache + MAX_FUN_OPER) << endl;
+         CERR << "DerivedFunctionCache created, cache at "
+              << (const void *)cache() << "..."
+              << (const void *)(cache() + MAX_FUN_OPER) << endl;
       }
 }
 //-----------------------------------------------------------------------------
@@ -250,9 +264,12 @@ DerivedFunctionCache::~DerivedFunctionCache()
 {
    Log(LOG_FunOperX)
       {
-         CERR << "DerivedFunctionCache deleted, cache at " << (const void *)cache
-              << "..." << (const void *)(cache + MAX_FUN_OPER) << endl;
+         CERR << "DerivedFunctionCache deleted, cache at "
+              << (const void *)cache() << "..."
+              << (const void *)(cache() + MAX_FUN_OPER) << endl;
       }
+
+   loop(c, constructed)   cache()[c].~DerivedFunction();
 }
 //-----------------------------------------------------------------------------
 void
@@ -262,8 +279,9 @@ DerivedFunctionCache::reset()
 
    Log(LOG_FunOperX)
       {
-         CERR << "DerivedFunctionCache reset, cache at " << (const void *)cache
-              << "..." << (const void *)(cache + MAX_FUN_OPER) << endl;
+         CERR << "DerivedFunctionCache reset, cache at "
+              << (const void *)cache() << "..."
+              << (const void *)(cache() + MAX_FUN_OPER) << endl;
       }
 }
 //-----------------------------------------------------------------------------
@@ -275,12 +293,17 @@ DerivedFunctionCache::get(const char * loc)
    Log(LOG_FunOperX)
       {
          CERR << "DerivedFunctionCache get( " << idx << " ), cache at "
-              << (const void *)cache << "..."
-              << (const void *)(cache + MAX_FUN_OPER)
+              << (const void *)cache() << "..."
+              << (const void *)(cache() + MAX_FUN_OPER)
               << " at " << loc << endl;
       }
 
-   return cache + idx++;
+   // the caller constructs the returned object again, but it needs to be
+   // valid (for the destructor) in case that fails.
+   //
+   if (idx == constructed)   new (cache() + constructed++) DerivedFunction();
+
+   return cache() + idx++;
 }
 //=============================================================================
 
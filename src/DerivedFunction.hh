@@ -63,6 +63,10 @@ public:
      { if (left_fun.get_tag() == TOK_VOID)   return oper->has_result();
        return left_fun.is_function() && left_fun.get_function()->has_result(); }
 
+   /// return true if \b this is a reduction (without axis) with a scalar
+   /// function, like +/ or ⌈⌿
+   bool is_scalar_reduction() const;
+
 protected:
    /// Overloaded Function::print_properties()
    virtual void print_properties(ostream & out, int indent) const;
@@ -79,6 +83,10 @@ protected:
    /// overloaded Function::eval_AXB()
    virtual Token eval_AXB(Value_P A, Value_P X, Value_P B);
 
+   /// overloaded Function::accepts_lazy()
+   virtual bool accepts_lazy() const
+      { return oper->accepts_lazy(); }
+
    virtual bool may_push_SI() const
       { return   oper->may_push_SI()
         || (left_fun .is_function() && left_fun .get_function()->may_push_SI())
@@ -119,11 +127,20 @@ public:
    DerivedFunction * get(const char * loc);
 
 protected:
-   /// a cache for derived functions
-   DerivedFunction cache[MAX_FUN_OPER];
+   /// the DerivedFunction objects in \b cache_mem. Only the first \b
+   /// constructed objects have been constructed, since most statements use
+   /// none or only a few of them.
+   DerivedFunction * cache()
+      { return reinterpret_cast<DerivedFunction *>(cache_mem); }
 
-   /// the number of elements in \b cache
+   /// the space for the derived functions
+   uint64_t cache_mem[(MAX_FUN_OPER*sizeof(DerivedFunction) + 7) / 8];
+
+   /// the number of elements used in \b cache
    int idx;
+
+   /// the number of elements constructed in \b cache
+   int constructed;
 };
 //-----------------------------------------------------------------------------
 #endif // __FUNOPER_HH__DEFINED__
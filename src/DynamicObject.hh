@@ -24,6 +24,7 @@
 #include "Common.hh"
 #include "Id.hh"
 #include "Output.hh"
+#include "Parallel.hh"
 #include "PrintOperator.hh"
 
 /*
@@ -43,11 +44,10 @@ public:
    {
      Log(LOG_delete)   print_new(CERR, loc);
 
-     next = anchor->next;
-     anchor->next = this;
-
-     prev = anchor;
-     next->prev = this;
+     VALUE_LOCK(next = anchor->next;
+                anchor->next = this;
+                prev = anchor;
+                next->prev = this)
    }
 
    /// a special constructor for statically allocated objects.
@@ -74,11 +74,10 @@ public:
       {
         // print(CERR);
 
-        prev->next = next;
-        next->prev = prev;
-
-        prev = this;
-        next = this;
+        VALUE_LOCK(prev->next = next;
+                   next->prev = prev;
+                   prev = this;
+                   next = this)
       }
 
    /// print this object
@@ -107,7 +107,15 @@ Error::init(ErrorCode ec, const char * loc)
 {
    error_code = ec;
    throw_loc = loc;
-   error_message_1 = error_name(error_code);
+   if (ec == E_NO_ERROR)   // every new SI, no need to convert the name again
+      {
+        static const UCS_string no_error = error_name(E_NO_ERROR);
+        error_message_1 = no_error;
+      }
+   else
+      {
+        error_message_1 = error_name(error_code);
+      }
    if (Workspace::more_error().size())   error_message_1.append(UNI_ASCII_PLUS);
    error_message_2.clear();
    symbol_name.clear();
@@ -162,6 +170,11 @@ throw_apl_error(ErrorCode code, const char * loc)
 
 StateIndicator * si = Workspace::SI_top();
 
+   // worker threads (evaluating items of ¨ or ∘.) leave the SI to the master
+   //
+   if (Parallel::concurrent_values && !Thread_context::is_master_thread())
+      si = 0;
+
    Log(LOG_error_throw)
       {
         CERR << endl
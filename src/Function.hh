@@ -87,6 +87,25 @@ public:
    /// functions, and operators derived from user defined functions
    virtual bool may_push_SI() const   { return false; }
 
+   /// return \b true if the eval_XXX() functions of \b this function accept
+   /// lazy values (i.e. values whose ravel is not yet computed, see
+   /// Value::is_lazy()) and compute them when needed
+   virtual bool accepts_lazy() const   { return false; }
+
+   /// return \b true if the eval_XXX() functions of \b this function accept
+   /// fused values (see Value::is_fused()) and compute them when needed
+   virtual bool accepts_fused() const   { return false; }
+
+   /// return the fused value A fun B (see ScalarFusion), or 0 if A fun B
+   /// shall be computed by eval_AB()
+   virtual Value_P fuse_AB(Value_P A, Value_P B)
+      { return Value_P(); }
+
+   /// return the fused value fun B (see ScalarFusion), or 0 if fun B shall
+   /// be computed by eval_B()
+   virtual Value_P fuse_B(Value_P B)
+      { return Value_P(); }
+
    /// return the number of value arguments (0, 1, or 2) of a user defined
    /// function, For non-user defined functions, throw DOMAIN_ERROR.
    virtual int get_fun_valence() const
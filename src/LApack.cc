@@ -24,6 +24,7 @@
 #include "ComplexCell.hh"
 #include "FloatCell.hh"
 #include "Output.hh"
+#include "Parallel.hh"
 #include "Value.icc"
 #include "Workspace.hh"
 
@@ -32,97 +33,120 @@ using namespace std;
 // the implementation of gelsy<T>
 #include "LApack.hh"
 
+//-----------------------------------------------------------------------------
+/// the job being computed by PF_columns()
+static Column_function column_function = 0;
+
+/// the data of column_function
+static void * column_context = 0;
+
+/// the minimal number of operations for computing a job in parallel
+enum { PARALLEL_COLUMNS_WORK = 100000 };
+
+#if PARALLEL_ENABLED
+/// compute column_function in parallel
+static void
+PF_columns(Thread_context & tctx)
+{
+ShapeItem from, to;
+   while (tctx.PF_next_range(from, to))   (*column_function)(column_context,
+                                                              from, to);
+}
+#endif // PARALLEL_ENABLED
 //-----------------------------------------------------------------------------
 void
-divide_matrix(Cell * cZ, bool need_complex,
-              ShapeItem rows, ShapeItem cols_A, const Cell * cA,
-              ShapeItem cols_B, const Cell * cB, ShapeItem nB2)
+parallel_columns(Column_function fun, void * ctx, ShapeItem cols,
+                 ShapeItem work_per_column)
 {
+#if PARALLEL_ENABLED
+   if (  Parallel::run_parallel
+      && Thread_context::get_active_core_count() > 1
+      && cols > 1
+      && cols * work_per_column > PARALLEL_COLUMNS_WORK)
+      {
+        column_function = fun;
+        column_context = ctx;
+        Thread_context::M_distribute(cols,
+                                     Thread_context::get_active_core_count());
+        Thread_context::do_work = PF_columns;
+        Thread_context::M_fork("LApack");   // start pool
+        PF_columns(Thread_context::get_master());
+        Thread_context::M_join();
+        return;
+      }
+#endif // PARALLEL_ENABLED
+
+   (*fun)(ctx, 0, cols);
+}
+//-----------------------------------------------------------------------------
+/// compute cZ = cA ⌹ cB (or ⌹ cB if cA is 0) with items of type T
+template<typename T>
+static void
+divide_matrix_T(Cell * cZ, ShapeItem rows, ShapeItem cols_A, const Cell * cA,
+                ShapeItem cols_B, const Cell * cB)
+{
+   if (cols_A == 0 || cols_B == 0)   return;   // empty result
+
+   // B (the coefficients) and A (the right hand sides) are stored column
+   // by column, as LApack expects. B is factorized only once for all
+   // columns of A.
+   //
+DynArray(double, b1, 2*rows*cols_B);   // double instead of T for OSX
+T * const b = (T *)b1.get_data();
+   loop(cc, cols_B)
+   loop(rr, rows)
+      {
+        const Cell & cell = cB[rr*cols_B + cc];
+        Sri<T>(b[rr + cc*rows], cell.get_real_value(), cell.get_imag_value());
+      }
+
+DynArray(double, a1, 2*rows*cols_A);   // double instead of T for OSX
+T * const a = (T *)a1.get_data();
+   if (cA)
+      {
+        loop(cc, cols_A)
+        loop(rr, rows)
+           {
+             const Cell & cell = cA[rr*cols_A + cc];
+             Sri<T>(a[rr + cc*rows], cell.get_real_value(),
+                                     cell.get_imag_value());
+           }
+      }
+   else   // ⌹ B: A is the identity matrix
+      {
+        loop(cc, cols_A)
+        loop(rr, rows)   Sri<T>(a[rr + cc*rows], rr == cc ? 1.0 : 0.0);
+      }
+
+   {
+     const APL_Float rcond = Workspace::get_CT();
+
+     Matrix<T> B(b, rows, cols_B, /* LDB */ rows);
+     Matrix<T> A(a, rows, cols_A, /* LDA */ rows);
+     const ShapeItem rk = gelsy<T>(B, A, rcond);
+     if (rk != cols_B)   DOMAIN_ERROR;
+   }
+
+   // cols_A = rows_Z. We have computed the result for col c of A
+   // which is row c of Z.
+   //
+   loop(r, cols_B)
    loop(c, cols_A)
        {
-         if (need_complex)
-            {
-              double * ad = new double[2*rows];
-              Assert(ad);
-              ZZ * const a = (ZZ *)ad;
-              loop(r, rows)
-                  {
-                    new (a + r) ZZ(cA[r*cols_A + c].get_real_value(),
-                                   cA[r*cols_A + c].get_imag_value());
-                  }
-
-              double * bd = new double[2*nB2*nB2];
-              Assert(bd);
-              ZZ * const b = (ZZ *)bd;
-              ZZ * bb = b;
-              loop(rr, cols_B)
-              loop(cc, rows)
-                 {
-                   new (bb++) ZZ(cB[rr + cc*cols_B].get_real_value(),
-                                 cB[rr + cc*cols_B].get_imag_value());
-                 }
-
-              {
-                const APL_Float rcond = Workspace::get_CT();
-
-                Matrix<ZZ> B(b, rows, cols_B, /* LDB */ rows);
-                Matrix<ZZ> A(a, rows, 1,      /* LDA */ rows);
-                const ShapeItem rk = gelsy<ZZ>(B, A, rcond);
-                delete [] bd;
-                if (rk != cols_B)
-                   {
-                     delete [] ad;
-                     DOMAIN_ERROR;
-                   }
-              }
-
-              // cols_A = rows_Z. We have computed the result for col c of A
-              // which is row c of Z.
-              //
-              loop(r, cols_B)
-                  new (cZ + r*cols_A + c) ComplexCell(a[r].real(), a[r].imag());
-              delete [] ad;
-            }
-         else   // real
-            {
-              double * a = new double[nB2*nB2];
-              Assert(a);
-              loop(r, rows)
-                 {
-                   a[r] = cA[r*cols_A + c].get_real_value();
-                 }
-
-              double * b = new double[nB2*nB2];
-              Assert(b);
-              double * bb = b;
-              loop(rr, cols_B)
-              loop(cc, rows)
-                 {
-                   *bb++ = cB[rr + cc*cols_B].get_real_value();
-                 }
-
-              {
-                const APL_Float rcond = Workspace::get_CT();
-
-                Matrix<DD> B(b, rows, cols_B, /* LDB */ rows);
-                Matrix<DD> A(a, rows, 1,      /* LDA */ rows);
-                const ShapeItem rk = gelsy<DD>(B, A, rcond);
-                delete [] b;
-                if (rk != cols_B)
-                   {
-                     delete [] a;
-                     DOMAIN_ERROR;
-                   }
-              }
-
-              // cols_A = rows_Z. We have computed the result for col c of A
-              // which is row c of Z.
-              //
-
-              loop(r, cols_B)
-                  new (cZ + r*cols_A + c)   FloatCell(a[r]);
-              delete [] a;
-            }
+         const T & z = a[r + c*rows];
+         if (DZ::is_ZZ(z))   new (cZ++) ComplexCell(REAL(z), IMAG(z));
+         else                new (cZ++) FloatCell(REAL(z));
        }
 }
 //-----------------------------------------------------------------------------
+void
+divide_matrix(Cell * cZ, bool need_complex,
+              ShapeItem rows, ShapeItem cols_A, const Cell * cA,
+              ShapeItem cols_B, const Cell * cB)
+{
+   if (need_complex)
+      divide_matrix_T<ZZ>(cZ, rows, cols_A, cA, cols_B, cB);
+   else
+      divide_matrix_T<DD>(cZ, rows, cols_A, cA, cols_B, cB);
+}
+//-----------------------------------------------------------------------------
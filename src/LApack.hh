@@ -640,6 +640,61 @@ const T factor = DZ::inv(ALPHA - beta);
    return tau;
 }
 //-----------------------------------------------------------------------------
+/// a function computing the columns [\b from, \b to) of a job (with
+/// job-specific data \b ctx)
+typedef void (*Column_function)(void * ctx, ShapeItem from, ShapeItem to);
+
+/// call \b fun for the columns [0, \b cols) of a job, in parallel if the
+/// job (of \b cols × \b work_per_column operations) is large enough
+extern void parallel_columns(Column_function fun, void * ctx,
+                             ShapeItem cols, ShapeItem work_per_column);
+//-----------------------------------------------------------------------------
+/// B(0:M, col) = A(0:M, 0:M)⁻¹ × B(0:M, col) for upper triangular A
+template<typename T>
+struct Triangular_solve
+{
+   /// the upper triangular matrix
+   const Matrix<T> * A;
+
+   /// the right hand sides (and results)
+   Matrix<T> * B;
+
+   /// the number of rows and columns of A
+   ShapeItem M;
+
+   /// the number of columns of B solved at a time (so that they remain
+   /// cached while A is read once)
+   enum { COLUMN_TILE = 16 };
+
+   /// solve the columns from ... to-1 of B
+   static void compute(void * ctx, ShapeItem from, ShapeItem to)
+      {
+        const Triangular_solve & job = *(const Triangular_solve *)ctx;
+        const Matrix<T> & A = *job.A;
+        Matrix<T> & B = *job.B;
+
+        for (ShapeItem c0 = from; c0 < to; c0 += COLUMN_TILE)
+            {
+              const ShapeItem c_end = MIN(to, c0 + COLUMN_TILE);
+              for (ShapeItem k_0 = job.M - 1; k_0 >= 0; --k_0)
+                  {
+                    const T * a_k = &A.at(0, k_0);
+                    for (ShapeItem j_0 = c0; j_0 < c_end; ++j_0)
+                        {
+                          T * b_j = &B.at(0, j_0);
+                          T & B_kj = b_j[k_0];
+                          if (B_kj != 0.0)
+                             {
+                               B_kj = B_kj / A.diag(k_0);
+                               loop(i_0, k_0)
+                                   b_j[i_0] = b_j[i_0] - B_kj * a_k[i_0];
+                             }
+                        }
+                  }
+            }
+      }
+};
+//-----------------------------------------------------------------------------
 /// LApack function trsm
 template<typename T>
 void trsm(int M, int N, const Matrix<T> & A, Matrix<T> & B)
@@ -650,19 +705,10 @@ void trsm(int M, int N, const Matrix<T> & A, Matrix<T> & B)
    //       DIAG   = 'Non-unit' and      - nounit = true
    //       ALPHA  = 1.0 is implemented!
    //
-   loop(j_0, N)
-       {
-         for (ShapeItem k_0 = M - 1; k_0 >= 0; --k_0)
-             {
-               T & B_kj = B.at(k_0, j_0);
-               if (B_kj != 0.0)
-                  {
-                    B_kj = B_kj / A.diag(k_0);
-                    loop(i_0, k_0)
-                        B.at(i_0, j_0) = B.at(i_0, j_0) - B_kj * A.at(i_0, k_0);
-                  }
-             }
-       }
+   // The columns of B are independent and are solved in parallel.
+   //
+Triangular_solve<T> job = { &A, &B, M };
+   parallel_columns(&Triangular_solve<T>::compute, &job, N, ShapeItem(M)*M/2);
 }
 //-----------------------------------------------------------------------------
 /// LApack function ila_lc
@@ -754,18 +800,20 @@ ShapeItem  lastc = 0;
       }
 }
 //-----------------------------------------------------------------------------
-/// LApack function laqp2
+/// LApack function laqp2. The rows 0 ... \b offset-1 of \b A were
+/// factorized already (by laqps()) and are only swapped when columns are.
 template<typename T>
-void laqp2(Matrix<T> & A, ShapeItem * pivot, T * tau, double * vn1)
+void laqp2(Matrix<T> & A, ShapeItem offset, ShapeItem * pivot, T * tau,
+           double * vn1, double * vn2)
 {
 const ShapeItem M = A.get_row_count();
 const ShapeItem N = A.get_column_count();
+const ShapeItem MN = MIN(M - offset, N);
 
-double * vn2 = vn1 + N;
-
-   loop(i_0, N)
+   loop(i_0, MN)
       {
         T & tau_i = tau[i_0];
+        const ShapeItem offpi = offset + i_0;
 
         // Determine the i'th pivot column and swap if necessary.
         //
@@ -782,11 +830,11 @@ double * vn2 = vn1 + N;
         // Generate elementary reflector H(i).
         //
         {
-          if (i_0 < (M - 1))
+          if (offpi < (M - 1))
              {
-               Vector<T> x(&A.at(i_0 + 1, i_0), M - i_0 - 1);
+               Vector<T> x(&A.at(offpi + 1, i_0), M - offpi - 1);
                T & alpha = *(&x.at(0) - 1);   // one before x
-               tau_i = larfg<T>(M - i_0, alpha, x);
+               tau_i = larfg<T>(M - offpi, alpha, x);
              }
           else
              {
@@ -800,12 +848,12 @@ double * vn2 = vn1 + N;
            {
              // Apply H(i)**H to A(offset+i:m,i+1:n) from the left.
              //
-             const T Aii = A.diag(i_0);   // save diag
-             A.diag(i_0) = 1.0;
-                Vector<T> v(&A.diag(i_0), M - i_0);
-                Matrix<T> c = A.sub_yx(i_0, i_0 + 1);
+             const T Aii = A.at(offpi, i_0);   // save diag
+             A.at(offpi, i_0) = 1.0;
+                Vector<T> v(&A.at(offpi, i_0), M - offpi);
+                Matrix<T> c = A.sub_yx(offpi, i_0 + 1);
                 larf<T>(v, DZ::CONJ(tau_i), c);
-             A.diag(i_0) = Aii;           // restore diag
+             A.at(offpi, i_0) = Aii;           // restore diag
            }
 
         // Update partial column norms.
@@ -814,7 +862,7 @@ double * vn2 = vn1 + N;
             {
               if (vn1[j_0] != 0)
                  {
-                   double temp = ABS(A.at(i_0, j_0)) / vn1[j_0];
+                   double temp = ABS(A.at(offpi, j_0)) / vn1[j_0];
                    temp = 1.0 - temp*temp;
                    temp = MAX(temp, 0.0);
 
@@ -822,9 +870,10 @@ double * vn2 = vn1 + N;
                    temp2 = temp * temp2 * temp2;
                    if (temp2 <= tol3z)
                       {
-                        if (i_0 < (M - 1))
+                        if (offpi < (M - 1))
                            {
-                             Vector<T> x(&A.at(i_0 + 1, j_0), M - i_0 - 1);
+                             Vector<T> x(&A.at(offpi + 1, j_0),
+                                         M - offpi - 1);
                              vn1[j_0] = x.norm();
                              vn2[j_0] = vn1[j_0];
                            }
@@ -843,6 +892,253 @@ double * vn2 = vn1 + N;
       }
 }
 //-----------------------------------------------------------------------------
+/// A(row:M, col:N) -= A(row:M, 0:K) × F(col:N, 0:K)**H, the update of
+/// the trailing matrix after a panel of K columns (see laqps())
+template<typename T>
+struct Trailing_update
+{
+   /// the matrix being updated
+   Matrix<T> * A;
+
+   /// the auxiliary matrix F of laqps()
+   const Matrix<T> * F;
+
+   /// the first row of A being updated
+   ShapeItem row;
+
+   /// the number of columns in the panel
+   ShapeItem K;
+
+   /// the first column of A being updated
+   ShapeItem col;
+
+   /// the number of rows updated at a time (so that they remain cached
+   /// while all columns are updated)
+   enum { ROW_TILE = 256 };
+
+   /// update the columns col+from ... col+to-1 of A
+   static void compute(void * ctx, ShapeItem from, ShapeItem to)
+      {
+        const Trailing_update & job = *(const Trailing_update *)ctx;
+        Matrix<T> & A = *job.A;
+        const ShapeItem M = A.get_row_count();
+
+        for (ShapeItem r0 = job.row; r0 < M; r0 += ROW_TILE)
+            {
+              const ShapeItem rows = MIN(ShapeItem(ROW_TILE), M - r0);
+              for (ShapeItem c = job.col + from; c < job.col + to; ++c)
+                  {
+                    T * a_c = &A.at(r0, c);
+                    loop(l, job.K)
+                        {
+                          const T f = DZ::CONJ(job.F->at(c, l));
+                          if (f == 0.0)   continue;
+                          const T * a_l = &A.at(r0, l);
+                          loop(r, rows)   a_c[r] = a_c[r] - a_l[r] * f;
+                        }
+                  }
+            }
+      }
+};
+//-----------------------------------------------------------------------------
+/// F(col:N, k) = tau × A(row:M, col:N)**H × A(row:M, k), the k'th column
+/// of the auxiliary matrix F of laqps()
+template<typename T>
+struct Panel_column
+{
+   /// the matrix being factorized
+   const Matrix<T> * A;
+
+   /// the auxiliary matrix F of laqps()
+   Matrix<T> * F;
+
+   /// the Householder factor
+   T tau;
+
+   /// the first row of the Householder vector
+   ShapeItem row;
+
+   /// the column of the Householder vector (and of F)
+   ShapeItem k;
+
+   /// the first column of A (and row of F)
+   ShapeItem col;
+
+   /// compute F(col+from ... col+to-1, k)
+   static void compute(void * ctx, ShapeItem from, ShapeItem to)
+      {
+        const Panel_column & job = *(const Panel_column *)ctx;
+        const Matrix<T> & A = *job.A;
+        const ShapeItem len = A.get_row_count() - job.row;
+        const T * v = &A.at(job.row, job.k);
+
+        for (ShapeItem c = job.col + from; c < job.col + to; ++c)
+            {
+              const T * a_c = &A.at(job.row, c);
+              T sum = 0.0;
+              loop(r, len)   sum = sum + DZ::CONJ(a_c[r]) * v[r];
+              job.F->at(c, job.k) = job.tau * sum;
+            }
+      }
+};
+//-----------------------------------------------------------------------------
+/// LApack function laqps: factorize (at most) \b NB columns of \b A (below
+/// row \b offset) and update the remaining columns in one go. Return the
+/// number of columns factorized.
+template<typename T>
+ShapeItem laqps(Matrix<T> & A, ShapeItem offset, ShapeItem NB,
+                ShapeItem * pivot, T * tau, double * vn1, double * vn2,
+                T * auxv, Matrix<T> & F)
+{
+const ShapeItem M = A.get_row_count();
+const ShapeItem N = A.get_column_count();
+const ShapeItem lastrk = MIN(M, N + offset);
+
+ShapeItem lsticc = -1;   // columns whose norms must be recomputed
+ShapeItem k = 0;
+
+   while (k < NB && lsticc == -1)
+      {
+        const ShapeItem rk = offset + k;
+
+        // Determine the k'th pivot column and swap if necessary.
+        //
+        const ShapeItem pvt = k + max_pos(vn1 + k, N - k);
+        if (pvt != k)
+           {
+             A.exchange_columns(pvt, k);
+             loop(j, k)   exchange(F.at(pvt, j), F.at(k, j));
+             exchange(pivot[pvt], pivot[k]);
+             vn1[pvt] = vn1[k];
+             vn2[pvt] = vn2[k];
+           }
+
+        // Apply the previous Householder reflectors to column k:
+        // A(rk:M, k) -= A(rk:M, 0:k) × F(k, 0:k)**H
+        //
+        loop(j, k)
+           {
+             const T f = DZ::CONJ(F.at(k, j));
+             T * a_k = &A.at(rk, k);
+             const T * a_j = &A.at(rk, j);
+             loop(r, M - rk)   a_k[r] = a_k[r] - a_j[r] * f;
+           }
+
+        // Generate elementary reflector H(k).
+        //
+        if (rk < (M - 1))
+           {
+             Vector<T> x(&A.at(rk + 1, k), M - rk - 1);
+             tau[k] = larfg<T>(M - rk, A.at(rk, k), x);
+           }
+        else
+           {
+             Vector<T> x(&A.at(rk, k), 1);
+             tau[k] = larfg<T>(1, A.at(rk, k), x);
+           }
+
+        const T Akk = A.at(rk, k);
+        A.at(rk, k) = 1.0;
+
+        // Compute the k'th column of F:
+        // F(k+1:N, k) = tau(k) × A(rk:M, k+1:N)**H × A(rk:M, k)
+        //
+        if (k < (N - 1))
+           {
+             Panel_column<T> job = { &A, &F, tau[k], rk, k, k + 1 };
+             parallel_columns(&Panel_column<T>::compute, &job,
+                              N - k - 1, M - rk);
+           }
+
+        loop(j, k + 1)   F.at(j, k) = 0.0;
+
+        // Incremental updating of F:
+        // F(0:N, k) -= tau(k) × F(0:N, 0:k) × A(rk:M, 0:k)**H × A(rk:M, k)
+        //
+        if (k > 0)
+           {
+             const T * v = &A.at(rk, k);
+             loop(j, k)
+                {
+                  const T * a_j = &A.at(rk, j);
+                  T sum = 0.0;
+                  loop(r, M - rk)   sum = sum + DZ::CONJ(a_j[r]) * v[r];
+                  auxv[j] = -tau[k] * sum;
+                }
+
+             loop(c, N)
+                {
+                  T sum = F.at(c, k);
+                  loop(j, k)   sum = sum + F.at(c, j) * auxv[j];
+                  F.at(c, k) = sum;
+                }
+           }
+
+        // Update the current row of A:
+        // A(rk, k+1:N) -= A(rk, 0:k+1) × F(k+1:N, 0:k+1)**H
+        //
+        for (ShapeItem c = k + 1; c < N; ++c)
+            {
+              T sum = A.at(rk, c);
+              loop(j, k + 1)   sum = sum - A.at(rk, j) * DZ::CONJ(F.at(c, j));
+              A.at(rk, c) = sum;
+            }
+
+        // Update partial column norms.
+        //
+        if (rk < (lastrk - 1))
+           {
+             for (ShapeItem j = k + 1; j < N; ++j)
+                 {
+                   if (vn1[j] == 0.0)   continue;
+
+                   double temp = ABS(A.at(rk, j)) / vn1[j];
+                   temp = MAX(0.0, (1.0 + temp)*(1.0 - temp));
+                   double temp2 = vn1[j] / vn2[j];
+                   temp2 = temp * temp2 * temp2;
+                   if (temp2 <= tol3z)   // recompute after the panel
+                      {
+                        vn2[j] = lsticc;
+                        lsticc = j;
+                      }
+                   else
+                      {
+                        vn1[j] *= sqrt(temp);
+                      }
+                 }
+           }
+
+        A.at(rk, k) = Akk;
+        ++k;
+      }
+
+const ShapeItem KB = k;
+const ShapeItem rk = offset + KB;
+
+   // Apply the block reflector to the rest of the matrix:
+   // A(rk:M, KB:N) -= A(rk:M, 0:KB) × F(KB:N, 0:KB)**H
+   //
+   if (KB < MIN(N, M - offset))
+      {
+        Trailing_update<T> job = { &A, &F, rk, KB, KB };
+        parallel_columns(&Trailing_update<T>::compute, &job,
+                         N - KB, (M - rk) * KB);
+      }
+
+   // Recompute the norms of the columns marked above.
+   //
+   while (lsticc != -1)
+      {
+        const ShapeItem next = ShapeItem(vn2[lsticc]);
+        Vector<T> x(&A.at(rk, lsticc), M - rk);
+        vn1[lsticc] = x.norm();
+        vn2[lsticc] = vn1[lsticc];
+        lsticc = next;
+      }
+
+   return KB;
+}
+//-----------------------------------------------------------------------------
 /// LApack function laic1 (maximum case)
 template<typename T>
 void laic1_max(double SEST, T alpha, T GAMMA, double &SESTPR, T &S, T &C)
@@ -1088,33 +1384,78 @@ const double tmp = sqrt(ABS_2(sine) + ABS_2(cosine));
    C = cosine / tmp;
 }
 //-----------------------------------------------------------------------------
-/// LApack function unm2r
+/// C = H(K-1)**H × ... × H(0)**H × C, where the elementary reflectors H(i)
+/// are stored below the diagonal of A (and in tau) by geqp3()
 template<typename T>
-void unm2r(ShapeItem K, Matrix<T> & A, const T * tau, Matrix<T> & c)
+struct Apply_reflectors
 {
-const ShapeItem M = c.get_row_count();
+   /// the reflectors
+   const Matrix<T> * A;
+
+   /// the factors of the reflectors
+   const T * tau;
+
+   /// the number of reflectors
+   ShapeItem K;
 
+   /// the matrix being multiplied
+   Matrix<T> * C;
+
+   /// the number of reflectors applied at a time (so that they remain
+   /// cached while all columns of C are computed)
+   enum { REFLECTOR_BLOCK = 32 };
+
+   /// compute the columns from ... to-1 of C
+   static void compute(void * ctx, ShapeItem from, ShapeItem to)
+      {
+        const Apply_reflectors & job = *(const Apply_reflectors *)ctx;
+        const Matrix<T> & A = *job.A;
+        Matrix<T> & C = *job.C;
+        const ShapeItem M = C.get_row_count();
+
+        for (ShapeItem i0 = 0; i0 < job.K; i0 += REFLECTOR_BLOCK)
+            {
+              const ShapeItem i_end = MIN(job.K, i0 + REFLECTOR_BLOCK);
+              for (ShapeItem c = from; c < to; ++c)
+                  {
+                    T * c_c = &C.at(0, c);
+                    for (ShapeItem i_0 = i0; i_0 < i_end; ++i_0)
+                        {
+                          const T taui = DZ::CONJ(job.tau[i_0]);
+                          if (taui == 0.0)   continue;
+
+                          // v = A(i:M, i) with v[0] = 1 (implicitly, so
+                          // that A is not modified by concurrent jobs).
+                          // This is larf() for a single column.
+                          //
+                          const T * v = &A.at(i_0, i_0);
+                          T y = DZ::CONJ(c_c[i_0]);
+                          for (ShapeItem r = i_0 + 1; r < M; ++r)
+                              y = y + DZ::CONJ(c_c[r]) * v[r - i_0];
+
+                          const T Y = DZ::CONJ(y) * -taui;
+                          c_c[i_0] = c_c[i_0] + Y;
+                          for (ShapeItem r = i_0 + 1; r < M; ++r)
+                              c_c[r] = c_c[r] + Y * v[r - i_0];
+                        }
+                  }
+            }
+      }
+};
+//-----------------------------------------------------------------------------
+/// LApack function unm2r
+template<typename T>
+void unm2r(ShapeItem K, const Matrix<T> & A, const T * tau, Matrix<T> & c)
+{
    // only SIDE == "Left" is implemented
    // only TRANS = 'T' or 'C' is implemented
    // thus NOTRANS is always false
    //
-   loop(i_0, K)
-       {
-         // H(i) or H(i)**H is applied to C(i:m,1:n)
-         //
-         const int MM = M - i_0;
-
-         // Apply H(i) or H(i)**H
-         //
-         const T taui = DZ::CONJ(tau[i_0]);
-
-         const T Aii = A.diag(i_0);
-         A.diag(i_0) = 1.0;
-            Vector<T> v(&A.diag(i_0), MM);
-            Matrix<T> c1 = c.sub_yx(i_0, 0);
-            larf<T>(v, taui, c1);
-         A.diag(i_0) = Aii;
-       }
+   // The columns of c are independent and are computed in parallel.
+   //
+Apply_reflectors<T> job = { &A, tau, K, &c };
+   parallel_columns(&Apply_reflectors<T>::compute, &job,
+                    c.get_column_count(), K*c.get_row_count());
 }
 //-----------------------------------------------------------------------------
 /// LApack function geqp3
@@ -1124,6 +1465,11 @@ void geqp3(Matrix<T> & A, ShapeItem * pivot, T * tau)
 const ShapeItem M = A.get_row_count();
 const ShapeItem N = A.get_column_count();
 
+   // the number of columns of a panel (see laqps()), and the number of
+   // (final) columns for which the unblocked laqp2() is faster
+   //
+   enum { QR_BLOCK = 32, QR_CROSSOVER = 128 };
+
    // init column permutaion for pivoting
    // so we simply create the identical permutation
    //
@@ -1146,9 +1492,36 @@ const ShapeItem N = A.get_column_count();
            vn12[N + j_0] = vn12[j_0] = x.norm();
          }
 
+     const ShapeItem min_MN = MIN(M, N);
+     ShapeItem j = 0;
+
+     // Use blocked code (panels of QR_BLOCK columns) for large matrices
+     //
+     if (min_MN > QR_BLOCK + QR_CROSSOVER)
+        {
+          DynArray(double, F1, 2*N*QR_BLOCK);   // double instead of T for OSX
+          DynArray(double, auxv1, 2*QR_BLOCK);  // double instead of T for OSX
+
+          while (j < (min_MN - QR_CROSSOVER))
+             {
+               const ShapeItem jb = MIN(ShapeItem(QR_BLOCK),
+                                        min_MN - QR_CROSSOVER - j);
+               Matrix<T> Aj(&A.at(0, j), M, N - j, A.get_dx());
+               Matrix<T> F((T *)F1.get_data(), N - j, jb, N - j);
+               j += laqps<T>(Aj, j, jb, pivot + j, tau + j,
+                             vn12.get_data() + j, vn12.get_data() + N + j,
+                             (T *)auxv1.get_data(), F);
+             }
+        }
+
      // Use unblocked code to factor the last or only block
      //
-     laqp2<T>(A, pivot, tau, vn12.get_data());
+     if (j < min_MN)
+        {
+          Matrix<T> Aj(&A.at(0, j), M, N - j, A.get_dx());
+          laqp2<T>(Aj, j, pivot + j, tau + j,
+                   vn12.get_data() + j, vn12.get_data() + N + j);
+        }
    }
 }
 //-----------------------------------------------------------------------------
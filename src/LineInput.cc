@@ -726,10 +726,6 @@ InputMux::get_line(LineInputMode mode, const UCS_string & prompt,
 const APL_time_us from = now();
    if (start_input)   (*start_input)();
 
-#if PARALLEL_ENABLED
-   Parallel::lock_pool(false);
-#endif
-
    for (int control_D_count = 0;;)
        {
          bool _eof = false;
@@ -777,10 +773,6 @@ const APL_time_us from = now();
               return;  // not reached
             }
       }
-#if PARALLEL_ENABLED
-   Parallel::unlock_pool(false);
-#endif
-
    Log(LOG_get_line)   CERR << " '" << line << "'" << endl;
 
    Workspace::add_wait(now() - from);
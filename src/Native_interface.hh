@@ -18,6 +18,9 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#ifndef __NATIVE_INTERFACE_HH_DEFINED__
+#define __NATIVE_INTERFACE_HH_DEFINED__
+
 // this file #includes those header files that are of interest for
 // native functions
 
@@ -55,3 +58,203 @@
    // access to system variables (⎕IO and friends)
 #include "Workspace.hh"
 
+   // the thread pool of the interpreter
+#include "Parallel.hh"
+
+/*
+   Helpers for native functions that process large simple values.
+
+   Walking a ravel with get_ravel(i).get_int_value() and building a result
+   with placement-new costs (at least) one virtual function call per item.
+   The helpers below pack a simple ravel into a C array once (Native_span),
+   create a result from a C array (native_value()), and run a loop over
+   such arrays on the thread pool of the interpreter (native_parallel()).
+   For example:
+
+   Token
+   eval_AB(Value_P A, Value_P B, const NativeFunction * caller)
+   {
+   const Native_span<APL_Float> b(*B);   // DOMAIN ERROR unless B is real
+   vector<APL_Float> z(b.size());
+      ...                                // compute z from b
+      return Token(TOK_APL_VALUE1,
+                   native_value(B->get_shape(), z.data(), LOC));
+   }
+ */
+
+//-----------------------------------------------------------------------------
+/// return CT_INT if all items of \b val are integers, CT_FLOAT if all items
+/// are real (and not all integers), CT_CHAR if all items are characters, and
+/// CT_NONE otherwise (mixed, complex, or nested). The prototype of an empty
+/// value is used.
+inline CellType
+native_ravel_type(const Value & val)
+{
+const Cell * C = &val.get_ravel(0);
+const ShapeItem len = val.nz_element_count();
+int types = 0;
+   loop(c, len)   types |= C[c].get_cell_type();
+
+   if (types == CT_INT)                 return CT_INT;
+   if (types == CT_FLOAT)               return CT_FLOAT;
+   if (types == (CT_INT | CT_FLOAT))    return CT_FLOAT;
+   if (types == CT_CHAR)                return CT_CHAR;
+   return CT_NONE;
+}
+//-----------------------------------------------------------------------------
+/// A read-only view of the ravel of a simple value as a contiguous C array
+/// of T (APL_Integer, APL_Float, or Unicode). The ravel is packed once when
+/// the view is constructed; a DOMAIN ERROR is thrown if an item cannot be
+/// represented as T (e.g. a character or non-integral number for
+/// APL_Integer). The view does not change when \b val changes later on.
+template<typename T>
+class Native_span
+{
+public:
+   /// constructor: pack the ravel of \b val
+   Native_span(const Value & val)
+   : items(val.element_count())
+      {
+        const Cell * C = &val.get_ravel(0);
+        loop(i, (ShapeItem)items.size())   get_item(C[i], items[i]);
+      }
+
+   /// the number of items
+   ShapeItem size() const
+      { return items.size(); }
+
+   /// the idx'th item
+   const T & operator[](ShapeItem idx) const
+      { return items[idx]; }
+
+   /// the items (0 if there are none)
+   const T * data() const
+      { return items.size() ? &items[0] : 0; }
+
+   /// the first item
+   const T * begin() const
+      { return data(); }
+
+   /// the end of the items
+   const T * end() const
+      { return data() + items.size(); }
+
+protected:
+   /// an integer item
+   static void get_item(const Cell & cell, APL_Integer & item)
+      { item = cell.is_integer_cell() ? cell.get_int_value()
+                                      : cell.get_near_int(); }
+
+   /// a real item
+   static void get_item(const Cell & cell, APL_Float & item)
+      { if (!cell.is_real_cell())   DOMAIN_ERROR;
+        item = cell.get_real_value(); }
+
+   /// a character item
+   static void get_item(const Cell & cell, Unicode & item)
+      { item = cell.get_char_value(); }
+
+   /// the packed ravel
+   vector<T> items;
+};
+//-----------------------------------------------------------------------------
+/// a new value with shape \b shape and the ×/shape integers in \b data
+inline Value_P
+native_value(const Shape & shape, const APL_Integer * data, const char * loc)
+{
+Value_P Z(shape, loc);
+const ShapeItem len = Z->element_count();
+Cell * C = &Z->get_ravel(0);
+   loop(z, len)   new (C + z) IntCell(data[z]);
+   if (len == 0)   new (C) IntCell(0);   // prototype
+   Z->check_value(loc);
+   return Z;
+}
+//-----------------------------------------------------------------------------
+/// a new value with shape \b shape and the ×/shape reals in \b data
+inline Value_P
+native_value(const Shape & shape, const APL_Float * data, const char * loc)
+{
+Value_P Z(shape, loc);
+const ShapeItem len = Z->element_count();
+Cell * C = &Z->get_ravel(0);
+   loop(z, len)   new (C + z) FloatCell(data[z]);
+   if (len == 0)   new (C) IntCell(0);   // prototype
+   Z->check_value(loc);
+   return Z;
+}
+//-----------------------------------------------------------------------------
+/// a new value with shape \b shape and the ×/shape characters in \b data
+inline Value_P
+native_value(const Shape & shape, const Unicode * data, const char * loc)
+{
+Value_P Z(shape, loc);
+const ShapeItem len = Z->element_count();
+Cell * C = &Z->get_ravel(0);
+   loop(z, len)   new (C + z) CharCell(data[z]);
+   if (len == 0)   new (C) CharCell(UNI_ASCII_SPACE);   // prototype
+   Z->check_value(loc);
+   return Z;
+}
+//-----------------------------------------------------------------------------
+/// a function that processes the items \b from ≤ i < \b to of a job that
+/// was started with native_parallel(). The function is called in different
+/// threads at the same time, therefore it must not create or release APL
+/// values, must not throw APL errors, and must only write to items i of
+/// its results.
+typedef void Native_range_function(ShapeItem from, ShapeItem to, void * ctx);
+
+/// the job of native_parallel()
+struct Native_job
+{
+   /// the function computing the items
+   Native_range_function * fun;
+
+   /// the context for fun
+   void * ctx;
+
+   /// the current job
+   static Native_job & get()
+      { static Native_job job;   return job; }
+
+   /// the pool function that calls fun for the ranges of a thread
+   static void PF_run(Thread_context & tctx)
+      {
+        const Native_job & job = get();
+        ShapeItem from, to;
+        while (tctx.PF_next_range(from, to))   (*job.fun)(from, to, job.ctx);
+      }
+};
+//-----------------------------------------------------------------------------
+/// call \b fun for the items 0 ≤ i < \b len, using all cores of the
+/// interpreter (see ⎕SYL) if \b len exceeds \b threshold, or else in the
+/// calling thread. Must be called in the interpreter thread (i.e. from an
+/// eval_XXX() function).
+inline void
+native_parallel(ShapeItem len, ShapeItem threshold,
+                Native_range_function * fun, void * ctx)
+{
+Native_job & job = Native_job::get();
+   job.fun = fun;
+   job.ctx = ctx;
+
+#if PARALLEL_ENABLED
+   if (  Parallel::run_parallel
+      && Thread_context::get_active_core_count() > 1
+      && len > threshold)
+      {
+        const CoreCount cores = Thread_context::get_active_core_count();
+        Thread_context::M_distribute(len, cores);
+        Thread_context::do_work = &Native_job::PF_run;
+        Thread_context::M_fork("native_parallel");   // start pool
+        Native_job::PF_run(Thread_context::get_master());
+        Thread_context::M_join();
+        return;
+      }
+#endif // PARALLEL_ENABLED
+
+   if (len > 0)   (*fun)(0, len, ctx);
+}
+//-----------------------------------------------------------------------------
+
+#endif // __NATIVE_INTERFACE_HH_DEFINED__
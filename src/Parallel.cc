@@ -18,6 +18,8 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <ctype.h>
+#include <dirent.h>
 #include <sched.h>
 #include <signal.h>
 
@@ -36,6 +38,9 @@ CoreCount Thread_context::active_core_count = CCNT_1;   // the master
 
 Thread_context * Thread_context::thread_contexts = 0;
 CoreCount Thread_context::thread_contexts_count = CCNT_0;
+CoreCount Thread_context::job_cores = CCNT_1;
+ShapeItem Thread_context::job_length = 0;
+ShapeItem Thread_context::chunk_length = 1;
 
 volatile _Atomic_word Parallel_job_list_base::parallel_jobs_lock = 0;
 const char * Parallel_job_list_base::started_loc = 0;
@@ -46,6 +51,9 @@ bool Parallel::run_parallel = false;
 bool Parallel::run_parallel = true;
 #endif
 
+bool Parallel::concurrent_values = false;
+volatile _Atomic_word Parallel::value_lock = 0;
+
 //=============================================================================
 void
 Parallel::init(bool logit)
@@ -93,7 +101,7 @@ Parallel::init(bool logit)
 
    if (logit)   Thread_context::print_all(CERR);
 
-   // the threads above start in state locked. Wake them up...
+   // the threads above start in state blocked. Wake them up...
    //
 #if CORE_COUNT_WANTED == -3
    set_core_count(CCNT_1, logit);
@@ -114,7 +122,11 @@ Thread_context::Thread_context()
      thread(0),
      job_number(0),
      job_name("no-name"),
-     blocked(false)
+     spin_limit(SPIN_INITIAL),
+     blocked(false),
+     chunk_lock(0),
+     chunk_head(0),
+     chunk_tail(0)
 {
 }
 //-----------------------------------------------------------------------------
@@ -126,12 +138,87 @@ Thread_context::init_sequential(bool logit)
    thread_contexts[0].N = CNUM_MASTER;
 }
 
+//-----------------------------------------------------------------------------
+void
+Thread_context::M_distribute(ShapeItem len, CoreCount cores)
+{
+   job_cores = cores;
+   job_length = len;
+
+ShapeItem chunks = (cores == CCNT_1) ? 1 : cores * CHUNKS_PER_CORE;
+   chunk_length = (len + chunks - 1) / chunks;
+   if (cores != CCNT_1 && chunk_length < MIN_CHUNK_LENGTH)
+      chunk_length = MIN_CHUNK_LENGTH;
+   if (chunk_length < 1)   chunk_length = 1;
+   chunks = (len + chunk_length - 1) / chunk_length;
+
+   // give every core a contiguous part of the chunks. This keeps the
+   // items computed by a core together (as long as nothing is stolen).
+   //
+   loop(c, cores)
+       {
+         Thread_context & tctx = thread_contexts[c];
+         tctx.chunk_head = (chunks * c) / cores;
+         tctx.chunk_tail = (chunks * (c + 1)) / cores;
+       }
+}
+//-----------------------------------------------------------------------------
+bool
+Thread_context::PF_next_range(ShapeItem & from, ShapeItem & to)
+{
+ShapeItem chunk = -1;
+
+   // take the next chunk from the front of our own deque
+   //
+   POOL_LOCK(chunk_lock,
+      if (chunk_head < chunk_tail)   chunk = chunk_head++)
+
+   // if our own deque is empty then steal the second half of the chunks
+   // left in the deque of another core. We take the victim's lock and our
+   // own lock one after the other (never both) to avoid dead-locks.
+   //
+   for (int v = 1; chunk == -1 && v < job_cores; ++v)
+       {
+         Thread_context & victim = thread_contexts[(N + v) % job_cores];
+         ShapeItem stolen_head = 0;
+         ShapeItem stolen_tail = 0;
+         POOL_LOCK(victim.chunk_lock,
+            const ShapeItem rest = victim.chunk_tail - victim.chunk_head;
+            if (rest > 0)
+               {
+                 stolen_tail = victim.chunk_tail;
+                 stolen_head = stolen_tail - (rest + 1) / 2;
+                 victim.chunk_tail = stolen_head;
+               })
+
+         if (stolen_head < stolen_tail)   // got some
+            {
+              chunk = stolen_head;
+              POOL_LOCK(chunk_lock,
+                 chunk_head = stolen_head + 1;
+                 chunk_tail = stolen_tail)
+            }
+       }
+
+   if (chunk == -1)   return false;   // all items done (or being done)
+
+   from = chunk * chunk_length;
+   to = from + chunk_length;
+   if (to > job_length)   to = job_length;
+   return true;
+}
+//=============================================================================
+
 // functions and variables  that are only needed #if PARALLEL_ENABLED...
 
 #if PARALLEL_ENABLED
 
 Thread_context::PoolFunction * Thread_context::do_work = &Thread_context::PF_no_work;
 volatile _Atomic_word Thread_context::busy_worker_count = 0;
+volatile _Atomic_word Thread_context::sleeping_workers = 0;
+volatile _Atomic_word Thread_context::sleeping_master = 0;
+volatile _Atomic_word Thread_context::pool_generation = 0;
+volatile _Atomic_word Thread_context::blocked_workers = 0;
 
 sem_t Parallel::print_sema;
 sem_t Parallel::pthread_create_sema;
@@ -141,7 +228,6 @@ void
 Thread_context::init_entry(CoreNumber n)
 {
    N = n;
-   sem_init(&pool_sema, 0, 0);
 }
 //-----------------------------------------------------------------------------
 void
@@ -169,7 +255,8 @@ Thread_context::bind_to_cpu(CPU_Number core, bool logit)
    Log(LOG_Parallel || logit)
       {
         PRINT_LOCKED(CERR << "Binding thread #" << N
-                          << " to core " << core << endl;);
+                          << " to core " << core << " (NUMA node "
+                          << Parallel::get_NUMA_node(core) << ")" << endl;);
       }
 
 cpu_set_t cpus;
@@ -203,7 +290,10 @@ Thread_context::print_all(ostream & out)
    PRINT_LOCKED(
       out << "thread_contexts_count: " << thread_contexts_count << endl
           << "busy_worker_count:     " << busy_worker_count     << endl
-          << "active_core_count:     " << active_core_count     << endl;
+          << "active_core_count:     " << active_core_count     << endl
+          << "sleeping_workers:      " << sleeping_workers      << endl
+          << "blocked_workers:       " << blocked_workers       << endl
+          << "pool_generation:       " << pool_generation       << endl;
 
       loop(e, thread_contexts_count)   thread_contexts[e].print(out);
       out << endl)
@@ -212,12 +302,9 @@ Thread_context::print_all(ostream & out)
 void
 Thread_context::print(ostream & out) const
 {
-int semval = 42;
-   sem_getvalue((sem_t *)&pool_sema, &semval);
-
    out << "thread #"     << setw(2) << N
        << ":"            << setw(16)  << (void *)thread
-       << " pool sema: " << setw(2) << semval
+       << " spins: "     << setw(6) << spin_limit
        << (blocked ? " BLKD" : " RUN ")
        << " job:"        << setw(4) << job_number
        << " " << job_name
@@ -352,6 +439,12 @@ const int err = pthread_getaffinity_np(pthread_self(), sizeof(CPUs), &CPUs);
         return;
       }
 
+   // group the CPUs by NUMA node so that the (contiguous) slices computed
+   // by neighbouring threads stay on the same node, and so that a smaller
+   // count (below) uses the node of the master first.
+   //
+   sort_by_NUMA_node(logit);
+
    // at this point we know the max. number of CPUs and can map cases
    // -1 and -3 to the max. number of CPUs.
    //
@@ -384,6 +477,84 @@ const int err = pthread_getaffinity_np(pthread_self(), sizeof(CPUs), &CPUs);
 #endif // HAVE_AFFINITY_NP
 }
 //-----------------------------------------------------------------------------
+int
+Parallel::get_NUMA_node(CPU_Number cpu)
+{
+   // on linux, /sys/devices/system/cpu/cpuN contains a link nodeM for the
+   // NUMA node M of CPU N.
+   //
+char dirname[64];
+   snprintf(dirname, sizeof(dirname), "/sys/devices/system/cpu/cpu%d", cpu);
+
+DIR * dir = opendir(dirname);
+   if (dir == 0)   return 0;   // no sysfs: assume a single node
+
+int node = 0;
+   for (const dirent * entry = readdir(dir); entry; entry = readdir(dir))
+       {
+         if (strncmp(entry->d_name, "node", 4) == 0 &&
+             isdigit(entry->d_name[4]))
+            {
+              node = atoi(entry->d_name + 4);
+              break;
+            }
+       }
+
+   closedir(dir);
+   return node;
+}
+//-----------------------------------------------------------------------------
+void
+Parallel::sort_by_NUMA_node(bool logit)
+{
+   if (all_CPUs.size() < 2)   return;
+
+vector<int> nodes;
+   loop(c, all_CPUs.size())   nodes.push_back(get_NUMA_node(all_CPUs[c]));
+
+   // the master (thread 0) keeps its CPU, and its node comes first
+   //
+vector<CPU_Number> sorted;
+vector<bool> taken(all_CPUs.size(), false);
+int node = nodes[0];
+   for (;;)
+       {
+         loop(c, all_CPUs.size())
+             {
+               if (!taken[c] && nodes[c] == node)
+                  {
+                    sorted.push_back(all_CPUs[c]);
+                    taken[c] = true;
+                  }
+             }
+
+         if (sorted.size() == all_CPUs.size())   break;   // all done
+
+         // next node: the smallest node not yet taken
+         //
+         node = -1;
+         loop(c, all_CPUs.size())
+             {
+               if (!taken[c] && (node == -1 || nodes[c] < node))
+                  node = nodes[c];
+             }
+       }
+
+   Log(LOG_Parallel || logit)
+      {
+        if (sorted != all_CPUs)
+           {
+             CERR << "CPUs sorted by NUMA node:";
+             loop(c, sorted.size())
+                 CERR << " #" << sorted[c]
+                      << "(" << get_NUMA_node(sorted[c]) << ")";
+             CERR << endl;
+           }
+      }
+
+   all_CPUs = sorted;
+}
+//-----------------------------------------------------------------------------
 void
 Parallel::lock_pool(bool logit)
 {
@@ -405,30 +576,14 @@ Parallel::unlock_pool(bool logit)
 {
    if (Thread_context::get_active_core_count() <= 1)   return;
 
+   Thread_context::M_unlock_pool();
+
    Log(LOG_Parallel || logit)
-     {
-        for (int a = 1; a < Thread_context::get_active_core_count(); ++a)
-            {
-              PRINT_LOCKED(CERR << "Parallel::unlock_pool() : " << endl; )
-              Thread_context * tc = Thread_context::get_context((CoreNumber)a);
-              int old_val = 42;
-              sem_getvalue(&tc->pool_sema, &old_val);
-
-              sem_post(&tc->pool_sema);
-
-              int new_val = 42;
-              sem_getvalue(&tc->pool_sema, &new_val);
-              PRINT_LOCKED(
-              CERR << "    pool_sema of thread #"
-                   << a << " incremented from " << old_val << " to "
-                   << new_val << endl;)
-            }
-     }
-   else
-     {
-        for (int a = 1; a < Thread_context::get_active_core_count(); ++a)
-            sem_post(&Thread_context::get_context((CoreNumber)a)->pool_sema);
-       }
+      {
+        PRINT_LOCKED(
+            CERR << "Parallel::unlock_pool() : pool state is now :" << endl; )
+        Thread_context::print_all(CERR);
+      }
 }
 //-----------------------------------------------------------------------------
 void *
@@ -441,19 +596,19 @@ Thread_context & tctx = *(Thread_context *)arg;
         PRINT_LOCKED(CERR << "worker #" << tctx.get_N() << " started" << endl)
       }
 
-   // tell the creator that we have started
+   // tell the creator that we have started. The creator unlocks the pool
+   // after that, so we need to read pool_generation before.
    //
+const int generation = Thread_context::get_pool_generation();
    sem_post(&pthread_create_sema);
 
-   // start in state locked
+   // start in state blocked
    //
-   tctx.blocked = true;
-   sem_wait(&tctx.pool_sema);
-   tctx.blocked = false;
+   tctx.PF_block_on_pool(generation);
 
    Log(LOG_Parallel)
       PRINT_LOCKED(CERR << "thread #" << tctx.get_N()
-                        << " was unblocked (initially) from pool_sema" << endl)
+                        << " was unblocked (initially) from the pool" << endl)
 
    for (;;)
        {
@@ -481,24 +636,76 @@ Thread_context::PF_lock_unlock_pool(Thread_context & tctx)
    Log(LOG_Parallel)
       {
         PRINT_LOCKED(CERR << "worker #" << tctx.get_N()
-                          << " will now block itself on its pool_sema" << endl)
+                          << " will now block itself on the pool" << endl)
       }
 
+   // the master may unlock the pool as soon as we have joined, so we need
+   // to read pool_generation before joining.
+   //
+const int generation = atomic_read(pool_generation);
    tctx.do_join = false;
    tctx.PF_join();
 
-   tctx.blocked = true;
-   sem_wait(&tctx.pool_sema);
-   tctx.blocked = false;
+   tctx.PF_block_on_pool(generation);
 
    Log(LOG_Parallel)
       {
         PRINT_LOCKED(CERR << "thread #" << tctx.get_N()
-                          << " was unblocked from pool_sema" << endl)
+                          << " was unblocked from the pool" << endl)
       }
 }
 //-----------------------------------------------------------------------------
 void
+Thread_context::PF_block_on_pool(int generation)
+{
+   blocked = true;
+   for (;;)
+       {
+         // don't spin: the pool is normally locked for a long time
+         //
+         int no_spin = 0;
+         while (atomic_read(pool_generation) == generation)
+               wait_for_change(pool_generation, generation,
+                               no_spin, blocked_workers);
+
+         // the pool was unlocked. Continue if we are a member of the
+         // active pool, or else block again.
+         //
+         generation = atomic_read(pool_generation);
+         if (int(N) < int(active_core_count))   break;
+       }
+   blocked = false;
+}
+//-----------------------------------------------------------------------------
+void
+Thread_context::wait_for_change(volatile _Atomic_word & word, int old_value,
+                                int & spin_limit,
+                                volatile _Atomic_word & sleepers)
+{
+   // spin for a while. This avoids the cost of sleeping (and of waking up
+   // the sleeper) if word changes soon.
+   //
+   loop(s, spin_limit)
+       {
+         if (atomic_read(word) != old_value)   // word changed while spinning
+            {
+              if (spin_limit < SPIN_MAX)   spin_limit += spin_limit;
+              return;
+            }
+         cpu_relax();
+       }
+
+   // word did not change soon: spin less next time and sleep. The thread
+   // that changes word checks sleepers after changing it and wakes us up.
+   //
+   if (spin_limit > SPIN_MIN)   spin_limit >>= 1;
+
+   atomic_add(sleepers, 1);
+   if (atomic_read(word) == old_value)   futex_wait(word, old_value);
+   atomic_add(sleepers, -1);
+}
+//-----------------------------------------------------------------------------
+void
 Thread_context::M_lock_pool()
 {
    do_work = PF_lock_unlock_pool;
@@ -506,6 +713,13 @@ Thread_context::M_lock_pool()
 }
 //-----------------------------------------------------------------------------
 void
+Thread_context::M_unlock_pool()
+{
+   atomic_add(pool_generation, 1);
+   futex_wake_all(pool_generation);
+}
+//-----------------------------------------------------------------------------
+void
 Thread_context::kill_pool()
 {
    loop(c, thread_contexts_count)
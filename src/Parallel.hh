@@ -54,10 +54,15 @@
 # define POOL_LOCK(l, x) \
    { Parallel::acquire_lock(l); { x; } Parallel::release_lock(l); }
 
+# define VALUE_LOCK(x) \
+   { if (Parallel::concurrent_values) POOL_LOCK(Parallel::value_lock, x) \
+     else { x; } }
+
 #else
 
 # define PRINT_LOCKED(x) { x; }
 # define POOL_LOCK(l, x) { x; }
+# define VALUE_LOCK(x) { x; }
 
 #endif // PARALLEL_ENABLED
 
@@ -151,6 +156,41 @@ inline void atomic_add(volatile _Atomic_word & counter, int increment)
 #include <semaphore.h>
 #include <vector>
 
+#if defined(__linux__)
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+# define HAVE_FUTEX 1
+#else
+# include <sched.h>
+#endif
+
+/// tell the CPU that we are in a busy-wait loop
+inline void cpu_relax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+   __builtin_ia32_pause();
+#endif
+}
+
+/// block while \b word == \b old_value (or until woken up)
+inline void futex_wait(volatile _Atomic_word & word, int old_value)
+{
+#if HAVE_FUTEX
+   syscall(SYS_futex, (int *)&word, FUTEX_WAIT_PRIVATE, old_value, 0, 0, 0);
+#else
+   if (atomic_read(word) == old_value)   sched_yield();
+#endif
+}
+
+/// wake up all threads blocked in futex_wait(\b word)
+inline void futex_wake_all(volatile _Atomic_word & word)
+{
+#if HAVE_FUTEX
+   syscall(SYS_futex, (int *)&word, FUTEX_WAKE_PRIVATE, 0x7FFFFFFF, 0, 0, 0);
+#endif
+}
+
 #include "Cell.hh"
 
 class Value;
@@ -165,29 +205,47 @@ using namespace std;
   while (worker-) threads 1 ... are only activated when some paralle work
   is available.
 
-  The worker threads 1... are either working, or busy-waiting for work, or
-  blocked on a semaphore:
+  The worker threads 1... are either working, or waiting for work, or
+  blocked on the pool:
 
          init
           ↓
-       blocked ←→ busy-waiting ←→ working
+       blocked ←→ waiting ←→ working
 
   The transitions
 
-      blocked ←→ busy-waiting
+      blocked ←→ waiting
 
-  occur before and after the master thread waits for terminal input or when
-  the number of cores is changed (with ⎕SYL[26;2]). That is,
-  the worker threads are blocked while the master thread waits for terminal
-  input.
+  occur when the number of cores is changed (with ⎕SYL[26;2]). A blocked
+  worker is not a member of the active pool (i.e. its number is ≥ the
+  active core count) and sleeps until the pool generation counter
+  (pool_generation) changes.
 
   The transitions
 
-        busy-waiting ←→ working
+        waiting ←→ working
 
-  occurs when the execution of APL primitives, primarily scalar functions,
+  occur when the execution of APL primitives, primarily scalar functions,
   suggests to execute in parallel (i.e. if the vectors involved are
-  sufficiently long).
+  sufficiently long). The master starts a job by incrementing its
+  job_number (which serves as a generation counter for all workers).
+  A waiting worker first busy-waits (spins) for a new job_number and
+  then sleeps on a futex until the master wakes it up. The time spent
+  spinning adapts itself: it grows when new jobs arrive quickly and
+  shrinks when the worker had to sleep. Therefore idle workers (e.g.
+  while the interpreter waits for terminal input) do not burn CPU cycles,
+  while a series of parallel jobs is started without system calls.
+
+  The master waits for the end of a job (i.e. busy_worker_count == 0) in
+  the same spin-then-sleep manner.
+
+  The items of a job are distributed by a work-stealing scheduler: the
+  master splits the items into chunks (M_distribute()) and gives every
+  core a deque of contiguous chunks. A core takes chunks from the front of
+  its own deque (PF_next_range()) and, when its deque is empty, steals the
+  second half of the remaining chunks from the back of the deque of
+  another core. Cores with cheap items (e.g. simple cells) therefore help
+  cores with expensive items (e.g. nested cells) instead of waiting for them.
 
  **/
 //=============================================================================
@@ -210,33 +268,54 @@ public:
         get_master().job_name = jname;
         atomic_add(busy_worker_count, active_core_count - 1);
         atomic_add(get_master().job_number, 1);
+        if (atomic_read(sleeping_workers))
+           futex_wake_all(get_master().job_number);
       }
 
    /// start parallel execution of work in a worker
    void PF_fork()
       {
         while (atomic_read(get_master().job_number) == job_number)
-              /* busy wait */ ;
+              wait_for_change(get_master().job_number, job_number,
+                              spin_limit, sleeping_workers);
       }
 
    /// end parallel execution of work at the master
    static void M_join()
       {
-        while (atomic_read(busy_worker_count) != 0)   /* busy wait */ ;
+        Thread_context & master = get_master();
+        for (;;)
+            {
+              const int busy = atomic_read(busy_worker_count);
+              if (busy == 0)   return;
+              wait_for_change(busy_worker_count, busy,
+                              master.spin_limit, sleeping_master);
+            }
       }
 
    /// end parallel execution of work in a worker
    void PF_join()
       {
-        atomic_add(busy_worker_count, -1);   // we are ready
-        atomic_add(job_number, 1);            // we reached master job_number
-
-        // wait until all workers finished or new job from master
-        while (atomic_read(busy_worker_count) != 0 &&
-               atomic_read(get_master().job_number) == job_number)
-              /* busy wait */ ;
+        atomic_add(job_number, 1);   // we reached master job_number
+        if (atomic_fetch_add(busy_worker_count, -1) == 1 &&   // we were last
+            atomic_read(sleeping_master))
+           futex_wake_all(busy_worker_count);
       }
 
+   /// distribute the \b len items of a job (in chunks) over \b cores cores
+   static void M_distribute(ShapeItem len, CoreCount cores);
+
+   /// get the next range [\b from, \b to) of items to be computed by
+   /// \b this thread (own chunks first, then stolen ones). Return false
+   /// if no items are left.
+   bool PF_next_range(ShapeItem & from, ShapeItem & to);
+
+   /// spin (up to \b spin_limit times), and then sleep, until \b word
+   /// changes from \b old_value. Adjust \b spin_limit accordingly.
+   static void wait_for_change(volatile _Atomic_word & word, int old_value,
+                               int & spin_limit,
+                               volatile _Atomic_word & sleepers);
+
    /// bind thread to core
    void bind_to_cpu(CPU_Number cpu, bool logit);
 
@@ -263,9 +342,24 @@ public:
    static Thread_context & get_master()
       { return thread_contexts[CNUM_MASTER]; }
 
-   /// make all workers lock on pool_sema
+   /// return true iff the calling thread is the master (interpreter) thread
+   static bool is_master_thread()
+      { return pthread_equal(pthread_self(), get_master().thread); }
+
+   /// make all workers block on the pool
    void M_lock_pool();
 
+   /// unblock all workers of the active pool
+   static void M_unlock_pool();
+
+   /// block until pool_generation differs from \b generation and \b this
+   /// worker is a member of the active pool
+   void PF_block_on_pool(int generation);
+
+   /// return the current pool generation
+   static int get_pool_generation()
+      { return atomic_read(pool_generation); }
+
    /// terminate all worker threads
    static void kill_pool();
 
@@ -275,9 +369,15 @@ public:
    /// a thread-function that should not be called
    static PoolFunction PF_no_work;
 
-   /// block/unblock on the pool semaphore
+   /// block/unblock on the pool
    static PoolFunction PF_lock_unlock_pool;
 
+   /// the (initial) number of spins before a thread sleeps
+   enum { SPIN_MIN = 64, SPIN_INITIAL = 4096, SPIN_MAX = 65536 };
+
+   /// the number of chunks per core and the min. chunk length of a job
+   enum { CHUNKS_PER_CORE = 8, MIN_CHUNK_LENGTH = 16 };
+
    /// number of currently used cores
    static CoreCount get_active_core_count()
       { return active_core_count; }
@@ -309,12 +409,21 @@ public:
    /// true if this context shall join (i.e. is not the master)
    bool do_join;
 
-   /// a semaphore to block this context
-   sem_t pool_sema;
+   /// the current number of spins before this thread sleeps
+   int spin_limit;
 
-   /// true if blocked on pool_sema
+   /// true if blocked on the pool
    bool blocked;
 
+   /// a lock protecting chunk_head and chunk_tail
+   volatile _Atomic_word chunk_lock;
+
+   /// the first chunk in the deque of \b this thread
+   ShapeItem chunk_head;
+
+   /// the end of the chunks in the deque of \b this thread
+   ShapeItem chunk_tail;
+
 protected:
    /// all thread contexts
    static Thread_context * thread_contexts;
@@ -327,6 +436,27 @@ protected:
 
    /// the number of cores currently used
    static CoreCount active_core_count;
+
+   /// the number of workers sleeping in PF_fork()
+   static volatile _Atomic_word sleeping_workers;
+
+   /// non-zero if the master sleeps in M_join()
+   static volatile _Atomic_word sleeping_master;
+
+   /// a counter that is incremented whenever the pool is unlocked
+   static volatile _Atomic_word pool_generation;
+
+   /// the number of workers blocked on the pool
+   static volatile _Atomic_word blocked_workers;
+
+   /// the number of cores computing the current job
+   static CoreCount job_cores;
+
+   /// the number of items in the current job
+   static ShapeItem job_length;
+
+   /// the number of items in a chunk of the current job
+   static ShapeItem chunk_length;
 };
 //=============================================================================
 /// a class coordinating the different cores working in prallel
@@ -368,14 +498,22 @@ public:
    /// true if parallel execution is enabled
    static bool run_parallel;
 
+   /// true while worker threads evaluate APL functions (and may therefore
+   /// create and delete APL values concurrently)
+   static bool concurrent_values;
+
+   /// a lock for the creation and deletion of APL values (only used while
+   /// concurrent_values is true)
+   static volatile _Atomic_word value_lock;
+
    /// number of available cores
    static CoreCount get_max_core_count()
       { return (CoreCount)(all_CPUs.size()); }
 
-   /// make all pool members lock on their pool_sema
+   /// make all pool members block on the pool
    static void lock_pool(bool logit);
 
-   /// unlock all pool members from their pool_sema
+   /// unblock the members of the active pool
    static void unlock_pool(bool logit);
 
    /// initialize
@@ -394,6 +532,9 @@ public:
    static CPU_Number get_CPU(int idx)
       { return all_CPUs[idx]; }
 
+   /// return the NUMA node of \b cpu (0 if unknown)
+   static int get_NUMA_node(CPU_Number cpu);
+
 protected:
    /// the main() function of the worker threads
    static void * worker_main(void *);
@@ -401,6 +542,9 @@ protected:
    /// initialize \b all_CPUs (which then determines the max. core count)
    static void init_all_CPUs(bool logit);
 
+   /// sort \b all_CPUs by their NUMA node (master node first)
+   static void sort_by_NUMA_node(bool logit);
+
    /// the CPU numbers that can be used
    static vector<CPU_Number>all_CPUs;
 };
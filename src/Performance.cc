@@ -23,9 +23,15 @@
 #include <math.h>
 
 #include "Common.hh"
+#include "FloatCell.hh"
+#include "IntCell.hh"
+#include "Parallel.hh"
 #include "Performance.hh"
 #include "PrintOperator.hh"
+#include "ScalarFunction.hh"
 #include "UCS_string.hh"
+#include "UserPreferences.hh"
+#include "Value.icc"
 
 #define perfo_1(id, ab, _name, _thr) \
    CellFunctionStatistics Performance::cfs_ ## id ## ab(PFS_## id ## ab);
@@ -252,6 +258,154 @@ Performance::reset_all()
 #include "Performance.def"
 }
 //----------------------------------------------------------------------------
+#if PARALLEL_ENABLED && HAVE_RDTSC
+
+/// return true if scalar function \b fun needs (boolean) integer arguments
+static bool
+calibration_int_args(const Function * fun)
+{
+   return fun == Bif_F12_WITHOUT::fun || fun == Bif_F12_ROLL::fun   ||
+          fun == Bif_F2_AND::fun      || fun == Bif_F2_OR::fun      ||
+          fun == Bif_F2_NAND::fun     || fun == Bif_F2_NOR::fun     ||
+          fun == Bif_F12_CIRCLE::fun;
+}
+//----------------------------------------------------------------------------
+/// return the minimum number of cycles of several evaluations of
+/// \b fun (monadic if \b A is 0, otherwise dyadic)
+static uint64_t
+calibration_cycles(Function * fun, Value_P A, Value_P B)
+{
+uint64_t best = 0xFFFFFFFFFFFFFFFFULL;
+   loop(r, Performance::CALIBRATION_REPEAT)
+       {
+         const uint64_t start = cycle_counter();
+         if (!A)   fun->eval_B(B);
+         else      fun->eval_AB(A, B);
+         const uint64_t end = cycle_counter();
+         if (best > end - start)   best = end - start;
+       }
+
+   return best;
+}
+//----------------------------------------------------------------------------
+ShapeItem
+Performance::calibrate_threshold(ostream & out, Function * fun, bool dyadic,
+                                 const char * name)
+{
+const ShapeItem old_threshold = dyadic ? fun->get_dyadic_threshold()
+                                       : fun->get_monadic_threshold();
+const bool int_args = calibration_int_args(fun);
+
+   // the cost of fun is A + B×N cycles (see README-8-parallel). We compute
+   // A and B from two lengths N, first sequentially (threshold never) and
+   // then in parallel (threshold 0).
+   //
+const ShapeItem lengths[] = { CALIBRATION_SHORT, CALIBRATION_LONG };
+double cycles[2][2];   // cycles[parallel][length]
+   loop(l, 2)
+       {
+         const ShapeItem len = lengths[l];
+         Value_P B(len, LOC);
+         loop(b, len)
+             {
+               if (int_args)   new (B->next_ravel())   IntCell(1);
+               else            new (B->next_ravel())   FloatCell(0.5);
+             }
+         B->check_value(LOC);
+
+         Value_P A;
+         if (dyadic)   A = B;
+
+         loop(par, 2)
+             {
+               const ShapeItem threshold = par ? 0 : THRESHOLD_NEVER;
+               if (dyadic)   fun->set_dyadic_threshold(threshold);
+               else          fun->set_monadic_threshold(threshold);
+               calibration_cycles(fun, A, B);   // warm-up
+               cycles[par][l] = calibration_cycles(fun, A, B);
+             }
+       }
+
+   if (dyadic)   fun->set_dyadic_threshold(old_threshold);
+   else          fun->set_monadic_threshold(old_threshold);
+
+const double dN = lengths[1] - lengths[0];
+const double B0 = (cycles[0][1] - cycles[0][0]) / dN;
+const double Bc = (cycles[1][1] - cycles[1][0]) / dN;
+const double A0 = cycles[0][0] - B0*lengths[0];
+const double Ac = cycles[1][0] - Bc*lengths[0];
+
+ShapeItem BE = THRESHOLD_NEVER;
+   if (Bc < B0)   // parallel per-item cost is lower than sequential
+      {
+        const double be = (Ac - A0) / (B0 - Bc);
+        BE = be < 0 ? 0 : ShapeItem(be + 1);
+      }
+
+UTF8_string utf(name);
+UCS_string uname(utf);
+   out << "║ " << uname;
+   loop(n, 12 - uname.size())   out << " ";
+   out << "    ║ " << setw(8) << ShapeItem(A0)
+       << " │ "    << setw(6) << ShapeItem(B0)
+       << " ║ "    << setw(8) << ShapeItem(Ac)
+       << " │ "    << setw(6) << ShapeItem(Bc)
+       << " ║ ";
+   if (BE == THRESHOLD_NEVER)   out << "   never";
+   else                         out << setw(8) << BE;
+   out << " ║" << endl;
+
+   return BE;
+}
+#endif // PARALLEL_ENABLED && HAVE_RDTSC
+//----------------------------------------------------------------------------
+void
+Performance::calibrate_thresholds(ostream & out)
+{
+#if ! PARALLEL_ENABLED
+   out << "Calibration of parallel thresholds is not available, since"
+          " parallel execution\nwas not configured for this APL interpreter"
+          " (see README-8-parallel)." << endl;
+#elif ! HAVE_RDTSC
+   out << "Calibration of parallel thresholds is not available, since"
+          " CPU cycle counters\nare not supported on this platform." << endl;
+#else
+   if (Thread_context::get_active_core_count() < 2)
+      {
+        out << "Calibration of parallel thresholds needs more than one core"
+               " (see ⎕SYL[26;2])." << endl;
+        return;
+      }
+
+   out << "Calibrating parallel thresholds for "
+       << Thread_context::get_active_core_count() << " cores..." << endl
+       <<
+"╔═════════════════╦═══════════════════╦═══════════════════╦══════════╗\n"
+"║      Scalar     ║     sequential    ║      parallel     ║ parallel ║\n"
+"║     Function    ║    A0    │   B0   ║    Ac    │   Bc   ║  if N >  ║\n"
+"╠═════════════════╬══════════╪════════╬══════════╪════════╬══════════╣\n";
+
+#define perfo_1(id, ab, name, _thr)                                        \
+   { Function * fun = Bif_ ## id::fun;                                     \
+     fun->set_monadic_threshold(calibrate_threshold(out, fun, false, name)); }
+
+   // skip non-scalar functions (such as ⋸) that have no scalar f2
+#define perfo_2(id, ab, name, _thr)                                        \
+   { Function * fun = Bif_ ## id::fun;                                     \
+     if (fun->get_scalar_f2())                                             \
+        fun->set_dyadic_threshold(calibrate_threshold(out, fun, true, name)); }
+
+#define perfo_3(id, ab, _name, _thr)
+#define perfo_4(id, ab, _name, _thr)
+#include "Performance.def"
+
+   out <<
+"╚═════════════════╩══════════╧════════╩══════════╧════════╩══════════╝" << endl;
+
+   uprefs.write_threshold_file(out);
+#endif // PARALLEL_ENABLED
+}
+//----------------------------------------------------------------------------
 void
 Statistics_record::print(ostream & out)
 {
@@ -49,6 +49,8 @@
 
 using namespace std;
 
+class Function;
+
 //-----------------------------------------------------------------------------
 /// performance statistics IDs
 enum Pfstat_ID
@@ -318,6 +320,26 @@ public:
    /// reset all counters
    static void reset_all();
 
+   /// measure the sequential and the parallel cost of all scalar functions,
+   /// set their parallel thresholds to the break-even points, and write
+   /// the thresholds to the user's \b parallel_thresholds file
+   static void calibrate_thresholds(ostream & out);
+
+   enum
+      {
+        /// short vector length for calibrate_thresholds()
+        CALIBRATION_SHORT = 16,
+
+        /// long vector length for calibrate_thresholds()
+        CALIBRATION_LONG = 16384,
+
+        /// number of measurements (the minimum of which is taken)
+        CALIBRATION_REPEAT = 10,
+      };
+
+   /// a threshold that is never reached (i.e. always compute sequentially)
+   static const ShapeItem THRESHOLD_NEVER = 8888888888888888888LL;
+
 #define perfo_1(id, ab, name, thr)                   \
    /** monadic cell function statistics **/          \
    static CellFunctionStatistics cfs_ ## id ## ab;   \
@@ -339,6 +361,12 @@ public:
    static FunctionStatistics fs_ ## id ## ab;
 
 #include "Performance.def"
+
+protected:
+   /// measure the sequential and parallel cost of \b fun and return its
+   /// break-even length
+   static ShapeItem calibrate_threshold(ostream & out, Function * fun,
+                                        bool dyadic, const char * name);
 };
 
 #endif // __PERFORMANCE_HH_DEFINED__
@@ -125,6 +125,24 @@ Value_P ret = value._valp();
    return ret;
 }
 //-----------------------------------------------------------------------------
+Value_P
+PointerCell::get_unshared_pointer_value(const char * loc)
+{
+Value_P ret = value._valp();
+
+   // ret and this cell own the sub-value. If there are more owners then the
+   // sub-value is shared (see Cell::init()) and we replace it by a copy.
+   // The copy has the same size, so the counts of our owner do not change.
+   //
+   if (ret->get_owner_count() > 2)
+      {
+        ret = ret->clone(loc);
+        value._valp() = ret;
+      }
+
+   return ret;
+}
+//-----------------------------------------------------------------------------
 CellType
 PointerCell::deep_cell_types() const
 {
@@ -41,6 +41,9 @@ public:
    /// overloaded Cell::get_pointer_value()
    virtual Value_P get_pointer_value()  const;
 
+   /// overloaded Cell::get_unshared_pointer_value()
+   virtual Value_P get_unshared_pointer_value(const char * loc);
+
    /// overloaded Cell::greater()
    virtual bool greater(const Cell & other) const;
 
@@ -26,6 +26,7 @@
 #include "LvalCell.hh"
 #include "PointerCell.hh"
 #include "Prefix.hh"
+#include "ScalarFusion.hh"
 #include "StateIndicator.hh"
 #include "Symbol.hh"
 #include "UserFunction.hh"
@@ -40,7 +41,8 @@ Prefix::Prefix(StateIndicator & _si, const Token_string & _body)
      body(_body),
      PC(Function_PC_0),
      assign_state(ASS_none),
-     lookahead_high(Function_PC_invalid)
+     lookahead_high(Function_PC_invalid),
+     restart_pending(false)
 {
 }
 //-----------------------------------------------------------------------------
@@ -179,6 +181,135 @@ TokenClass next = body[pc].get_Class();
 }
 //-----------------------------------------------------------------------------
 bool
+Prefix::append_in_place(const Token_loc & tl)
+{
+   // tl is the (right) symbol R that was just read. The statement is
+   // R←R,B if B was already evaluated (i.e. the stack is , B) and the next
+   // token are ← R END. In that case B can be appended to the value of R
+   // instead of copying R twice (resolve R and assign R) and catenating.
+   //
+   if (tl.tok.get_tag() != TOK_SYMBOL)          return false;
+   if (size() != 2)                             return false;
+   if (at0().get_tag() != TOK_F12_COMMA)        return false;
+   if (at1().get_Class() != TC_VALUE)           return false;
+
+const Function_PC pc = tl.pc;
+   if (int(pc) + 3 >= int(body.size()))         return false;
+   if (body[pc + 1].get_Class() != TC_ASSIGN)   return false;
+   if (body[pc + 2].get_tag() != TOK_LSYMB)     return false;
+   if (body[pc + 3].get_Class() != TC_END)      return false;
+
+Symbol * sym = tl.tok.get_sym_ptr();
+   if (body[pc + 2].get_sym_ptr() != sym)       return false;
+
+Value_P Z = sym->append_value(*at1().get_apl_val(), LOC);
+   if (!Z)   return false;
+
+   Log(LOG_optimization)   CERR << "optimizing A←A,B" << endl;
+
+   // replace , B on the stack and R ← R in the body by the committed
+   // value of R (as reduce_V_ASS_B_() would have done).
+   //
+   at0().clear(LOC);
+   at1().clear(LOC);
+   put -= 2;
+
+   lookahead_high = pc + 2;
+   PC = pc + 3;
+   push(Token_loc(Token(TOK_APL_VALUE2, Z), pc + 2));
+   return true;
+}
+//-----------------------------------------------------------------------------
+Value_P
+Prefix::fun_arg(const Token & tok, const Function * fun)
+{
+Value_P value = tok.get_deferred_apl_val();
+   if (value->is_lazy()  && !fun->accepts_lazy())    value->materialize();
+   if (value->is_fused() && !fun->accepts_fused())   value->materialize();
+   return value;
+}
+//-----------------------------------------------------------------------------
+bool
+Prefix::may_fuse(const Token & tok)
+{
+const Value * value = tok.get_apl_val_pointer();
+   return value && value->element_count() >= ScalarFusion::MIN_LEN;
+}
+//-----------------------------------------------------------------------------
+Token
+Prefix::eval_fused_B(Function * fun, const Token & tok_B)
+{
+Value_P B = fun_arg(tok_B, fun);
+Value_P Z = fun->fuse_B(B);
+   if (!!Z)   return Token(TOK_APL_VALUE1, Z);
+   return fun->eval_B(B);
+}
+//-----------------------------------------------------------------------------
+Token
+Prefix::eval_fused_AB(Function * fun, const Token & tok_A,
+                      const Token & tok_B)
+{
+Value_P A = fun_arg(tok_A, fun);
+Value_P B = fun_arg(tok_B, fun);
+Value_P Z = fun->fuse_AB(A, B);
+   if (!!Z)   return Token(TOK_APL_VALUE1, Z);
+   return fun->eval_AB(A, B);
+}
+//-----------------------------------------------------------------------------
+bool
+Prefix::is_tail_call(const Function * fun, const Symbol * sym_Z) const
+{
+   // fun is about to be called from the phrase being reduced. The call is a
+   // tail call if the phrase is the entire statement Z←fun B or Z←A fun B
+   // and the statement is followed by the return of Z (the end of the
+   // function or →0). The result of fun is then also our result.
+   //
+   if (sym_Z == 0)   return false;
+
+Function_PC pc = PC;
+const Token * tok_fun;
+   if (size() == 2)   // MISC F B with the ← in saved_lookahead
+      {
+        if (saved_lookahead.tok.get_Class() != TC_ASSIGN)   return false;
+        tok_fun = &at(0).tok;
+      }
+   else if (size() == 3)   // A F B with the ← at PC
+      {
+        if (int(pc) >= int(body.size()))          return false;
+        if (body[pc].get_Class() != TC_ASSIGN)    return false;
+        tok_fun = &at(1).tok;
+        ++pc;
+      }
+   else return false;
+
+   if (tok_fun->get_ValueType() != TV_FUN)        return false;
+   if (tok_fun->get_function() != fun)            return false;
+
+   if (int(pc) + 2 >= int(body.size()))           return false;
+   if (body[pc].get_Class() != TC_SYMBOL)         return false;
+   if (body[pc].get_sym_ptr() != sym_Z)           return false;
+   if (body[pc + 1].get_Class() != TC_END)        return false;
+   if (body[pc + 1].get_int_val() & 1)            return false;   // traced
+
+   pc = pc + 2;
+   if (body[pc].get_tag() == TOK_RETURN_SYMBOL)   // end of function
+      return body[pc].get_sym_ptr() == sym_Z;
+
+   // →0
+   //
+   if (int(pc) + 2 >= int(body.size()))           return false;
+   if (body[pc].get_Class() != TC_VALUE)          return false;
+   if (body[pc + 1].get_tag() != TOK_R_ARROW)     return false;
+   if (body[pc + 2].get_Class() != TC_END)        return false;
+
+Value_P line = body[pc].get_apl_val();
+   if (line->element_count() != 1)                return false;
+
+const Cell & cell = line->get_ravel(0);
+   return cell.is_integer_cell() && cell.get_int_value() == 0;
+}
+//-----------------------------------------------------------------------------
+bool
 Prefix::is_value_bracket() const
 {
    Assert1(body[PC - 1].get_Class() == TC_R_BRACK);
@@ -340,17 +471,17 @@ Prefix::unmark_all_values() const
         const Token & tok = at(s).tok;
         if (tok.get_ValueType() != TV_VAL)      continue;
 
-        Value_P value = tok.get_apl_val();
+        Value_P value = tok.get_deferred_apl_val();   // even if lazy
         if (!!value)   value->unmark();
       }
 }
 //-----------------------------------------------------------------------------
 
-// a hash table with all prefixes that can be reduced...
-#define PH(name, idx, prio, misc, len, fun) \
-   { #name, idx, prio, misc, len, &Prefix::reduce_ ## fun, #fun },
+// the phrase table and the phrase automaton (generated by tools/phrase_gen)
+#define PH(name, idx, prio, misc, len, look, fun) \
+   { #name, idx, prio, misc, len, look, &Prefix::reduce_ ## fun, #fun },
 
-#include "Prefix.def"   // the hash table
+#include "Prefix.def"   // the phrase tables
 
 Token
 Prefix::reduce_statements()
@@ -397,6 +528,8 @@ grow:
      lookahead_high = tl.pc;
      TokenClass tcl = tl.tok.get_Class();
 
+     if (tcl == TC_SYMBOL && append_in_place(tl))   goto again;   // R←R,B
+
      if (tcl == TC_SYMBOL)   // resolve symbol if necessary
         {
           // reset the PC back to the previous token, so that a failed
@@ -458,54 +591,35 @@ grow:
 again:
    Log(LOG_prefix_parser)   print_stack(CERR, LOC);
 
-   // search prefixes in phrase table...
+   // find the longest phrase that matches the top of the stack. Every
+   // token class moves the phrase automaton to a state for a longer prefix
+   // (of one or more phrases) until no phrase has that prefix.
    //
    {
-     const int idx_0 = at0().get_Class();
-
-     if (size() >= 3)
+     const int len = size() < MAX_PHRASE_LEN ? size() : MAX_PHRASE_LEN;
+     const Phrase_state * state = phrase_states;   // the empty prefix
+     best = 0;
+     loop(l, len)
         {
-          const int idx_01  = idx_0  | at1().get_Class() <<  5;
-          const int idx_012 = idx_01 | at2().get_Class() << 10;
-
-          if (size() >= 4)
-             {
-               const int idx_0123 = idx_012 | at3().get_Class() << 15;
-               best = hash_table + idx_0123 % PHRASE_MODU;
-               if (best->idx == idx_0123)   goto found_prefix;
-             }
+          const TokenClass tc = at(l).tok.get_Class();
+          if (tc >= TC_MAX_PHRASE)   break;
 
-          best = hash_table + idx_012 % PHRASE_MODU;
-          if (best->idx == idx_012)   goto found_prefix;
+          const int next = state->next[tc];
+          if (next == 0)   break;
 
-          best = hash_table + idx_01 % PHRASE_MODU;
-          if (best->idx == idx_01)   goto found_prefix;
-
-          best = hash_table + idx_0 % PHRASE_MODU;
-          if (best->idx != idx_0)   goto grow;   // no matching phrase
+          state = phrase_states + next;
+          if (state->phrase != -1)   best = phrase_table + state->phrase;
         }
-     else   // 0 < size() < 3
-        {
-          if (size() >= 2)
-             {
-               const int idx_01 = idx_0 | at1().get_Class() << 5;
-               best = hash_table + idx_01 % PHRASE_MODU;
-               if (best->idx == idx_01)   goto found_prefix;
-             }
 
-          best = hash_table + idx_0 % PHRASE_MODU;
-          if (best->idx != idx_0)   goto grow;
-        }
+     if (best == 0)   goto grow;   // no matching phrase
    }
 
-found_prefix:
-
    // found a reducible prefix. See if the next token class binds stronger
    // than best->prio
    //
    {
      TokenClass next = TC_INVALID;
-     if (PC < body.size())
+     if (best->lookahead && PC < body.size())   // next is needed
         {
           const Token & tok = body[PC];
 
@@ -550,11 +664,11 @@ found_prefix:
      // we could reduce, but we could also shift. Compute more, which is true
      // if we should shift.
      //
-     const bool shift = dont_reduce(next);
+     const bool shift = best->lookahead && dont_reduce(next);
      if (shift)
         {
            Log(LOG_prefix_parser)  CERR
-               << "   phrase #" << (best - hash_table)
+               << "   phrase #" << (best - phrase_table)
                << ": " << best->phrase_name
                << " matches, but prio " << best->prio
                << " is too small to call " << best->reduce_name
@@ -564,7 +678,7 @@ found_prefix:
    }
 
    Log(LOG_prefix_parser)  CERR
-      << "   phrase #" <<  (best - hash_table)
+      << "   phrase #" <<  (best - phrase_table)
       << ": " << best->phrase_name
       << " matches, prio " << best->prio
       << ", calling reduce_" << best->reduce_name
@@ -600,6 +714,14 @@ found_prefix:
 
    if (action == RA_SI_PUSHED)
       {
+        if (restart_pending)   // tail call: our SI entry was re-used
+           {
+             Log(LOG_prefix_parser)   CERR << "RA_SI_PUSHED (tail call)" << endl;
+             restart_pending = false;
+             set_PC(Function_PC_0);
+             goto grow;
+           }
+
         Log(LOG_prefix_parser)   CERR << "RA_SI_PUSHED" << endl;
         return Token(TOK_SI_PUSHED);
       }
@@ -832,7 +954,9 @@ Prefix::reduce_MISC_F_B_()
            }
       }
 
-Token result = at0().get_function()->eval_B(at1().get_apl_val());
+Function * fun = at0().get_function();
+Token result = may_fuse(at1()) ? eval_fused_B(fun, at1())
+                               : fun->eval_B(fun_arg(at1(), fun));
    if (result.get_tag() == TOK_ERROR)
       {
         Token_loc tl(result, get_range_low());
@@ -892,8 +1016,10 @@ Prefix::reduce_A_F_B_()
 {
    Assert1(prefix_len == 3);
 
-Token result = at1().get_function()->eval_AB(at0().get_apl_val(),
-                                             at2().get_apl_val());
+Function * fun = at1().get_function();
+Token result = may_fuse(at0()) || may_fuse(at2())
+             ? eval_fused_AB(fun, at0(), at2())
+             : fun->eval_AB(fun_arg(at0(), fun), fun_arg(at2(), fun));
    if (result.get_tag() == TOK_ERROR)
       {
         Token_loc tl(result, get_range_low());
@@ -1171,7 +1297,7 @@ Value_P Z;
 
    if (at1().get_tag() == TOK_AXES)
       {
-        Z = A->index(at1().get_apl_val());
+        Z = A->index(at1().get_lazy_apl_val());
       }
    else
       {
@@ -1419,10 +1545,16 @@ Prefix::reduce_LBRA_B_I_()
    // [ B I or ; B I   (normal index)
    //
 Token I = at2();
-   I.get_index_val().add(at1().get_apl_val());
-
 const bool last_index = (at0().get_tag() == TOK_L_BRACK);   // ; vs. [
 
+   // a single index [B] becomes TOK_AXES, which may remain lazy until
+   // reduce_A_C__() or Token::get_axes()
+   //
+   if (last_index && I.get_index_val().value_count() == 0)
+      I.get_index_val().add(at1().get_lazy_apl_val());
+   else
+      I.get_index_val().add(at1().get_apl_val());
+
    if (last_index)   // [ seen
       {
         IndexExpr & idx = I.get_index_val();
@@ -263,6 +263,34 @@ public:
    /// read and resolve the token class left of )
    bool is_value_parent(int pc) const;
 
+   /// if symbol \b tl starts the statement R←R,B then append B to R in
+   /// place, push the result, and return true.
+   bool append_in_place(const Token_loc & tl);
+
+   /// return the value of token \b tok as an argument of \b fun. A lazy
+   /// or fused value is computed unless \b fun accepts such values.
+   static Value_P fun_arg(const Token & tok, const Function * fun);
+
+   /// return true if the value of token \b tok is long enough to be fused
+   /// (see ScalarFusion). Shorter arguments skip the fusion entirely.
+   static bool may_fuse(const Token & tok);
+
+   /// return fun B, possibly as a fused value (see Function::fuse_B())
+   static Token eval_fused_B(Function * fun, const Token & tok_B);
+
+   /// return A fun B, possibly as a fused value (see Function::fuse_AB())
+   static Token eval_fused_AB(Function * fun, const Token & tok_A,
+                              const Token & tok_B);
+
+   /// return true if \b fun, called from the phrase being reduced, is a
+   /// tail call, i.e. its result would be assigned to \b sym_Z and returned
+   bool is_tail_call(const Function * fun, const Symbol * sym_Z) const;
+
+   /// start over at the beginning of the body after the current reduction
+   /// (used when a tail call re-uses our SI entry)
+   void restart_body()
+      { restart_pending = true; }
+
    /// return the leftmost (top-of-stack) Token_loc (at put position)
    Token_loc & tos()
        { Assert1(put);   return content[put - 1]; }
@@ -310,6 +338,9 @@ protected:
 
    /// the phrase being reduced (only valid if a phrase was matched)
    const Phrase * best;
+
+   /// true if the body shall be restarted (after a tail call)
+   bool restart_pending;
 };
 //-----------------------------------------------------------------------------
 
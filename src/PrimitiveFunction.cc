@@ -120,6 +120,20 @@ PrimitiveFunction::print(ostream & out) const
    return out << get_Id();
 }
 //-----------------------------------------------------------------------------
+bool
+PrimitiveFunction::is_temp_argument(const Value & value, int arg_owners,
+                                    bool dyadic) const
+{
+   if (value.get_owner_count() != 1 + arg_owners)   return false;
+
+StateIndicator * si = Workspace::SI_top();
+   if (si == 0)   return false;
+
+const Function * prefix_fun = dyadic ? si->get_prefix().get_dyadic_fun()
+                                     : si->get_prefix().get_monadic_fun();
+   return this == prefix_fun;
+}
+//-----------------------------------------------------------------------------
 void
 PrimitiveFunction::print_properties(ostream & out, int indent) const
 {
@@ -157,6 +171,23 @@ const uint64_t start_1 = cycle_counter();
 #endif
 #endif
 
+   if (A->is_lazy())   A->materialize();
+   if (B->is_lazy())   // N⍴⍳M with N ≤ M is N↑⍳M
+      {
+        if (A->get_rank() == 1 && A->element_count() == 1 &&
+            A->get_ravel(0).is_near_int())
+           {
+             const APL_Integer len_Z = A->get_ravel(0).get_near_int();
+             if (len_Z >= 0 && len_Z <= B->element_count())
+                {
+                  return Token(TOK_APL_VALUE1,
+                               Value::progression(len_Z, B->get_lazy_start(),
+                                                  B->get_lazy_step(), LOC));
+                }
+           }
+        B->materialize();
+      }
+
 const Shape shape_Z(A, 0);
 
    // check that shape_Z is positive
@@ -168,9 +199,7 @@ const Shape shape_Z(A, 0);
 
 const ShapeItem len_Z = shape_Z.get_volume();
 
-   if (len_Z <= B->element_count()   &&
-       B->get_owner_count() == 2 && 
-       this == Workspace::SI_top()->get_prefix().get_dyadic_fun())
+   if (len_Z <= B->element_count() && is_temp_argument(*B, 1, true))
       {
         // at this point Z is not greater than B and B has only 2 owners:
         // the prefix (who will discard it after we return) and our Value_P B
@@ -190,7 +219,7 @@ const ShapeItem len_Z = shape_Z.get_volume();
              rest = 1;
              if (B->get_ravel(0).is_pointer_cell())
                 {
-                  B->get_ravel(0).get_pointer_value()->to_proto();
+                  B->get_ravel(0).get_unshared_pointer_value(LOC)->to_proto();
                 }
              else
                 {
@@ -239,10 +268,27 @@ Value_P Z(shape_Z, LOC);
         loop(z, len_Z)
             Z->get_ravel(z).init_type(B.get_ravel(0), Z.getref(), LOC);
       }
-   else
+   else if (len_Z)
       {
-        loop(z, len_Z)
-            Z->get_ravel(z).init(B.get_ravel(z % len_B), Z.getref(), LOC);
+        Cell * cZ = &Z->get_ravel(0);
+        const ShapeItem len_0 = len_Z < len_B ? len_Z : len_B;
+        if (Cell::copy_ravel(cZ, &B.get_ravel(0), len_0, Z.getref()))
+           {
+             // B is simple: double the cells copied so far until Z is full
+             //
+             for (ShapeItem done = len_0; done < len_Z;)
+                 {
+                   const ShapeItem len = done < len_Z - done ? done
+                                                             : len_Z - done;
+                   memcpy(cZ + done, cZ, len * sizeof(Cell));
+                   done += len;
+                 }
+           }
+        else
+           {
+             for (ShapeItem z = len_0; z < len_Z; ++z)
+                 cZ[z].init(B.get_ravel(z % len_B), Z.getref(), LOC);
+           }
       }
 
    Z->set_default(B);
@@ -253,6 +299,7 @@ Value_P Z(shape_Z, LOC);
 Token
 Bif_F12_INDEX_OF::eval_B(Value_P B)
 {
+   if (B->is_lazy())        B->materialize();
    if (B->get_rank() > 1)   RANK_ERROR;
 
 const APL_Integer qio = Workspace::get_IO();
@@ -265,13 +312,10 @@ const ShapeItem ec = B->element_count();
         const APL_Integer len = B->get_ravel(0).get_near_int();
         if (len < 0)   DOMAIN_ERROR;
 
-        Value_P Z(len, LOC);
-
-        loop(z, len)   new (Z->next_ravel()) IntCell(qio + z);
-
-        Z->set_default_Zero();
-        Z->check_value(LOC);
-        return Token(TOK_APL_VALUE1, Z);
+        // a long Z is lazy: its ravel is only computed if it is used by
+        // functions that cannot handle lazy values (like ⍴ or ↑ can).
+        //
+        return Token(TOK_APL_VALUE1, Value::progression(len, qio, 1, LOC));
       }
 
    // generalized ⍳B a la Dyalog APL...
@@ -329,11 +373,32 @@ const APL_Integer qio = Workspace::get_IO();
    //
    if (!A->is_scalar_or_vector())   RANK_ERROR;
 
+   if (B->is_lazy())   B->materialize();
+
 const uint64_t len_A  = A->element_count();
 const uint64_t len_BZ = B->element_count();
 
 Value_P Z(B->get_shape(), LOC);
 
+   if (A->is_lazy())
+      {
+        if (lazy_searchable(*B))   // (⍳N)⍳B: compute the positions
+           {
+             loop(bz, len_BZ)
+                {
+                  const ShapeItem pos = lazy_position(*A, B->get_ravel(bz),
+                                                      qct);
+                  new (Z->next_ravel()) IntCell(qio + (pos < 0 ? len_A : pos));
+                }
+
+             Z->set_default_Zero();
+             Z->check_value(LOC);
+             return Token(TOK_APL_VALUE1, Z);
+           }
+
+        A->materialize();
+      }
+
    loop(bz, len_BZ)
        {
          const Cell & cell_B = B->get_ravel(bz);
@@ -356,6 +421,56 @@ Value_P Z(B->get_shape(), LOC);
    return Token(TOK_APL_VALUE1, Z);
 }
 //-----------------------------------------------------------------------------
+bool
+Bif_F12_INDEX_OF::lazy_searchable(const Value & B)
+{
+   // lazy_position() finds integers, characters, and floats that are not
+   // too large (so that only the nearest integer can be equal to them).
+   //
+const ShapeItem len_B = B.element_count();
+   loop(b, len_B)
+      {
+        const Cell & cell = B.get_ravel(b);
+        if (cell.is_integer_cell())     continue;
+        if (cell.is_character_cell())   continue;
+        if (cell.is_float_cell() &&
+            cell.get_real_value() <  1e12 &&
+            cell.get_real_value() > -1e12)   continue;
+        return false;
+      }
+
+   return true;
+}
+//-----------------------------------------------------------------------------
+ShapeItem
+Bif_F12_INDEX_OF::lazy_position(const Value & A, const Cell & cell,
+                                APL_Float qct)
+{
+   // A is start + step × 0...len-1 with all items within ±LAZY_MAX
+   //
+APL_Integer value;
+   if (cell.is_integer_cell())
+      {
+        value = cell.get_int_value();
+        if (value > Value::LAZY_MAX || value < -Value::LAZY_MAX)   return -1;
+      }
+   else if (cell.is_float_cell())
+      {
+        value = APL_Integer(floor(cell.get_real_value() + 0.5));
+        if (!cell.equal(IntCell(value), qct))   return -1;
+      }
+   else return -1;   // character
+
+const APL_Integer start = A.get_lazy_start();
+const APL_Integer step = A.get_lazy_step();
+const APL_Integer diff = value - start;
+   if (diff % step)   return -1;
+
+const ShapeItem pos = diff / step;
+   if (pos < 0 || pos >= A.element_count())   return -1;
+   return pos;
+}
+//-----------------------------------------------------------------------------
 Token
 Bif_COMMA::ravel(const Shape & new_shape, Value_P B)
 {
@@ -779,14 +894,14 @@ Bif_F12_COMMA::eval_B(Value_P B)
 // CERR << "*** PICKED ***" << endl;
         Cell * ptr = B->get_ravel(0).get_lval_value();
         Assert(ptr);
-        Value_P target = ptr->get_pointer_value()->get_cellrefs(LOC);
+        Value_P target = ptr->get_unshared_pointer_value(LOC)
+                            ->get_cellrefs(LOC);
         return eval_B(target);
       }
 
 const Shape shape_Z(B->element_count());
 
-   if (B->get_owner_count() == 2 && 
-       this == Workspace::SI_top()->get_prefix().get_monadic_fun())
+   if (is_temp_argument(*B, 1, false))
       {
         Log(LOG_optimization)
            CERR << "optimizing ,B (len="
@@ -842,8 +957,7 @@ ShapeItem c2 = 1;   // assume B is scalar;
       }
 
 Shape shape_Z(c1, c2);
-   if (B->get_owner_count() == 2 && 
-       this == Workspace::SI_top()->get_prefix().get_monadic_fun())
+   if (is_temp_argument(*B, 1, false))
       {
         Log(LOG_optimization) CERR << "optimizing ,B" << endl;
 
@@ -865,6 +979,10 @@ Bif_F12_COMMA1::eval_AXB(Value_P A, Value_P X, Value_P B)
    return Bif_F12_COMMA::fun->eval_AXB(A, X, B);
 }
 //-----------------------------------------------------------------------------
+extern void divide_matrix(Cell * cZ, bool need_complex,
+                          ShapeItem rows, ShapeItem cols_A, const Cell * cA,
+                          ShapeItem cols_B, const Cell * cB);
+
 Token
 Bif_F12_DOMINO::eval_B(Value_P B)
 {
@@ -922,22 +1040,20 @@ const ShapeItem rows = B->get_shape_item(0);
 const ShapeItem cols = B->get_shape_item(1);
    if (cols > rows)   LENGTH_ERROR;
 
-   // create an identity matrix I and call eval_AB(I, B).
+   // ⌹B is I⌹B for the identity matrix I, which divide_matrix() creates
+   // itself (as numbers rather than as cells of an APL value).
    //
-const Shape shape_I(rows, rows);
-Value_P I(shape_I, LOC);
+const Shape shape_Z(cols, rows);
+Value_P Z(shape_Z, LOC);
+   divide_matrix(&Z->get_ravel(0), B->is_complex(),
+                 rows, rows, 0, cols, &B->get_ravel(0));
 
-   loop(r, rows)
-   loop(c, rows)
-       new (I->next_ravel()) FloatCell((c == r) ? 1.0 : 0.0);
+   Z->set_default(*B.get());
 
-Token result = eval_AB(I, B);
-   return result;
+   Z->check_value(LOC);
+   return Token(TOK_APL_VALUE1, Z);
 }
 //-----------------------------------------------------------------------------
-extern void divide_matrix(Cell * cZ, bool need_complex,
-                          ShapeItem rows, ShapeItem cols_A, const Cell * cA,
-                          ShapeItem cols_B, const Cell * cB, ShapeItem nB2);
 
 Token
 Bif_F12_DOMINO::eval_AB(Value_P A, Value_P B)
@@ -986,11 +1102,10 @@ ShapeItem cols_B = 1;
    if (rows_A != rows_B)   LENGTH_ERROR;
 
 const bool need_complex = A->is_complex() || B->is_complex();
-const ShapeItem nB2 = rows_B > cols_B ? rows_B : cols_B;
 Value_P Z(shape_Z, LOC);
    divide_matrix(&Z->get_ravel(0), need_complex,
                  rows_A, cols_A, &A->get_ravel(0),
-                 cols_B, &B->get_ravel(0), nB2);
+                 cols_B, &B->get_ravel(0));
 
    Z->set_default(*B.get());
 
@@ -1030,15 +1145,29 @@ const Shape3 shape_B3(B->get_shape(), axis);
 
 Value_P Z(B->get_shape(), LOC);
 
+   // reverse the m blocks of l cells in every h
+   //
+const ShapeItem len_l = shape_B3.l();
+const Cell * cB = &B->get_ravel(0);
+Cell * cZ = &Z->get_ravel(0);
+
    loop(h, shape_B3.h())
-   loop(l, shape_B3.l())
        {
-         const uint32_t hl = h * shape_B3.m() * shape_B3.l() + l;
-         const Cell * cB = &B->get_ravel(hl);
-         Cell * cZ = &Z->get_ravel(hl);
-         loop(m, shape_B3.m())
-            cZ[m*shape_B3.l()]
-               .init(cB[(shape_B3.m() - m - 1)*shape_B3.l()], Z.getref(), LOC);
+         cB += shape_B3.m() * len_l;
+         if (len_l == 1)   // single cells: nothing to gain from runs
+            {
+              loop(m, shape_B3.m())   cZ++->init(*--cB, Z.getref(), LOC);
+            }
+         else
+            {
+              loop(m, shape_B3.m())
+                 {
+                   cB -= len_l;
+                   Cell::copy_ravel(cZ, cB, len_l, Z.getref());
+                   cZ += len_l;
+                 }
+            }
+         cB += shape_B3.m() * len_l;
        }
 
    Z->set_default(*B.get());
@@ -1073,6 +1202,34 @@ const Shape shape_A2(shape_B3.h(), shape_B3.l());
 
 Value_P Z(B->get_shape(), LOC);
 
+   if (gsh || shape_B3.l() == 1)
+      {
+        // every h is rotated by the same amount: copy its last m - sh
+        // and then its first sh blocks of l cells
+        //
+        const ShapeItem len_m = shape_B3.m();
+        const ShapeItem len_l = shape_B3.l();
+        Cell * cZ = &Z->get_ravel(0);
+        loop(h, shape_B3.h())
+            {
+              if (len_m == 0)   break;
+              ShapeItem sh = gsh ? gsh : A->get_ravel(h).get_near_int();
+              sh %= len_m;
+              if (sh < 0)   sh += len_m;
+
+              const Cell * cB = &B->get_ravel(h*len_m*len_l);
+              Cell::copy_ravel(cZ, cB + sh*len_l, (len_m - sh)*len_l,
+                               Z.getref());
+              cZ += (len_m - sh)*len_l;
+              Cell::copy_ravel(cZ, cB, sh*len_l, Z.getref());
+              cZ += sh*len_l;
+            }
+
+        Z->set_default(*B.get());
+        Z->check_value(LOC);
+        return Token(TOK_APL_VALUE1, Z);
+      }
+
    loop(h, shape_B3.h())
    loop(m, shape_B3.m())
    loop(l, shape_B3.l())
@@ -1313,6 +1470,8 @@ ShapeItem rho[MAX_RANK];
    return true;
 }
 //=============================================================================
+Bif_F12_DECODE::PJob_decode Bif_F12_DECODE::decode_job;
+
 Token
 Bif_F12_DECODE::eval_AB(Value_P A, Value_P B)
 {
@@ -1343,73 +1502,214 @@ const ShapeItem l_len_B = shape_B1.get_volume();
 
    if ((l_len_A != 1) && (h_len_B != 1) && (l_len_A != h_len_B))   LENGTH_ERROR;
 
-const APL_Float qct = Workspace::get_CT();
-
 const Shape shape_Z = shape_A1 + shape_B1;
 
 Value_P Z(shape_Z, LOC);
 
-const Cell * cA = &A->get_ravel(0);
+PJob_decode & job = decode_job;
+   job.cZ      = &Z->get_ravel(0);
+   job.cA      = &A->get_ravel(0);
+   job.cB      = &B->get_ravel(0);
+   job.l_len_A = l_len_A;
+   job.h_len_B = h_len_B;
+   job.l_len_B = l_len_B;
+   job.qct     = Workspace::get_CT();
+
+   // if all items of B are integers then rows of A with integer weights
+   // can be decoded without overflow checks (see int_weights()).
+   //
+   job.int_B = true;
+   job.max_B = 0.0;
+   loop(b, B->element_count())
+      {
+        const Cell & cell = job.cB[b];
+        if (cell.get_cell_type() != CT_INT)   { job.int_B = false;   break; }
+
+        const APL_Float mag = fabs(APL_Float(cell.get_int_value()));
+        if (job.max_B < mag)   job.max_B = mag;
+      }
+
+const ShapeItem len_Z = h_len_A * l_len_B;
+const ShapeItem len = (l_len_A == 1) ? h_len_B : l_len_A;
+
+   if (len_Z == 0)   ;   // empty ¯1↓ρA or 1↓ρB
+#if PARALLEL_ENABLED
+   else if (  Parallel::run_parallel
+           && Thread_context::get_active_core_count() > 1
+           && len_Z * len > PARALLEL_ITEMS
+           && len_Z > get_dyadic_threshold())
+      {
+        const CoreCount cores = Thread_context::get_active_core_count();
+        Thread_context::M_distribute(len_Z, cores);
+        Thread_context::do_work = PF_decode;
+        Thread_context::M_fork("decode");   // start pool
+        PF_decode(Thread_context::get_master());
+        Thread_context::M_join();
+      }
+#endif // PARALLEL_ENABLED
+   else
+      {
+        Thread_context::M_distribute(len_Z, CCNT_1);
+        PF_decode(Thread_context::get_master());
+      }
+
+   Z->set_default(*B.get());
+   Z->check_value(LOC);
+   return Token(TOK_APL_VALUE1, Z);
+}
+//-----------------------------------------------------------------------------
+void
+Bif_F12_DECODE::PF_decode(Thread_context & tctx)
+{
+const PJob_decode & job = decode_job;
+ShapeItem z, end_z;
+
+   while (tctx.PF_next_range(z, end_z))
+      {
+        while (z < end_z)
+           {
+             // the items of Z from z on in the same row of A
+             // (at most BLOCK_LEN)
+             //
+             const ShapeItem h = z / job.l_len_B;
+             const ShapeItem l = z - h*job.l_len_B;
+             ShapeItem count = job.l_len_B - l;
+             if (count > end_z - z)   count = end_z - z;
+             if (count > BLOCK_LEN)   count = BLOCK_LEN;
+
+             decode_block(h, l, count);
+             z += count;
+           }
+      }
+}
+//-----------------------------------------------------------------------------
+void
+Bif_F12_DECODE::decode_block(ShapeItem h, ShapeItem l, ShapeItem count)
+{
+const PJob_decode & job = decode_job;
+const ShapeItem l_len_A = job.l_len_A;
+const ShapeItem h_len_B = job.h_len_B;
+const ShapeItem l_len_B = job.l_len_B;
+const Cell * cA = job.cA + h*l_len_A;
+const Cell * cB = job.cB + l;
+Cell * cZ = job.cZ + h*l_len_B + l;
+
+APL_Integer weights[MAX_WEIGHTS];
+   if (job.int_B && int_weights(weights, cA))
+      {
+        // Z[i] is the sum of weights[r] × B[r;l+i]. Sum up the rows of B
+        // so that the inner loop runs over adjacent items.
+        //
+        const ShapeItem len = (l_len_A == 1) ? h_len_B : l_len_A;
+        const ShapeItem dB = (h_len_B == 1) ? 0 : l_len_B;
+        APL_Integer sum[BLOCK_LEN];
+        loop(i, count)   sum[i] = 0;
 
-   loop(h, h_len_A)
+        loop(r, len)
+           {
+             const APL_Integer weight = weights[r];
+             if (weight == 0)   continue;
+
+             const Cell * row = cB + r*dB;
+             loop(i, count)
+                 sum[i] += weight * *(const APL_Integer *)row[i].get_u0();
+           }
+
+        loop(i, count)   new (cZ + i)   IntCell(sum[i]);
+        return;
+      }
+
+   // cA ... cA + len_A are used. See if they are complex.
+   //
+bool complex_A = false;
+bool integer_A = true;
+   loop(aa, l_len_A)
        {
-         // cA ... cA + len_A are used. See if they are complex.
-         //
-         bool complex_A = false;
-         bool integer_A = true;
-         loop(aa, l_len_A)
-             {
-                if (!cA[aa].is_near_real())
-                   {
-                     complex_A = true;
-                     integer_A = false;
-                     break;
-                   }
-
-                if (!cA[aa].is_near_int())   integer_A = false;
-             }
+         if (!cA[aa].is_near_real())
+            {
+              complex_A = true;
+              integer_A = false;
+              break;
+            }
 
-         loop(l, l_len_B)
+         if (!cA[aa].is_near_int())   integer_A = false;
+       }
+
+   loop(i, count)
+       {
+         // cB, cB + l_len_B, ... are used. See if they are complex
+         //
+         bool complex_B = false;
+         bool integer_B = true;
+         loop(bb, h_len_B)
              {
-                // cB, cB + l_len_B, ... are used. See if they are complex
-                //
-                bool complex_B = false;
-                bool integer_B = true;
-                loop(bb, h_len_B)
-                    {
-                      if (!B->get_ravel(l + bb*l_len_B).is_near_real())
-                         {
-                           complex_B = true;
-                           integer_B = false;
-                           break;
-                         }
-
-                      if (!B->get_ravel(l + bb*l_len_B).is_near_int())
-                         integer_B = false;
-                    }
-
-               const Cell * cB = &B->get_ravel(l);
-               Cell * cZ = Z->next_ravel();
-               if (integer_A && integer_B)
+               const Cell & cell_B = cB[i + bb*l_len_B];
+               if (!cell_B.is_near_real())
                   {
-                    const bool overflow = decode_int(cZ, l_len_A, cA,
-                                                     h_len_B, cB, l_len_B);
-                     if (!overflow)   continue;
-
-                     // otherwise: compute as float
+                    complex_B = true;
+                    integer_B = false;
+                    break;
                   }
 
-               if (complex_A || complex_B)
-                  decode_complex(cZ, l_len_A, cA, h_len_B, cB, l_len_B, qct);
-               else
-                  decode_real(cZ, l_len_A, cA, h_len_B, cB, l_len_B, qct);
+               if (!cell_B.is_near_int())   integer_B = false;
              }
-         cA += l_len_A;
+
+         if (integer_A && integer_B)
+            {
+              const bool overflow = decode_int(cZ + i, l_len_A, cA,
+                                               h_len_B, cB + i, l_len_B);
+              if (!overflow)   continue;
+
+              // otherwise: compute as float
+            }
+
+         if (complex_A || complex_B)
+            decode_complex(cZ + i, l_len_A, cA, h_len_B, cB + i, l_len_B,
+                           job.qct);
+         else
+            decode_real(cZ + i, l_len_A, cA, h_len_B, cB + i, l_len_B,
+                        job.qct);
        }
+}
+//-----------------------------------------------------------------------------
+bool
+Bif_F12_DECODE::int_weights(APL_Integer * weights, const Cell * cA)
+{
+const PJob_decode & job = decode_job;
+const ShapeItem l_len_A = job.l_len_A;
+const ShapeItem len = (l_len_A == 1) ? job.h_len_B : l_len_A;
+   if (len > MAX_WEIGHTS)   return false;
 
-   Z->set_default(*B.get());
-   Z->check_value(LOC);
-   return Token(TOK_APL_VALUE1, Z);
+   loop(aa, l_len_A)
+      {
+        if (cA[aa].get_cell_type() != CT_INT)   return false;
+      }
+
+   // weights[r] is the product of the items of A right of r (scalar
+   // extended if A has only one item). Like decode_int(), give up if a
+   // weight is out of range.
+   //
+APL_Integer weight = 1;
+APL_Float weight_f = 1.0;
+APL_Float sum_f = 0.0;   // the sum of all weights (magnitudes)
+   for (ShapeItem r = len - 1; r >= 0; --r)
+       {
+         if (weight_f > LARGE_INT)   return false;
+         if (weight_f < SMALL_INT)   return false;
+
+         weights[r] = weight;
+         sum_f += fabs(weight_f);
+         if (r == 0)   break;   // the leftmost item of A is not used
+
+         const APL_Integer a = cA[(l_len_A == 1) ? 0 : r].get_int_value();
+         weight   *= a;
+         weight_f *= a;
+       }
+
+   // the items of Z (and all partial sums) are at most sum_f × max_B. If
+   // that is (well) below LARGE_INT then no item of Z can overflow.
+   //
+   return sum_f * job.max_B < 0.5*LARGE_INT;
 }
 //-----------------------------------------------------------------------------
 bool
@@ -1502,6 +1802,8 @@ const ShapeItem len = (len_A == 1) ? len_B : len_A;
       new (cZ)   FloatCell(value.real());
 }
 //-----------------------------------------------------------------------------
+Bif_F12_ENCODE::PJob_encode Bif_F12_ENCODE::encode_job;
+
 Token
 Bif_F12_ENCODE::eval_AB(Value_P A, Value_P B)
 {
@@ -1526,44 +1828,72 @@ const APL_Float qct = Workspace::get_CT();
 const Shape shape_Z = A->get_shape() + B->get_shape();
 const ShapeItem dZ = shape_Z.get_volume()/shape_Z.get_shape_item(0);
 
-Value_P Z(shape_Z, LOC);
-
+   // find largest Celltype in every column a1 of A. Integer columns
+   // whose items are so small that ⎕CT plays no role in B∣A (see
+   // IntCell::bif_residue()) can be encoded with integer arithmetic.
+   //
+DynArray(CellType, col_type, al);
+DynArray(bool, col_int, al);
    loop(a1, al)
       {
-        const Cell * cB = &B->get_ravel(0);
-
-        // find largest Celltype in a1...
-        //
         CellType ct_a1 = CT_INT;
+        APL_Float max_a1 = 0.0;
         loop(h, ah)
             {
-              const CellType ct = A->get_ravel(a1 + h*al).get_cell_type();
-              if (ct == CT_INT)            ;
+              const Cell & cell_A = A->get_ravel(a1 + h*al);
+              const CellType ct = cell_A.get_cell_type();
+              if (ct == CT_INT)
+                 {
+                   const APL_Float mag = fabs(APL_Float(cell_A.get_int_value()));
+                   if (max_a1 < mag)   max_a1 = mag;
+                 }
               else if (ct == CT_FLOAT)     { if (ct_a1 == CT_INT)  ct_a1 = ct; }
               else if (ct == CT_COMPLEX)   ct_a1 = CT_COMPLEX;
               else                         DOMAIN_ERROR;
             }
 
-        loop(b, ec_B)
-            {
-              CellType ct = ct_a1;
-              const CellType ct_b = cB->get_cell_type();
-              if (ct_b == CT_INT)            ;
-              else if (ct_b == CT_FLOAT)     { if (ct == CT_INT)  ct = ct_b; }
-              else if (ct_b == CT_COMPLEX)   ct = CT_COMPLEX;
-              else                           DOMAIN_ERROR;
-
-              if (ct == CT_INT)   // both cells are integer
-                 encode(dZ, Z->next_ravel(), ah, al,
-                        &A->get_ravel(a1), cB++->get_int_value());
-              else if (ct == CT_FLOAT)
-                 encode(dZ, Z->next_ravel(), ah, al,
-                        &A->get_ravel(a1), cB++->get_real_value(), qct);
-              else
-                 encode(dZ, Z->next_ravel(), ah, al,
-                        &A->get_ravel(a1), cB++->get_complex_value(), qct);
-            }
-       }
+        col_type[a1] = ct_a1;
+        col_int[a1] = ct_a1 == CT_INT && max_a1*qct < 0.25;
+      }
+
+   loop(b, ec_B)
+      {
+        if (!B->get_ravel(b).is_numeric())   DOMAIN_ERROR;
+      }
+
+Value_P Z(shape_Z, LOC);
+
+PJob_encode & job = encode_job;
+   job.cZ       = &Z->get_ravel(0);
+   job.cA       = &A->get_ravel(0);
+   job.cB       = &B->get_ravel(0);
+   job.ah       = ah;
+   job.al       = al;
+   job.ec_B     = ec_B;
+   job.dZ       = dZ;
+   job.qct      = qct;
+   job.col_type = col_type.get_data();
+   job.col_int  = col_int.get_data();
+
+#if PARALLEL_ENABLED
+   if (  Parallel::run_parallel
+      && Thread_context::get_active_core_count() > 1
+      && dZ * ah > PARALLEL_ITEMS
+      && dZ > get_dyadic_threshold())
+      {
+        const CoreCount cores = Thread_context::get_active_core_count();
+        Thread_context::M_distribute(dZ, cores);
+        Thread_context::do_work = PF_encode;
+        Thread_context::M_fork("encode");   // start pool
+        PF_encode(Thread_context::get_master());
+        Thread_context::M_join();
+      }
+   else
+#endif // PARALLEL_ENABLED
+      {
+        Thread_context::M_distribute(dZ, CCNT_1);
+        PF_encode(Thread_context::get_master());
+      }
 
    Z->set_default(*B.get());
 
@@ -1572,6 +1902,121 @@ Value_P Z(shape_Z, LOC);
 }
 //-----------------------------------------------------------------------------
 void
+Bif_F12_ENCODE::PF_encode(Thread_context & tctx)
+{
+const PJob_encode & job = encode_job;
+ShapeItem j, end_j;   // j = a1×ec_B + b
+
+   while (tctx.PF_next_range(j, end_j))
+      {
+        while (j < end_j)
+           {
+             // the items of B from b on with the same column a1 of A
+             // (at most BLOCK_LEN)
+             //
+             const ShapeItem a1 = j / job.ec_B;
+             const ShapeItem b = j - a1*job.ec_B;
+             ShapeItem count = job.ec_B - b;
+             if (count > end_j - j)   count = end_j - j;
+             if (count > BLOCK_LEN)   count = BLOCK_LEN;
+
+             encode_block(a1, b, count);
+             j += count;
+           }
+      }
+}
+//-----------------------------------------------------------------------------
+void
+Bif_F12_ENCODE::encode_block(ShapeItem a1, ShapeItem b, ShapeItem count)
+{
+const PJob_encode & job = encode_job;
+const ShapeItem al = job.al;
+const ShapeItem dZ = job.dZ;
+const Cell * cA = job.cA + a1;
+const Cell * cB = job.cB + b;
+Cell * cZ = job.cZ + a1*job.ec_B + b;
+
+   // integer column a1 and integer B: encode all items of the block
+   // digit by digit (from the last row of A to the first).
+   //
+   if (job.col_int[a1])
+      {
+        APL_Integer rest[BLOCK_LEN];
+        bool int_B = true;
+        loop(i, count)
+           {
+             if (cB[i].get_cell_type() != CT_INT)   { int_B = false;   break; }
+             rest[i] = *(const APL_Integer *)cB[i].get_u0();
+
+             // large B could be tolerantly divisible by A (as a float)
+             if (job.qct != 0.0 &&
+                 (rest[i] > 0x10000000000000LL || rest[i] < -0x10000000000000LL))
+                { int_B = false;   break; }
+           }
+
+        if (int_B)
+           {
+             for (ShapeItem h = job.ah - 1; h >= 0; --h)
+                 {
+                   const APL_Integer a = cA[h*al].get_int_value();
+                   Cell * cZh = cZ + h*dZ;
+
+                   if (a == 0)   // Z is B and the rest is 0
+                      {
+                        loop(i, count)
+                           {
+                             new (cZh + i)   IntCell(rest[i]);
+                             rest[i] = 0;
+                           }
+                      }
+                   else if (a > 0 && (a & (a - 1)) == 0)   // a = 2^shift
+                      {
+                        int shift = 0;
+                        while ((1LL << shift) != a)   ++shift;
+                        const APL_Integer mask = a - 1;
+                        loop(i, count)
+                           {
+                             new (cZh + i)   IntCell(rest[i] & mask);
+                             rest[i] >>= shift;   // floor(rest ÷ a)
+                           }
+                      }
+                   else   // B∣A as in IntCell::bif_residue()
+                      {
+                        loop(i, count)
+                           {
+                             APL_Integer z = rest[i] % a;
+                             if (a < 0)   { if (z > 0)   z += a; }
+                             else         { if (z < 0)   z += a; }
+                             new (cZh + i)   IntCell(z);
+                             rest[i] = (rest[i] - z) / a;
+                           }
+                      }
+                 }
+             return;
+           }
+      }
+
+const CellType ct_a1 = job.col_type[a1];
+   loop(i, count)
+      {
+        CellType ct = ct_a1;
+        const CellType ct_b = cB[i].get_cell_type();
+        if (ct_b == CT_INT)            ;
+        else if (ct_b == CT_FLOAT)     { if (ct == CT_INT)  ct = ct_b; }
+        else                           ct = CT_COMPLEX;
+
+        if (ct == CT_INT)   // both cells are integer
+           encode(dZ, cZ + i, job.ah, al, cA, cB[i].get_int_value());
+        else if (ct == CT_FLOAT)
+           encode(dZ, cZ + i, job.ah, al, cA, cB[i].get_real_value(),
+                  job.qct);
+        else
+           encode(dZ, cZ + i, job.ah, al, cA, cB[i].get_complex_value(),
+                  job.qct);
+      }
+}
+//-----------------------------------------------------------------------------
+void
 Bif_F12_ENCODE::encode(ShapeItem dZ, Cell * cZ, ShapeItem ah, ShapeItem al,
                        const Cell * cA, APL_Integer b)
 {
@@ -1662,6 +2107,8 @@ Token
 Bif_F12_ELEMENT::eval_B(Value_P B)
 {
    // enlist
+   if (B->is_lazy())   B->materialize();
+
 const ShapeItem len_Z = B->get_enlist_count();
 Value_P Z(len_Z, LOC);
 
@@ -1678,11 +2125,32 @@ Bif_F12_ELEMENT::eval_AB(Value_P A, Value_P B)
 {
    // member
    //
+   if (A->is_lazy())   A->materialize();
+
 const APL_Float qct = Workspace::get_CT();
 const ShapeItem len_Z = A->element_count();
 const ShapeItem len_B = B->element_count();
 Value_P Z(A->get_shape(), LOC);
 
+   if (B->is_lazy())
+      {
+        if (Bif_F12_INDEX_OF::lazy_searchable(*A))   // A∊⍳N
+           {
+             loop(z, len_Z)
+                {
+                  const ShapeItem pos =
+                     Bif_F12_INDEX_OF::lazy_position(*B, A->get_ravel(z), qct);
+                  new (Z->next_ravel())   IntCell(pos < 0 ? 0 : 1);
+                }
+
+             Z->set_default_Zero();
+             Z->check_value(LOC);
+             return Token(TOK_APL_VALUE1, Z);
+           }
+
+        B->materialize();
+      }
+
    loop(z, len_Z)
        {
          const Cell & cell_A = A->get_ravel(z);
@@ -1979,10 +2447,10 @@ const ShapeItem llen = item_shape.get_volume();
             }
          else if (B_item.is_lval_cell())
             {
-              const Cell & pointee = *B_item.get_lval_value();
+              Cell & pointee = *B_item.get_lval_value();
                if (pointee.is_pointer_cell())   // pointer to nested
                   {
-                    Value_P vB = pointee.get_pointer_value();
+                    Value_P vB = pointee.get_unshared_pointer_value(LOC);
                     Value_P ref_B = vB->get_cellrefs(LOC);
                     Bif_F12_TAKE::fill(item_shape, Z_from, Z.getref(), ref_B);
                   }
@@ -2269,7 +2737,7 @@ const Cell * cB = &B->get_ravel(c);
              Cell & cell = *cB->get_lval_value();
              if (!cell.is_pointer_cell())   DOMAIN_ERROR;
 
-             Value_P subval = cell.get_pointer_value();
+             Value_P subval = cell.get_unshared_pointer_value(LOC);
              Value_P subrefs = subval->get_cellrefs(LOC);
              Value * sub_cellowner = subrefs->get_lval_cellowner();
              Assert(sub_cellowner);
@@ -2493,6 +2961,14 @@ Token result = Bif_F12_PICK::fun->eval_XB(X, cT);
 Token
 Bif_F12_TAKE::eval_AB(Value_P A, Value_P B)
 {
+   if (A->is_lazy())   A->materialize();
+   if (B->is_lazy())
+      {
+        Value_P Z = lazy_take(A, B, false);
+        if (!!Z)   return Token(TOK_APL_VALUE1, Z);
+        B->materialize();
+      }
+
 Shape ravel_A1(A, /* ⎕IO */ 0);   // checks that 1 ≤ ⍴⍴A and ⍴A ≤ MAX_RANK
 
    if (B->is_scalar())
@@ -2510,6 +2986,30 @@ Shape ravel_A1(A, /* ⎕IO */ 0);   // checks that 1 ≤ ⍴⍴A and ⍴A ≤ MA
       }
 }
 //-----------------------------------------------------------------------------
+Value_P
+Bif_F12_TAKE::lazy_take(Value_P A, Value_P B, bool drop)
+{
+   // B is a lazy vector. If A is a single integer and the result has no
+   // fill items then the result is a (lazy) part of B.
+   //
+   if (A->get_rank() > 1 || A->element_count() != 1)   return Value_P();
+
+const Cell & cell_A = A->get_ravel(0);
+   if (!cell_A.is_near_int())   return Value_P();
+
+const APL_Integer a = cell_A.get_near_int();
+const ShapeItem len_B = B->element_count();
+   if (a > len_B || a < -len_B)   return Value_P();   // overtake or drop all
+
+const ShapeItem len_a = a < 0 ? -a : a;
+const ShapeItem len_Z = drop ? len_B - len_a : len_a;
+const ShapeItem skip = (a < 0) == drop ? 0 : len_B - len_Z;
+
+   return Value::progression(len_Z, B->get_lazy_start() +
+                                    skip*B->get_lazy_step(),
+                             B->get_lazy_step(), LOC);
+}
+//-----------------------------------------------------------------------------
 Token
 Bif_F12_TAKE::do_take(const Shape shape_Zi, Value_P B)
 {
@@ -2567,13 +3067,30 @@ Shape Q;
 
 const Shape weight_B = B->get_shape().reverse_scan();
 
-   for (ArrayIterator it(shape_Z); !it.done(); ++it)
+   // Z is computed row by row (along its last axis). Every row consists
+   // of some fill items, the items [from, to) copied from a row of B, and
+   // some more fill items.
+   //
+const Rank last = shape_Z.get_rank() - 1;
+const ShapeItem len_l = shape_Z.get_last_shape_item();
+const ShapeItem rows = shape_Z.get_volume() / len_l;
+const ShapeItem Q_l = Q.get_last_shape_item();
+ShapeItem from = -Q_l;
+   if (from < 0)       from = 0;
+ShapeItem to = B->get_shape().get_last_shape_item() - Q_l;
+   if (to > len_l)     to = len_l;
+   if (to < from)      to = from;
+
+ShapeItem row_Z[MAX_RANK];   // the index of the current row
+   loop(r, last)   row_Z[r] = 0;
+
+   loop(row, rows)
       {
         ShapeItem bpos = 0;
         bool fill = false;
-        loop(r, shape_Z.get_rank())
+        loop(r, last)
             {
-              const ShapeItem idx_B = it.get_value(r) + Q.get_shape_item(r);
+              const ShapeItem idx_B = row_Z[r] + Q.get_shape_item(r);
               if ((idx_B <  0) || (idx_B >= B->get_shape_item(r)))
                  {
                    fill = true;
@@ -2583,15 +3100,42 @@ const Shape weight_B = B->get_shape().reverse_scan();
               bpos += weight_B.get_shape_item(r) * idx_B;
             }
 
-        if (fill)   cZ->init_type(B->get_ravel(0), Z_owner, LOC);
-        else        cZ->init(B->get_ravel(bpos),   Z_owner, LOC);
-        ++cZ;
+        if (fill || from == to)
+           {
+             loop(l, len_l)   cZ[l].init_type(B->get_ravel(0), Z_owner, LOC);
+           }
+        else
+           {
+             loop(l, from)   cZ[l].init_type(B->get_ravel(0), Z_owner, LOC);
+             Cell::copy_ravel(cZ + from, &B->get_ravel(bpos + Q_l + from),
+                              to - from, Z_owner);
+             for (ShapeItem l = to; l < len_l; ++l)
+                 cZ[l].init_type(B->get_ravel(0), Z_owner, LOC);
+           }
+        cZ += len_l;
+
+        // next row
+        //
+        for (Rank r = last; r > 0;)
+            {
+              --r;
+              if (++row_Z[r] < shape_Z.get_shape_item(r))   break;
+              row_Z[r] = 0;
+            }
       }
 }
 //-----------------------------------------------------------------------------
 Token
 Bif_F12_DROP::eval_AB(Value_P A, Value_P B)
 {
+   if (A->is_lazy())   A->materialize();
+   if (B->is_lazy())
+      {
+        Value_P Z = Bif_F12_TAKE::lazy_take(A, B, true);
+        if (!!Z)   return Token(TOK_APL_VALUE1, Z);
+        B->materialize();
+      }
+
 Shape ravel_A(A, /* ⎕IO */ 0);
    if (A->get_rank() > 1)   RANK_ERROR;
 
@@ -75,6 +75,15 @@ protected:
    /// Print the name of \b this PrimitiveFunction to \b out
    virtual ostream & print(ostream & out) const;
 
+   /// return true if \b value, a (monadic or \b dyadic) argument of \b this
+   /// function, is a temporary that may be overridden by the result. That
+   /// is the case if \b this function is being evaluated by the prefix of
+   /// the top-level SI entry and \b value has no owners other than the
+   /// prefix (which discards it when we return) and the \b arg_owners
+   /// Value_P arguments of the functions called since then.
+   bool is_temp_argument(const Value & value, int arg_owners,
+                         bool dyadic) const;
+
    /// performance statistics for eval_B()
    CellFunctionStatistics * statistics_AB;
 
@@ -351,11 +360,17 @@ public:
 
    /// overloaded Function::eval_B()
    virtual Token eval_B(Value_P B)
-      { return Token(TOK_APL_VALUE1, first(B));}
+      { return Token(TOK_APL_VALUE1, first(B.computed()));}
 
    /// overloaded Function::eval_AB()
    virtual Token eval_AB(Value_P A, Value_P B);
 
+   /// overloaded Function::accepts_lazy()
+   virtual bool accepts_lazy() const   { return true; }
+
+   /// return N↑B or N↓B for a lazy vector B (or 0 if that is not lazy)
+   static Value_P lazy_take(Value_P A, Value_P B, bool drop);
+
    /// overloaded Function::eval_AXB()
    virtual Token eval_AXB(Value_P A, Value_P X, Value_P B);
 
@@ -393,6 +408,9 @@ public:
    /// overloaded Function::eval_AXB()
    virtual Token eval_AXB(Value_P A, Value_P X, Value_P B);
 
+   /// overloaded Function::accepts_lazy()
+   virtual bool accepts_lazy() const   { return true; }
+
    static Bif_F12_DROP * fun;   ///< Built-in function
    static Bif_F12_DROP  _fun;   ///< Built-in function
 protected:
@@ -414,6 +432,9 @@ public:
    /// overloaded Function::eval_AB()
    virtual Token eval_AB(Value_P A, Value_P B);
 
+   /// overloaded Function::accepts_lazy()
+   virtual bool accepts_lazy() const   { return true; }
+
    static Bif_F12_ELEMENT * fun;   ///< Built-in function
    static Bif_F12_ELEMENT  _fun;   ///< Built-in function
 protected:
@@ -479,17 +500,51 @@ public:
    static Bif_F12_ENCODE * fun;   ///< Built-in function
    static Bif_F12_ENCODE  _fun;   ///< Built-in function
 protected:
+   enum
+      {
+        /// results with more items are computed in parallel
+        PARALLEL_ITEMS = 10000,
+
+        /// items of B encoded at a time (with the same column of A)
+        BLOCK_LEN = 256,
+      };
+
+   /// the context for encoding B
+   struct PJob_encode
+      {
+        Cell * cZ;                   ///< result ravel
+        const Cell * cA;             ///< left argument ravel
+        const Cell * cB;             ///< right argument ravel
+        ShapeItem ah;                ///< first dimension of A
+        ShapeItem al;                ///< remaining dimensions of A
+        ShapeItem ec_B;              ///< number of items in B
+        ShapeItem dZ;                ///< distance between Z items of one b
+        double qct;                  ///< ⎕CT
+        const CellType * col_type;   ///< largest cell type of each column
+        const bool * col_int;        ///< integer column with small items
+      };
+
+   /// encode the \b count items b ... b+count-1 of B according to
+   /// column \b a1 of A
+   static void encode_block(ShapeItem a1, ShapeItem b, ShapeItem count);
+
+   /// encode the items of encode_job
+   static void PF_encode(Thread_context & tctx);
+
    /// encode b according to A (integer A and b)
-   void encode(ShapeItem dZ, Cell * cZ, ShapeItem ah, ShapeItem al,
-               const Cell * cA, APL_Integer b);
+   static void encode(ShapeItem dZ, Cell * cZ, ShapeItem ah, ShapeItem al,
+                      const Cell * cA, APL_Integer b);
 
    /// encode b according to A
-   void encode(ShapeItem dZ, Cell * cZ, ShapeItem ah, ShapeItem al,
-               const Cell * cA, APL_Float b, double qct);
+   static void encode(ShapeItem dZ, Cell * cZ, ShapeItem ah, ShapeItem al,
+                      const Cell * cA, APL_Float b, double qct);
 
    /// encode B according to A
-   void encode(ShapeItem dZ, Cell * cZ, ShapeItem ah, ShapeItem al,
-               const Cell * cA, APL_Complex b, double qct);
+   static void encode(ShapeItem dZ, Cell * cZ, ShapeItem ah, ShapeItem al,
+                      const Cell * cA, APL_Complex b, double qct);
+
+   /// the context for encoding B
+   static PJob_encode encode_job;
 };
 //-----------------------------------------------------------------------------
 /** System function decode
@@ -508,19 +563,58 @@ public:
    static Bif_F12_DECODE * fun;   ///< Built-in function
    static Bif_F12_DECODE  _fun;   ///< Built-in function
 protected:
+   enum
+      {
+        /// results with more items are computed in parallel
+        PARALLEL_ITEMS = 10000,
+
+        /// items of Z computed at a time (in the same row of A)
+        BLOCK_LEN = 256,
+
+        /// longer rows of A are not decoded with integer weights
+        MAX_WEIGHTS = 64,
+      };
+
+   /// the context for decoding B
+   struct PJob_decode
+      {
+        Cell * cZ;             ///< result ravel
+        const Cell * cA;       ///< left argument ravel
+        const Cell * cB;       ///< right argument ravel
+        ShapeItem l_len_A;     ///< last dimension of A
+        ShapeItem h_len_B;     ///< first dimension of B
+        ShapeItem l_len_B;     ///< remaining dimensions of B
+        double qct;            ///< ⎕CT
+        bool int_B;            ///< all items of B are integers
+        double max_B;          ///< largest magnitude of B (if int_B)
+      };
+
+   /// compute the \b count items l ... l+count-1 of row \b h of Z
+   static void decode_block(ShapeItem h, ShapeItem l, ShapeItem count);
+
+   /// store the weights of row \b cA of A into \b weights and return
+   /// true if they are integers and no item of Z can overflow
+   static bool int_weights(APL_Integer * weights, const Cell * cA);
+
+   /// decode the items of decode_job
+   static void PF_decode(Thread_context & tctx);
+
    /// decode B according to len_A and cA (integer A, B and Z)
-   bool decode_int(Cell * cZ, ShapeItem len_A, const Cell * cA,
-                   ShapeItem len_B, const Cell * cB, ShapeItem dB);
+   static bool decode_int(Cell * cZ, ShapeItem len_A, const Cell * cA,
+                          ShapeItem len_B, const Cell * cB, ShapeItem dB);
 
    /// decode B according to len_A and cA (real A and B)
-   void decode_real(Cell * cZ, ShapeItem len_A, const Cell * cA,
-                    ShapeItem len_B, const Cell * cB, ShapeItem dB,
-                    double qct);
+   static void decode_real(Cell * cZ, ShapeItem len_A, const Cell * cA,
+                           ShapeItem len_B, const Cell * cB, ShapeItem dB,
+                           double qct);
 
    /// decode B according to len_A and cA (complex A or B)
-   void decode_complex(Cell * cZ, ShapeItem len_A, const Cell * cA,
-                       ShapeItem len_B, const Cell * cB, ShapeItem dB,
-                       double qct);
+   static void decode_complex(Cell * cZ, ShapeItem len_A, const Cell * cA,
+                              ShapeItem len_B, const Cell * cB, ShapeItem dB,
+                              double qct);
+
+   /// the context for decoding B
+   static PJob_decode decode_job;
 };
 //-----------------------------------------------------------------------------
 /** primitive functions matrix divide and matrix invert
@@ -685,6 +779,17 @@ public:
    /// overloaded Function::eval_AB()
    virtual Token eval_AB(Value_P A, Value_P B);
 
+   /// overloaded Function::accepts_lazy()
+   virtual bool accepts_lazy() const   { return true; }
+
+   /// return true if lazy_position() can find all items of B
+   static bool lazy_searchable(const Value & B);
+
+   /// return the position of \b cell in the lazy vector \b A, or -1 if
+   /// \b cell is not an item of A
+   static ShapeItem lazy_position(const Value & A, const Cell & cell,
+                                  APL_Float qct);
+
    static Bif_F12_INDEX_OF * fun;   ///< Built-in function
    static Bif_F12_INDEX_OF  _fun;   ///< Built-in function
 
@@ -707,6 +812,9 @@ public:
    /// overloaded Function::eval_AB()
    virtual Token eval_AB(Value_P A, Value_P B);
 
+   /// overloaded Function::accepts_lazy()
+   virtual bool accepts_lazy() const   { return true; }
+
    /// Reshape B according to rank and shape
    static Token do_reshape(const Shape & shape, const Value & B);
 
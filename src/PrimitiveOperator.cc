@@ -23,6 +23,8 @@
 #include "IndexIterator.hh"
 #include "CharCell.hh"
 #include "ComplexCell.hh"
+#include "DerivedFunction.hh"
+#include "Error.hh"
 #include "FloatCell.hh"
 #include "IntCell.hh"
 #include "LvalCell.hh"
@@ -31,6 +33,8 @@
 #include "Value.icc"
 #include "Workspace.hh"
 
+PrimitiveOperator::PJob_items PrimitiveOperator::items_job;
+
 //-----------------------------------------------------------------------------
 Token
 PrimitiveOperator::fill(const Shape shape_Z, Value_P A, Function * fun,
@@ -57,3 +61,184 @@ Value_P Z1(shape_Z, LOC);   // shape_Z is empty
    return Token(TOK_APL_VALUE1, Z1);
 }
 //-----------------------------------------------------------------------------
+bool
+PrimitiveOperator::items_parallel(Function * fun, bool dyadic)
+{
+#if PARALLEL_ENABLED && !defined(VALUE_HISTORY_WANTED)
+   if (!Parallel::run_parallel)                            return false;
+   if (Thread_context::get_active_core_count() < 2)        return false;
+   if (fun->may_push_SI())                                 return false;
+
+   // derived functions: only scalar reductions like +/ or ⌈⌿
+   //
+   if (fun->is_derived())
+      return !dyadic && static_cast<DerivedFunction *>(fun)
+                                       ->is_scalar_reduction();
+
+   // primitive functions: only structural functions. Scalar functions are
+   // excluded because they use the thread pool (and static job lists).
+   //
+   switch(fun->get_token().get_tag())
+      {
+        case TOK_F12_COMMA:
+        case TOK_F12_COMMA1:
+        case TOK_F12_DROP:
+        case TOK_F12_EQUIV:
+        case TOK_F12_PICK:
+        case TOK_F12_RHO:
+        case TOK_F12_ROTATE:
+        case TOK_F12_ROTATE1:
+        case TOK_F12_TAKE:
+             return true;
+
+        case TOK_F12_ELEMENT:
+        case TOK_F12_PARTITION:
+        case TOK_F12_SORT_ASC:
+        case TOK_F12_SORT_DES:
+        case TOK_F12_TRANSPOSE:
+             return !dyadic;
+
+        default: return false;
+      }
+#else
+   return false;
+#endif
+}
+//-----------------------------------------------------------------------------
+void
+PrimitiveOperator::eval_items_parallel(Value * Z, Function * fun,
+                                       const Value * A, ShapeItem A_div,
+                                       ShapeItem A_inc, const Value * B,
+                                       ShapeItem B_mod, ShapeItem B_inc,
+                                       bool from_value)
+{
+const ShapeItem len_Z = Z->element_count();
+
+   // initialize Z so that it can be released properly if an item fails.
+   //
+   loop(z, len_Z)   new (&Z->get_ravel(z)) IntCell(0);
+   Z->set_complete();
+
+   items_job.fun         = fun;
+   items_job.Z           = Z;
+   items_job.A           = A;
+   items_job.A_div       = A_div;
+   items_job.A_inc       = A_inc;
+   items_job.B           = B;
+   items_job.B_mod       = B_mod;
+   items_job.B_inc       = B_inc;
+   items_job.from_value  = from_value;
+   items_job.simple_only = fun->is_derived();
+   items_job.ec          = E_NO_ERROR;
+   items_job.ec_core     = CNUM_MASTER;
+   items_job.deferred.clear();
+
+#if PARALLEL_ENABLED
+   // the workers create and delete values, and they shall not start
+   // parallel jobs of their own. Every core writes its own )MORE info.
+   //
+const CoreCount cores = Thread_context::get_active_core_count();
+   Workspace::init_core_more_error(cores);
+   Parallel::concurrent_values = true;
+   Parallel::run_parallel = false;
+
+   Thread_context::M_distribute(len_Z, cores);
+   Thread_context::do_work = PF_eval_items;
+   Thread_context::M_fork("eval_items");
+   PF_eval_items(Thread_context::get_master());
+   Thread_context::M_join();
+
+   Parallel::run_parallel = true;
+   Parallel::concurrent_values = false;
+   if (items_job.ec != E_NO_ERROR)
+      Workspace::take_core_more_error(items_job.ec_core);
+#else
+   Thread_context::M_distribute(len_Z, CCNT_1);
+   PF_eval_items(Thread_context::get_master());
+#endif
+
+   // compute the items that the workers have left to the master
+   //
+   loop(d, items_job.deferred.size())
+      {
+        if (items_job.ec != E_NO_ERROR)   break;
+        eval_item(items_job.deferred[d], 0);
+      }
+
+   if (items_job.ec != E_NO_ERROR)   throw_apl_error(items_job.ec, LOC);
+}
+//-----------------------------------------------------------------------------
+bool
+PrimitiveOperator::eval_item(ShapeItem z, const Thread_context * tctx)
+{
+PJob_items & job = items_job;
+const Cell & cB = job.B->get_ravel((z % job.B_mod) * job.B_inc);
+
+   if (tctx && job.simple_only && !(cB.is_simple_cell() ||
+       (cB.get_pointer_value()->is_simple() &&
+        !cB.get_pointer_value()->is_empty())))
+      {
+        POOL_LOCK(Parallel_job_list_base::parallel_jobs_lock,
+                  job.deferred.push_back(z))
+        return false;
+      }
+
+ErrorCode ec = E_NO_ERROR;
+   try
+      {
+        Value_P LO_A;
+        if (job.A)
+           LO_A = job.A->get_ravel((z / job.A_div) * job.A_inc).to_value(LOC);
+        Value_P LO_B = cB.to_value(LOC);
+
+        Token result = job.A ? job.fun->eval_AB(LO_A, LO_B)
+                             : job.fun->eval_B(LO_B);
+
+        if (result.get_Class() == TC_VALUE)
+           {
+             Value_P vZ = result.get_apl_val();
+             Cell & cZ = job.Z->get_ravel(z);
+             if (vZ->is_simple_scalar())
+                cZ.init(vZ->get_ravel(0), *job.Z, LOC);
+             else   // PointerCell: updates the (shared) counters of Z
+                POOL_LOCK(Parallel_job_list_base::parallel_jobs_lock,
+                   if (job.from_value)   cZ.init_from_value(vZ, *job.Z, LOC);
+                   else   new (&cZ) PointerCell(vZ, *job.Z))
+           }
+        else if (result.get_tag() == TOK_ERROR)
+           {
+             ec = result.get_ErrorCode();
+           }
+        else
+           {
+             ec = E_DOMAIN_ERROR;   // no value
+           }
+      }
+   catch (Error err)
+      {
+        ec = err.error_code;
+      }
+
+   if (ec != E_NO_ERROR)   // remember the first error (and its core)
+      {
+        POOL_LOCK(Parallel_job_list_base::parallel_jobs_lock,
+                  if (job.ec == E_NO_ERROR)
+                     {
+                       job.ec = ec;
+                       if (tctx)   job.ec_core = tctx->get_N();
+                     })
+      }
+
+   return true;
+}
+//-----------------------------------------------------------------------------
+void
+PrimitiveOperator::PF_eval_items(Thread_context & tctx)
+{
+ShapeItem z, end_z;
+   while (items_job.ec == E_NO_ERROR && tctx.PF_next_range(z, end_z))
+      {
+        for (; z < end_z; ++z)   eval_item(z, &tctx);
+      }
+}
+//-----------------------------------------------------------------------------
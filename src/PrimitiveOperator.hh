@@ -49,6 +49,50 @@ public:
    /// evaluate the fill function with arguments A and B
    static Token fill(const Shape shape_Z, Value_P A, Function * fun,
                      Value_P B, const char * loc);
+
+protected:
+   /// the context for evaluating the items of EACH or OUTER product in
+   /// parallel: Z[z] ← fun A[(z ÷ A_div) × A_inc] B[(z mod B_mod) × B_inc]
+   struct PJob_items
+      {
+        Function * fun;              ///< the function applied to the items
+        Value * Z;                   ///< the result
+        const Value * A;             ///< left value argument (0 if monadic)
+        ShapeItem A_div;             ///< divisor for the index into A
+        ShapeItem A_inc;             ///< increment for the index into A
+        const Value * B;             ///< right value argument
+        ShapeItem B_mod;             ///< modulus for the index into B
+        ShapeItem B_inc;             ///< increment for the index into B
+        bool from_value;             ///< use Cell::init_from_value() for Z[z]
+        bool simple_only;            ///< workers only compute simple items
+        ErrorCode ec;                ///< the first error (if any)
+        CoreNumber ec_core;          ///< the core that detected ec
+        vector<ShapeItem> deferred;  ///< items left for the master
+      };
+
+   /// return true if \b fun (with the valence given by \b dyadic) may be
+   /// evaluated by worker threads. That is the case for primitive functions
+   /// without side effects that do not use the thread pool themselves.
+   static bool items_parallel(Function * fun, bool dyadic);
+
+   /// compute all items of \b Z in parallel (see PJob_items). Throws an
+   /// APL error if the evaluation of an item failed.
+   static void eval_items_parallel(Value * Z, Function * fun,
+                                   const Value * A, ShapeItem A_div,
+                                   ShapeItem A_inc, const Value * B,
+                                   ShapeItem B_mod, ShapeItem B_inc,
+                                   bool from_value);
+
+   /// compute item \b z of items_job on the core of \b tctx, or on the
+   /// master after the workers have finished if \b tctx is 0. Return false
+   /// if a worker has left the item to the master.
+   static bool eval_item(ShapeItem z, const Thread_context * tctx);
+
+   /// the main loop (of all cores) for eval_items_parallel()
+   static void PF_eval_items(Thread_context & tctx);
+
+   /// the context for eval_items_parallel()
+   static PJob_items items_job;
 };
 //-----------------------------------------------------------------------------
 
@@ -23,6 +23,7 @@
 
 #include "Function.hh"
 #include "Output.hh"
+#include "Parallel.hh"
 #include "Performance.hh"
 #include "PointerCell.hh"
 #include "PrintBuffer.hh"
@@ -36,8 +37,13 @@ enum
    PB_MAX_ROWS        = 100,
    PB_MAX_ITEMS       = PB_MAX_COLS * PB_MAX_ROWS,
    PB_MAX_BREAKPOINTS = 200,
+
+   /// simple values with more items are formatted in parallel
+   PB_PARALLEL_ITEMS  = 4000,
 };
 
+PrintBuffer::PJob_items PrintBuffer::items_job;
+
 //-----------------------------------------------------------------------------
 PrintBuffer::PrintBuffer()
    : complete(true)
@@ -233,6 +239,19 @@ const bool nested = !value.is_simple();
      PERFORMANCE_START(start_2)
      vector<Rank> max_row_ranks;
      max_row_ranks.reserve(rows);
+
+     // large simple values: all items have height 1 and max_row_ranks
+     // are 0, so that steps 2. and 3. can be done in parallel.
+     //
+     if (!nested && ec > PB_PARALLEL_ITEMS &&
+         items_parallel(value, pctx, scaling, item_matrix))
+        {
+          if (huge && (ii_count != interrupt_count))   goto interrupted;
+          max_row_ranks.resize(rows, 0);
+          PERFORMANCE_END(fs_PrintBuffer2_B, start_2, ec)
+          goto combine;
+        }
+
      loop(y, rows)
         {
           ShapeItem max_row_height = 0;
@@ -277,28 +296,31 @@ const bool nested = !value.is_simple();
 
      // 3. align all columns (which pads them to the same width).
      //
-     PERFORMANCE_START(start_3)
-     loop(x, cols)
-        {
-          ColInfo col_info_x;
-          loop(y, rows)
-              {
-                if (huge && (ii_count != interrupt_count))   goto interrupted;
-                PrintBuffer * item_row = item_matrix + y*cols;
-                col_info_x.consider(item_row[x].get_info());
-              }
+     {
+       PERFORMANCE_START(start_3)
+       loop(x, cols)
+          {
+            ColInfo col_info_x;
+            loop(y, rows)
+                {
+                  if (huge && (ii_count != interrupt_count))   goto interrupted;
+                  PrintBuffer * item_row = item_matrix + y*cols;
+                  col_info_x.consider(item_row[x].get_info());
+                }
 
-          loop(y, rows)
-              {
-                if (huge && (ii_count != interrupt_count))   goto interrupted;
-                PrintBuffer * item_row = item_matrix + y*cols;
-                item_row[x].align(col_info_x);
-              }
-        }
-     PERFORMANCE_END(fs_PrintBuffer3_B, start_3, ec)
+            loop(y, rows)
+                {
+                  if (huge && (ii_count != interrupt_count))   goto interrupted;
+                  PrintBuffer * item_row = item_matrix + y*cols;
+                  item_row[x].align(col_info_x);
+                }
+          }
+       PERFORMANCE_END(fs_PrintBuffer3_B, start_3, ec)
+     }
 
      // 4. combine columms, then rows.
      //
+   combine:
      PERFORMANCE_START(start_4)
 
      int last_col_spacing = 0;    // the col_spacing of the previous column
@@ -445,6 +467,89 @@ interrupted:
    *out << endl << "INTERRUPT" << endl;
 }
 //-----------------------------------------------------------------------------
+bool
+PrintBuffer::items_parallel(const Value & value, const PrintContext & pctx,
+                            const bool * scaling, PrintBuffer * item_matrix)
+{
+#if PARALLEL_ENABLED
+   if (!Parallel::run_parallel)                       return false;
+   if (!Thread_context::is_master_thread())           return false;
+
+const CoreCount cores = Thread_context::get_active_core_count();
+   if (cores < 2)                                     return false;
+
+const ShapeItem ec = value.element_count();
+const ShapeItem cols = value.get_last_shape_item();
+
+   // every core computes the ColInfo of the columns for its own items.
+   // ColInfo::consider() is a maximum, so the ColInfos of the cores can
+   // then be merged in any order.
+   //
+ColInfo * col_infos = new ColInfo[cores * cols];
+
+   items_job.value       = &value;
+   items_job.pctx        = &pctx;
+   items_job.scaling     = scaling;
+   items_job.item_matrix = item_matrix;
+   items_job.cols        = cols;
+   items_job.col_infos   = col_infos;
+
+   Thread_context::M_distribute(ec, cores);
+   Thread_context::do_work = PF_compute_items;
+   Thread_context::M_fork("compute_items");
+   PF_compute_items(Thread_context::get_master());
+   Thread_context::M_join();
+
+   for (int c = 1; c < cores; ++c)
+   loop(x, cols)   col_infos[x].consider(col_infos[x + c*cols]);
+
+   Thread_context::M_distribute(ec, cores);
+   Thread_context::do_work = PF_align_items;
+   Thread_context::M_fork("align_items");
+   PF_align_items(Thread_context::get_master());
+   Thread_context::M_join();
+
+   delete [] col_infos;
+   return true;
+#else
+   return false;
+#endif
+}
+//-----------------------------------------------------------------------------
+void
+PrintBuffer::PF_compute_items(Thread_context & tctx)
+{
+const PJob_items & job = items_job;
+ColInfo * col_infos = job.col_infos + tctx.get_N() * job.cols;
+PrintContext pctx_scaled(*job.pctx);
+   pctx_scaled.set_scaled();
+
+ShapeItem z, end_z;
+   while (tctx.PF_next_range(z, end_z))
+      {
+        for (; z < end_z; ++z)
+            {
+              const ShapeItem x = z % job.cols;
+              PrintBuffer & item = job.item_matrix[z];
+              item = job.value->get_ravel(z).character_representation(
+                                job.scaling[x] ? pctx_scaled : *job.pctx);
+              col_infos[x].consider(item.get_info());
+            }
+      }
+}
+//-----------------------------------------------------------------------------
+void
+PrintBuffer::PF_align_items(Thread_context & tctx)
+{
+const PJob_items & job = items_job;
+ShapeItem z, end_z;
+   while (tctx.PF_next_range(z, end_z))
+      {
+        for (; z < end_z; ++z)
+            job.item_matrix[z].align(job.col_infos[z % job.cols]);
+      }
+}
+//-----------------------------------------------------------------------------
 void
 PrintBuffer::print_interruptible(ostream & out, Rank rank, int quad_PW)
 {
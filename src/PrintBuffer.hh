@@ -29,6 +29,7 @@
 
 class Value;
 class Cell;
+class Thread_context;
 
 //-----------------------------------------------------------------------------
 
@@ -97,6 +98,12 @@ public:
                          bool * scaling, PrintBuffer * pcols,
                          PrintBuffer * item_matrix);
 
+   /// compute (steps 2. and 3. of do_PrintBuffer()) the aligned items of
+   /// a large simple \b value in parallel. Return false if that was not
+   /// possible (and nothing was done)
+   static bool items_parallel(const Value & value, const PrintContext & pctx,
+                              const bool * scaling, PrintBuffer * item_matrix);
+
    /// PrintBuffer from an APL value in function-style
    void pb_for_function(const Value & value, PrintContext pctx,
                         PrintStyle outer_style);
@@ -207,6 +214,26 @@ protected:
    static ShapeItem separator_rows(ShapeItem y, const Value & value,
                                    bool nested, Rank rk1, Rank rk2);
 
+   /// the context for computing the items of a simple value in parallel
+   struct PJob_items
+      {
+        const Value * value;         ///< the value being printed
+        const PrintContext * pctx;   ///< the print context of the value
+        const bool * scaling;        ///< the scaling of every column
+        PrintBuffer * item_matrix;   ///< the items of value
+        ShapeItem cols;              ///< the number of columns of value
+        ColInfo * col_infos;         ///< one ColInfo per column and core
+      };
+
+   /// the current parallel job
+   static PJob_items items_job;
+
+   /// compute the items (and their per-core ColInfo) of items_job
+   static void PF_compute_items(Thread_context & tctx);
+
+   /// align the items of items_job
+   static void PF_align_items(Thread_context & tctx);
+
    /// the character buffer.
    vector<UCS_string> buffer;
 
@@ -213,16 +213,71 @@ struct PJob_scalar_AB
 /// all dyadic scalar jobs
 static Parallel_job_list<PJob_scalar_AB> joblist_AB;
 
+//-----------------------------------------------------------------------------
+/// return \b true if all ravel cells of \b value are numeric (and therefore
+/// own no resources that would leak if the cells were overwritten)
+static bool
+all_numeric(const Value & value)
+{
+const ShapeItem count = value.element_count();
+const Cell * C = &value.get_ravel(0);
+   loop(c, count)   if (!C[c].is_numeric())   return false;
+   return true;
+}
+//-----------------------------------------------------------------------------
+/// compute \b cell_Z = \b fun \b cell_B. \b cell_Z may be \b cell_B
+/// (in-place evaluation), but cell functions may read their argument after
+/// having written the result; compute into a temporary cell in that case.
+static inline ErrorCode
+eval_cell_B(Cell & cell_Z, Value & Z_owner, const Cell & cell_B, prim_f1 fun)
+{
+   if (&cell_Z != &cell_B)   return (cell_B.*fun)(&cell_Z);
+
+Cell cell_T;
+const ErrorCode ec = (cell_B.*fun)(&cell_T);
+   if (ec == E_NO_ERROR)   cell_Z.init(cell_T, Z_owner, LOC);
+   return ec;
+}
+//-----------------------------------------------------------------------------
+/// compute \b cell_Z = \b cell_A \b fun \b cell_B. \b cell_Z may be
+/// \b cell_A or \b cell_B (in-place evaluation), see eval_cell_B().
+static inline ErrorCode
+eval_cell_AB(Cell & cell_Z, Value & Z_owner, const Cell & cell_A,
+             const Cell & cell_B, prim_f2 fun)
+{
+   if (&cell_Z != &cell_A && &cell_Z != &cell_B)
+      return (cell_B.*fun)(&cell_Z, &cell_A);
+
+Cell cell_T;
+const ErrorCode ec = (cell_B.*fun)(&cell_T, &cell_A);
+   if (ec == E_NO_ERROR)   cell_Z.init(cell_T, Z_owner, LOC);
+   return ec;
+}
+
 //-----------------------------------------------------------------------------
 Token
 ScalarFunction::eval_scalar_B(Value_P B, prim_f1 fun)
 {
+   if (B->is_lazy())
+      {
+        Value_P Z = eval_lazy_B(B, fun);
+        if (!!Z)   return Token(TOK_APL_VALUE1, Z);
+        B->materialize();
+      }
+
+   if (B->is_fused())   B->materialize();   // not fused by fuse_B()
+
 PERFORMANCE_START(start_1)
 
 const ShapeItem len_Z = B->element_count();
    if (len_Z == 0)   return eval_fill_B(B);
 
-Value_P Z(B->get_shape(), LOC);
+   // if B is a temporary value (owned by the prefix, eval_B(), and us) then
+   // compute the result directly into the ravel of B.
+   //
+const bool in_place = is_temp_argument(*B, 2, false) && all_numeric(*B);
+Value_P Z = in_place ? B : Value_P(B->get_shape(), LOC);
+   if (in_place)   Log(LOG_optimization) CERR << "optimizing scalar B" << endl;
 
    // create a worklist with one item that computes Z. If nested values are
    // detected when computing Z then jobs for them are added to the worklist.
@@ -245,6 +300,8 @@ Value_P Z(B->get_shape(), LOC);
             job->fun = this;
             job->error = E_NO_ERROR;
             job->fun1 = fun;
+            Thread_context::M_distribute(job->len_Z,
+                                   Thread_context::get_active_core_count());
             Thread_context::do_work = PF_eval_scalar_B;
             Thread_context::M_fork("eval_scalar_B");   // start pool
             PF_eval_scalar_B(Thread_context::get_master());
@@ -278,7 +335,8 @@ Value_P Z(B->get_shape(), LOC);
                      {
 PERFORMANCE_START(start_2)
 
-                       const ErrorCode ec = (cell_B.*fun)(&cell_Z);
+                       const ErrorCode ec = eval_cell_B(cell_Z,
+                                                  job->value_Z, cell_B, fun);
                        if (ec != E_NO_ERROR)
                           {
                             joblist_B.cancel_jobs();
@@ -301,56 +359,55 @@ PERFORMANCE_END(fs_SCALAR_B, start_1, Z->nz_element_count());
 void
 ScalarFunction::PF_eval_scalar_B(Thread_context & tctx)
 {
-const int cores = Thread_context::get_active_core_count();
 PJob_scalar_B & job = joblist_B.get_current_job();
 
-const ShapeItem slice_len = (job.len_Z + cores - 1) / cores;
-ShapeItem z = tctx.get_N() * slice_len;
-ShapeItem end_z = z + slice_len;
-   if (end_z > job.len_Z)   end_z = job.len_Z;
-
-   for (; z < end_z; ++z)
-       {
-         const Cell & cell_B = job.B_at(z);
-         Cell & cell_Z       = job.Z_at(z);
-
-         if (cell_B.is_pointer_cell())
+ShapeItem z, end_z;
+   while (tctx.PF_next_range(z, end_z))
+      {
+        for (; z < end_z; ++z)
             {
-              // B is nested
-              //
-              Value_P B1 = cell_B.get_pointer_value();
+              const Cell & cell_B = job.B_at(z);
+              Cell & cell_Z       = job.Z_at(z);
 
-              const ShapeItem len_Z1 = B1->get_shape().get_volume();
-              if (len_Z1 == 0)
+              if (cell_B.is_pointer_cell())
                  {
-                   POOL_LOCK(joblist_B.parallel_jobs_lock,
-                      Value_P Z1= B1->clone(LOC);
-                      Z1->to_proto();
-                      Z1->check_value(LOC);
-                      new (&cell_Z) PointerCell(Z1, job.value_Z))
+                   // B is nested
+                   //
+                   Value_P B1 = cell_B.get_pointer_value();
+
+                   const ShapeItem len_Z1 = B1->get_shape().get_volume();
+                   if (len_Z1 == 0)
+                      {
+                        POOL_LOCK(joblist_B.parallel_jobs_lock,
+                           Value_P Z1= B1->clone(LOC);
+                           Z1->to_proto();
+                           Z1->check_value(LOC);
+                           new (&cell_Z) PointerCell(Z1, job.value_Z))
+                      }
+                   else
+                      {
+                        POOL_LOCK(joblist_B.parallel_jobs_lock,
+                           Value_P B1 = cell_B.get_pointer_value();
+                           Value_P Z1(B1->get_shape(), LOC);
+                           new (&cell_Z) PointerCell(Z1, job.value_Z);
+
+                           PJob_scalar_B j1(Z1.getref(), B1.getref());
+                           joblist_B.add_job(j1))
+                      }
                  }
               else
                  {
-                   POOL_LOCK(joblist_B.parallel_jobs_lock,
-                      Value_P B1 = cell_B.get_pointer_value();
-                      Value_P Z1(B1->get_shape(), LOC);
-                      new (&cell_Z) PointerCell(Z1, job.value_Z);
-
-                      PJob_scalar_B j1(Z1.getref(), B1.getref());
-                      joblist_B.add_job(j1))
-                 }
-            }
-         else
-            {
-                  // B not nested: execute fun
-                  //
+                       // B not nested: execute fun
+                       //
 PERFORMANCE_START(start_2)
-                  const ErrorCode ec = (cell_B.*job.fun1)(&cell_Z);
-                  if (ec != E_NO_ERROR)   return;
+                       const ErrorCode ec = eval_cell_B(cell_Z, job.value_Z,
+                                                        cell_B, job.fun1);
+                       if (ec != E_NO_ERROR)   { job.error = ec;   return; }
 
 CELL_PERFORMANCE_END(job.fun->get_statistics_B(), start_2, z)
+                 }
             }
-       }
+      }
 }
 //-----------------------------------------------------------------------------
 void
@@ -397,6 +454,17 @@ ScalarFunction::expand_pointers(Cell * cell_Z, Value & Z_owner,
 Token
 ScalarFunction::eval_scalar_AB(Value_P A, Value_P B, prim_f2 fun)
 {
+   if (A->is_lazy() || B->is_lazy())
+      {
+        Value_P Z = eval_lazy_AB(A, B, fun);
+        if (!!Z)   return Token(TOK_APL_VALUE1, Z);
+        if (A->is_lazy())   A->materialize();
+        if (B->is_lazy())   B->materialize();
+      }
+
+   if (A->is_fused())   A->materialize();   // not fused by fuse_AB()
+   if (B->is_fused())   B->materialize();
+
 PERFORMANCE_START(start_1)
 
 const int inc_A = A->is_scalar_extensible() ? 0 : 1;
@@ -416,7 +484,20 @@ const Shape * shape_Z = 0;
 const ShapeItem len_Z = shape_Z->get_volume();
    if (len_Z == 0)   return eval_fill_AB(A, B);
 
-Value_P Z(*shape_Z, LOC);
+   // if A or B is a temporary value of the same shape as the result, then
+   // compute the result directly into its ravel (see eval_scalar_B()).
+   //
+Value_P Z;
+   if (all_numeric(*A) && all_numeric(*B))
+      {
+        if      (A->get_shape() == *shape_Z && is_temp_argument(*A, 2, true))
+                Z = A;
+        else if (B->get_shape() == *shape_Z && is_temp_argument(*B, 2, true))
+                Z = B;
+      }
+
+   if (!Z)   Z = Value_P(*shape_Z, LOC);
+   else      Log(LOG_optimization) CERR << "optimizing A scalar B" << endl;
 
    // create a worklist with one item that computes Z. If nested values are
    // detected when computing Z then jobs for them are added to the worklist.
@@ -440,6 +521,8 @@ Value_P Z(*shape_Z, LOC);
             job->fun = this;
             job->error = E_NO_ERROR;
             job->fun2 = fun;
+            Thread_context::M_distribute(job->len_Z,
+                                   Thread_context::get_active_core_count());
             Thread_context::do_work = PF_eval_scalar_AB;
             Thread_context::M_fork("eval_scalar_AB");   // start pool
             PF_eval_scalar_AB(Thread_context::get_master());
@@ -563,7 +646,8 @@ Value_P Z(*shape_Z, LOC);
                           //
 PERFORMANCE_START(start_2)
 
-                          const ErrorCode ec = (cell_B.*fun)(&cell_Z, &cell_A);
+                          const ErrorCode ec = eval_cell_AB(cell_Z,
+                                       job->value_Z, cell_A, cell_B, fun);
                           if (ec != E_NO_ERROR)
                              {
                                joblist_AB.cancel_jobs();
@@ -588,131 +672,131 @@ PERFORMANCE_END(fs_SCALAR_AB, start_1, len_Z)
 void
 ScalarFunction::PF_eval_scalar_AB(Thread_context & tctx)
 {
-const CoreCount cores = Thread_context::get_active_core_count();
 PJob_scalar_AB & job = joblist_AB.get_current_job();
 
-const ShapeItem slice_len = (job.len_Z + cores - 1) / cores;
-ShapeItem z = tctx.get_N() * slice_len;
-ShapeItem end_z = z + slice_len;
-   if (end_z > job.len_Z)   end_z = job.len_Z;
+ShapeItem z, end_z;
+   while (tctx.PF_next_range(z, end_z))
+      {
+        for (; z < end_z; ++z)
+            {
+                  const Cell & cell_A = job.A_at(z);
+                  const Cell & cell_B = job.B_at(z);
+                  Cell & cell_Z       = job.Z_at(z);
 
-   for (; z < end_z; ++z)
-       {
-             const Cell & cell_A = job.A_at(z);
-             const Cell & cell_B = job.B_at(z);
-             Cell & cell_Z       = job.Z_at(z);
-
-             if (cell_A.is_pointer_cell())
-                if (cell_B.is_pointer_cell())
-                   {
-                     // both A and B are nested
-                     //
-                     Value_P A1 = cell_A.get_pointer_value();
-                     Value_P B1 = cell_B.get_pointer_value();
-                     const int inc_A1 = A1->is_scalar_extensible() ? 0 : 1;
-                     const int inc_B1 = B1->is_scalar_extensible() ? 0 : 1;
-                     const Shape * sh_Z1 = &B1->get_shape();
-                     if      (A1->is_scalar())   sh_Z1 = &B1->get_shape();
-                     else if (B1->is_scalar())   sh_Z1 = &A1->get_shape();
-                     else if (inc_B1 == 0)       sh_Z1 = &A1->get_shape();
-
-                     if (inc_A1 && inc_B1 && !A1->same_shape(*B1))
+                  if (cell_A.is_pointer_cell())
+                     if (cell_B.is_pointer_cell())
                         {
-                          job.error = A1->same_rank(*B1) ? E_LENGTH_ERROR
-                                                         : E_RANK_ERROR;
-                          return;
-                        }
+                          // both A and B are nested
+                          //
+                          Value_P A1 = cell_A.get_pointer_value();
+                          Value_P B1 = cell_B.get_pointer_value();
+                          const int inc_A1 = A1->is_scalar_extensible() ? 0 : 1;
+                          const int inc_B1 = B1->is_scalar_extensible() ? 0 : 1;
+                          const Shape * sh_Z1 = &B1->get_shape();
+                          if      (A1->is_scalar())   sh_Z1 = &B1->get_shape();
+                          else if (B1->is_scalar())   sh_Z1 = &A1->get_shape();
+                          else if (inc_B1 == 0)       sh_Z1 = &A1->get_shape();
 
-                     const ShapeItem len_Z1 = sh_Z1->get_volume();
-                     if (len_Z1 == 0)
-                        {
-                          Token result =job.fun->eval_fill_AB(A1, B1);
-                          if (result.get_tag() == TOK_ERROR)
+                          if (inc_A1 && inc_B1 && !A1->same_shape(*B1))
                              {
-                               job.error = (ErrorCode)(result.get_int_val());
+                               job.error = A1->same_rank(*B1) ? E_LENGTH_ERROR
+                                                              : E_RANK_ERROR;
                                return;
                              }
-                        }
 
-                     POOL_LOCK(joblist_AB.parallel_jobs_lock,
-                        Value_P Z1(*sh_Z1, LOC);
-                        Z1->set_complete();
-                        new (&cell_Z) PointerCell(Z1, job.value_Z);
-
-                        PJob_scalar_AB j1(Z1.getref(),
-                                          &A1->get_ravel(0), inc_A1,
-                                          &B1->get_ravel(0), inc_B1);
-                        joblist_AB.add_job(j1))
-                   }
-                else
-                   {
-                     // A is nested, B is not
-                     //
-                     Value_P A1 = cell_A.get_pointer_value();
-                     const int inc_A1 = A1->is_scalar_extensible() ? 0 : 1;
-
-                     const ShapeItem len_Z1 = A1->get_shape().get_volume();
-                     if (len_Z1 == 0)
-                        {
-                          Value_P Z1= A1->clone(LOC);
-                          Z1->to_proto();
-                          Z1->check_value(LOC);
-                          new (&cell_Z) PointerCell(Z1, job.value_Z);
-                        }
-                     else
-                        {
+                          const ShapeItem len_Z1 = sh_Z1->get_volume();
+                          if (len_Z1 == 0)
+                             {
+                               Token result =job.fun->eval_fill_AB(A1, B1);
+                               if (result.get_tag() == TOK_ERROR)
+                                  {
+                                    job.error =
+                                       (ErrorCode)(result.get_int_val());
+                                    return;
+                                  }
+                             }
+
                           POOL_LOCK(joblist_AB.parallel_jobs_lock,
-                             Value_P Z1(A1->get_shape(), LOC);
-                             new (&cell_Z) PointerCell(Z1, job.value_Z);
+                             Value_P Z1(*sh_Z1, LOC);
                              Z1->set_complete();
+                             new (&cell_Z) PointerCell(Z1, job.value_Z);
 
                              PJob_scalar_AB j1(Z1.getref(),
                                                &A1->get_ravel(0), inc_A1,
-                                               &cell_B, 0);
+                                               &B1->get_ravel(0), inc_B1);
                              joblist_AB.add_job(j1))
                         }
-                   }
-             else
-                if (cell_B.is_pointer_cell())
-                   {
-                     // A is not nested, B is nested
-                     //
-                     Value_P B1 = cell_B.get_pointer_value();
-                     const int inc_B1 = B1->is_scalar_extensible() ? 0 : 1;
-
-                     const ShapeItem len_Z1 = B1->get_shape().get_volume();
-                     if (len_Z1 == 0)
+                     else
                         {
-                          Value_P Z1= B1->clone(LOC);
-                          Z1->to_proto();
-                          Z1->check_value(LOC);
-                          new (&cell_Z) PointerCell(Z1, job.value_Z);
+                          // A is nested, B is not
+                          //
+                          Value_P A1 = cell_A.get_pointer_value();
+                          const int inc_A1 = A1->is_scalar_extensible() ? 0 : 1;
+
+                          const ShapeItem len_Z1 = A1->get_shape().get_volume();
+                          if (len_Z1 == 0)
+                             {
+                               Value_P Z1= A1->clone(LOC);
+                               Z1->to_proto();
+                               Z1->check_value(LOC);
+                               new (&cell_Z) PointerCell(Z1, job.value_Z);
+                             }
+                          else
+                             {
+                               POOL_LOCK(joblist_AB.parallel_jobs_lock,
+                                  Value_P Z1(A1->get_shape(), LOC);
+                                  new (&cell_Z) PointerCell(Z1, job.value_Z);
+                                  Z1->set_complete();
+
+                                  PJob_scalar_AB j1(Z1.getref(),
+                                                    &A1->get_ravel(0), inc_A1,
+                                                    &cell_B, 0);
+                                  joblist_AB.add_job(j1))
+                             }
                         }
-                     else
+                  else
+                     if (cell_B.is_pointer_cell())
                         {
-                          POOL_LOCK(joblist_AB.parallel_jobs_lock,
-                             Value_P Z1(B1->get_shape(), LOC);
-                             new (&cell_Z) PointerCell(Z1, job.value_Z);
-                             Z1->set_complete();
+                          // A is not nested, B is nested
+                          //
+                          Value_P B1 = cell_B.get_pointer_value();
+                          const int inc_B1 = B1->is_scalar_extensible() ? 0 : 1;
 
-                             PJob_scalar_AB j1(Z1.getref(),
-                                               &cell_A, 0,
-                                               &B1->get_ravel(0), inc_B1);
-                             joblist_AB.add_job(j1))
-                       }
-                   }
-                else
-                   {
-                     // neither A nor B are nested: execute fun
-                     //
+                          const ShapeItem len_Z1 = B1->get_shape().get_volume();
+                          if (len_Z1 == 0)
+                             {
+                               Value_P Z1= B1->clone(LOC);
+                               Z1->to_proto();
+                               Z1->check_value(LOC);
+                               new (&cell_Z) PointerCell(Z1, job.value_Z);
+                             }
+                          else
+                             {
+                               POOL_LOCK(joblist_AB.parallel_jobs_lock,
+                                  Value_P Z1(B1->get_shape(), LOC);
+                                  new (&cell_Z) PointerCell(Z1, job.value_Z);
+                                  Z1->set_complete();
+
+                                  PJob_scalar_AB j1(Z1.getref(),
+                                                    &cell_A, 0,
+                                                    &B1->get_ravel(0), inc_B1);
+                                  joblist_AB.add_job(j1))
+                            }
+                        }
+                     else
+                        {
+                          // neither A nor B are nested: execute fun
+                          //
 PERFORMANCE_START(start_2)
 
-                     const ErrorCode ec = (cell_B.*job.fun2)(&cell_Z, &cell_A);
-                     if (ec != E_NO_ERROR)   return;
+                          const ErrorCode ec = eval_cell_AB(cell_Z,
+                                     job.value_Z, cell_A, cell_B, job.fun2);
+                          if (ec != E_NO_ERROR)   { job.error = ec;   return; }
 
 CELL_PERFORMANCE_END(job.fun->get_statistics_AB(), start_2, z)
-                   }
-       }
+                        }
+            }
+      }
 }
 //-----------------------------------------------------------------------------
 Token
@@ -806,6 +890,91 @@ const Cell & cell_FI0 = FI0->get_ravel(0);
    return Token(TOK_APL_VALUE1, Z);
 }
 //-----------------------------------------------------------------------------
+Value_P
+ScalarFunction::eval_lazy_B(Value_P B, prim_f1 fun)
+{
+const ShapeItem len_Z = B->element_count();
+const APL_Integer start = B->get_lazy_start();
+const APL_Integer step = B->get_lazy_step();
+
+   if (fun == &Cell::bif_conjugate)
+      return Value::progression(len_Z, start, step, LOC);
+
+   if (fun == &Cell::bif_negative)
+      return Value::progression(len_Z, -start, -step, LOC);
+
+   return Value_P();
+}
+//-----------------------------------------------------------------------------
+Value_P
+ScalarFunction::eval_lazy_AB(Value_P A, Value_P B, prim_f2 fun)
+{
+   // the items of lazy values are in the range ±LAZY_MAX. The result is
+   // lazy again if its first and last items are in that range as well,
+   // which is checked with APL_Float before computing the result exactly.
+   //
+const Value * lazy = B->is_lazy() ? B.get() : A.get();
+const ShapeItem len_Z = lazy->element_count();
+APL_Integer k1 = 1;   // factor for A
+APL_Integer k2 = 1;   // factor for B
+APL_Integer c = 0;    // constant A or B
+APL_Integer start_A = 0,   step_A = 0;
+APL_Integer start_B = 0,   step_B = 0;
+
+   if      (fun == &Cell::bif_subtract)   k2 = -1;
+   else if (fun != &Cell::bif_add && fun != &Cell::bif_multiply)
+      return Value_P();
+
+   if (A->is_lazy() && B->is_lazy())   // (⍳N) ± ⍳N
+      {
+        if (fun == &Cell::bif_multiply)   return Value_P();
+        if (!A->same_shape(*B))           return Value_P();   // LENGTH ERROR
+
+        start_A = A->get_lazy_start();   step_A = A->get_lazy_step();
+        start_B = B->get_lazy_start();   step_B = B->get_lazy_step();
+      }
+   else   // one of A and B is lazy, the other one must be an integer scalar
+      {
+        const Value & S = A->is_lazy() ? *B : *A;
+        if (!S.is_scalar_extensible())           return Value_P();
+        if (!S.get_ravel(0).is_integer_cell())   return Value_P();
+
+        c = S.get_ravel(0).get_int_value();
+        if (c > Value::LAZY_MAX || c < -Value::LAZY_MAX)   return Value_P();
+
+        if (fun == &Cell::bif_multiply)   // c × lazy
+           {
+             k1 = c;
+             k2 = 0;
+             start_A = lazy->get_lazy_start();
+             step_A = lazy->get_lazy_step();
+           }
+        else if (A->is_lazy())   // lazy ± c
+           {
+             start_A = A->get_lazy_start();   step_A = A->get_lazy_step();
+             start_B = c;
+           }
+        else                     // c ± lazy
+           {
+             start_A = c;
+             start_B = B->get_lazy_start();   step_B = B->get_lazy_step();
+           }
+      }
+
+   // Z = k1×A + k2×B
+   //
+const APL_Float fstart = APL_Float(k1)*start_A + APL_Float(k2)*start_B;
+const APL_Float fstep  = APL_Float(k1)*step_A  + APL_Float(k2)*step_B;
+const APL_Float fend = fstart + (len_Z - 1)*fstep;
+const APL_Float max = 0.99 * Value::LAZY_MAX;   // allow for rounding
+   if (fstart > max || fstart < -max || fend > max || fend < -max)
+      return Value_P();
+
+   Log(LOG_optimization) CERR << "lazy scalar function" << endl;
+   return Value::progression(len_Z, k1*start_A + k2*start_B,
+                                    k1*step_A  + k2*step_B, LOC);
+}
+//-----------------------------------------------------------------------------
 Token
 ScalarFunction::eval_scalar_AXB(Value_P A, Value_P X, Value_P B, prim_f2 fun)
 {
@@ -952,6 +1121,43 @@ Shape shape_A;
             }
        }
 
+   if (len_Z == 0)   goto done;   // empty B
+
+   // an empty A is found at every position of B where it fits.
+   //
+   if (A->is_empty())
+      {
+        for (ArrayIterator zi(B->get_shape()); !zi.done(); ++zi)
+            {
+              bool fits = true;
+              loop(r, B->get_rank())
+                  {
+                    if (zi.get_value(r) + shape_A.get_shape_item(r) >
+                        B->get_shape_item(r))   fits = false;
+                  }
+              new (&Z->get_ravel(zi.get_total()))   IntCell(fits ? 1 : 0);
+            }
+        goto done;
+      }
+
+   // simple char or integer arrays, where ⎕CT does not matter, are
+   // searched in their ravels.
+   //
+   if (B->get_rank())
+      {
+        const bool chars = A->get_ravel(0).is_character_cell();
+        vector<uint64_t> keys_A;
+        vector<uint64_t> keys_B;
+        if (get_keys(*A, chars, keys_A) && get_keys(*B, chars, keys_B))
+           {
+             loop(z, len_Z)   new (&Z->get_ravel(z))   IntCell(0);
+             if (B->get_rank() == 1)   find_vector(keys_A, keys_B, Z.getref());
+             else   find_array(shape_A, keys_A, B->get_shape(), keys_B,
+                             Z.getref());
+             goto done;
+           }
+      }
+
    for (ArrayIterator zi(B->get_shape()); !zi.done(); ++zi)
        {
 PERFORMANCE_START(start_2)
@@ -998,6 +1204,184 @@ const Shape weight = B->get_shape().reverse_scan();
 
    return true;
 }
+//-----------------------------------------------------------------------------
+bool
+Bif_F2_FIND::get_keys(const Value & value, bool chars,
+                      vector<uint64_t> & keys)
+{
+const ShapeItem len = value.element_count();
+   keys.reserve(len);
+
+   loop(l, len)
+      {
+        const Cell & cell = value.get_ravel(l);
+        if (chars)
+           {
+             if (!cell.is_character_cell())   return false;
+             keys.push_back(cell.get_char_value());
+           }
+        else
+           {
+             if (!cell.is_integer_cell())   return false;
+             keys.push_back(cell.get_int_value());
+           }
+      }
+
+   return true;
+}
+//-----------------------------------------------------------------------------
+void
+Bif_F2_FIND::find_vector(const vector<uint64_t> & A,
+                         const vector<uint64_t> & B, Value & Z)
+{
+const ShapeItem len_A = A.size();
+const ShapeItem len_B = B.size();
+
+   // fail[a] is the length of the longest proper prefix of A[0..a] that
+   // is also a suffix of A[0..a]
+   //
+vector<ShapeItem> fail(len_A, 0);
+   for (ShapeItem a = 1, k = 0; a < len_A; ++a)
+       {
+         while (k && A[a] != A[k])   k = fail[k - 1];
+         if (A[a] == A[k])   ++k;
+         fail[a] = k;
+       }
+
+const uint64_t A0 = A[0];
+ShapeItem k = 0;   // the number of items of A matched so far
+   for (ShapeItem b = 0; b < len_B; ++b)
+       {
+         if (k == 0)   // skip to the next A[0] in B
+            {
+              while (B[b] != A0)   if (++b == len_B)   return;
+            }
+
+         while (k && B[b] != A[k])   k = fail[k - 1];
+         if (B[b] == A[k])   ++k;
+         if (k == len_A)   // A found
+            {
+              new (&Z.get_ravel(b + 1 - len_A))   IntCell(1);
+              k = fail[k - 1];
+            }
+       }
+}
+//-----------------------------------------------------------------------------
+void
+Bif_F2_FIND::find_array(const Shape & shape_A, const vector<uint64_t> & A,
+                        const Shape & shape_B, const vector<uint64_t> & B,
+                        Value & Z)
+{
+const Rank rank = shape_B.get_rank();
+const ShapeItem len_A = A.size();
+const ShapeItem len_B = B.size();
+
+   // hash all shape_A sized sub-arrays of B, and A itself
+   //
+vector<uint64_t> H_B(B);
+   rolling_hash(shape_A, shape_B, H_B);
+
+vector<uint64_t> H_A(A);
+   rolling_hash(shape_A, shape_A, H_A);
+const uint64_t hash_A = H_A[0];
+
+   // offset_A[a] is the offset in B of item a of A (relative to the
+   // position where A starts in B)
+   //
+const Shape weight_B = shape_B.reverse_scan();
+vector<ShapeItem> offset_A;
+   offset_A.reserve(len_A);
+   for (ArrayIterator ai(shape_A); !ai.done(); ++ai)
+       {
+         ShapeItem offset = 0;
+         loop(r, rank)   offset += weight_B.get_shape_item(r)
+                                 * ai.get_values().get_shape_item(r);
+         offset_A.push_back(offset);
+       }
+
+   loop(b, len_B)
+      {
+        if (H_B[b] != hash_A)   continue;
+
+        // hashes are equal. Check that A fits into B at b and compare
+        // the items of A and B (to rule out hash collisions).
+        //
+        bool found = true;
+        ShapeItem rest = b;
+        for (Rank r = rank - 1; r >= 0; --r)
+            {
+              const ShapeItem pos = rest % shape_B.get_shape_item(r);
+              rest /= shape_B.get_shape_item(r);
+              if (pos + shape_A.get_shape_item(r) > shape_B.get_shape_item(r))
+                 {
+                   found = false;
+                   break;
+                 }
+            }
+
+        if (found)   loop(a, len_A)
+           {
+             if (B[b + offset_A[a]] != A[a])   { found = false;   break; }
+           }
+
+        if (found)   new (&Z.get_ravel(b))   IntCell(1);
+      }
+}
+//-----------------------------------------------------------------------------
+void
+Bif_F2_FIND::rolling_hash(const Shape & shape_A, const Shape & shape,
+                          vector<uint64_t> & H)
+{
+   // hash along one axis at a time, starting with the last axis. After
+   // axis r, H[h] is the hash of the items (or the hashes of axis r + 1)
+   // H[h], H[h + stride], ... H[h + (window - 1) × stride], computed as a
+   // polynomial with a different (odd) base per axis, modulo 2⋆64.
+   // Items closer than window to the end of axis r get no valid hash.
+   //
+ShapeItem stride = 1;
+   for (Rank r = shape.get_rank() - 1; r >= 0; --r)
+       {
+         const ShapeItem len = shape.get_shape_item(r);
+         const ShapeItem window = shape_A.get_shape_item(r);
+         const ShapeItem outer = H.size() / (len * stride);
+         const uint64_t base = 0x9E3779B97F4A7C15ULL + 2*r;
+
+         uint64_t base_w1 = 1;   // base ⋆ (window - 1)
+         loop(w, window - 1)   base_w1 *= base;
+
+         vector<uint64_t> hash(stride);
+         loop(o, outer)
+            {
+              uint64_t * line = &H[o * len * stride];
+
+              // hashes of the first window of every line
+              //
+              loop(s, stride)
+                 {
+                   uint64_t h = 0;
+                   loop(w, window)   h = h*base + line[w*stride + s];
+                   hash[s] = h;
+                 }
+
+              // roll the windows along the lines
+              //
+              loop(j, len - window + 1)
+                 {
+                   uint64_t * item = line + j*stride;
+                   const bool last = j + window == len;
+                   loop(s, stride)
+                      {
+                        const uint64_t old_item = item[s];
+                        item[s] = hash[s];
+                        if (!last)   hash[s] = (hash[s] - old_item*base_w1)
+                                             * base + item[window*stride + s];
+                      }
+                 }
+            }
+
+         stride *= len;
+       }
+}
 //=============================================================================
 Token
 Bif_F12_ROLL::eval_AB(Value_P A, Value_P B)
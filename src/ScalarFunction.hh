@@ -25,6 +25,7 @@
 
 #include "Parallel.hh"
 #include "PrimitiveFunction.hh"
+#include "ScalarFusion.hh"
 #include "Value.icc"
 #include "Id.hh"
 
@@ -52,6 +53,14 @@ public:
    /// Evaluate a scalar function dyadically.
    Token eval_scalar_AB(Value_P A, Value_P B, prim_f2 fun);
 
+   /// return fun B as a fused value (or 0, see ScalarFusion)
+   Value_P fuse_scalar_B(Value_P B, prim_f1 fun)
+      { return ScalarFusion::fuse_B(fun, B, get_monadic_threshold()); }
+
+   /// return A fun B as a fused value (or 0, see ScalarFusion)
+   Value_P fuse_scalar_AB(Value_P A, Value_P B, prim_f2 fun)
+      { return ScalarFusion::fuse_AB(A, fun, B, get_dyadic_threshold()); }
+
    /// overloaded Function::get_scalar_f2
    virtual prim_f2 get_scalar_f2() const = 0;
 
@@ -79,6 +88,13 @@ protected:
    /// Evaluate \b the identity function.
    Token eval_scalar_identity_fun(Value_P B, Axis axis, Value_P FI0);
 
+   /// return fun B for a lazy B if that is a lazy value again (else 0)
+   static Value_P eval_lazy_B(Value_P B, prim_f1 fun);
+
+   /// return A fun B for a lazy A and/or B if that is a lazy value
+   /// again (else 0)
+   static Value_P eval_lazy_AB(Value_P A, Value_P B, prim_f2 fun);
+
    /// parallel eval_scalar_AB
    static Thread_context::PoolFunction PF_eval_scalar_AB;
 
@@ -414,6 +430,29 @@ protected:
    /// Return true iff A is contained in B.
    static bool contained(const Shape & shape_A, const Cell * cA,
                          Value_P B, const Shape & idx_B, double qct);
+
+   /// store the ravel of \b value in \b keys (the char values if
+   /// \b chars, the int values otherwise). Return false if \b value
+   /// has items of another type (so that ⎕CT may matter).
+   static bool get_keys(const Value & value, bool chars,
+                        vector<uint64_t> & keys);
+
+   /// set Z[b] to 1 for every occurrence of vector \b A in vector \b B
+   /// (Knuth-Morris-Pratt, O(⍴B))
+   static void find_vector(const vector<uint64_t> & A,
+                           const vector<uint64_t> & B, Value & Z);
+
+   /// set Z[b] to 1 for every occurrence of array \b A (with shape
+   /// \b shape_A and the rank of \b B) in array \b B with shape
+   /// \b shape_B (Rabin-Karp with a rolling hash per axis)
+   static void find_array(const Shape & shape_A, const vector<uint64_t> & A,
+                          const Shape & shape_B, const vector<uint64_t> & B,
+                          Value & Z);
+
+   /// replace every item of \b H (with shape \b shape) by the hash of the
+   /// \b shape_A sized sub-array of \b H that starts at that item
+   static void rolling_hash(const Shape & shape_A, const Shape & shape,
+                            vector<uint64_t> & H);
 };
 //-----------------------------------------------------------------------------
 /** Scalar function nor.
@@ -483,6 +522,13 @@ public:
    static Bif_F12_POWER * fun;       ///< Built-in function.
    static Bif_F12_POWER  _fun;       ///< Built-in function.
 
+   /// overloaded Function::accepts_fused()
+   virtual bool accepts_fused() const   { return true; }
+
+   /// overloaded Function::fuse_AB()
+   virtual Value_P fuse_AB(Value_P A, Value_P B)
+      { return fuse_scalar_AB(A, B, &Cell::bif_power); }
+
 protected:
    /// overloaded Function::eval_B().
    virtual Token eval_B(Value_P B)
@@ -539,6 +585,20 @@ public:
    static Bif_F12_PLUS * fun;        ///< Built-in function.
    static Bif_F12_PLUS  _fun;        ///< Built-in function.
 
+   /// overloaded Function::accepts_fused()
+   virtual bool accepts_fused() const   { return true; }
+
+   /// overloaded Function::fuse_B()
+   virtual Value_P fuse_B(Value_P B)
+      { return fuse_scalar_B(B, &Cell::bif_conjugate); }
+
+   /// overloaded Function::fuse_AB()
+   virtual Value_P fuse_AB(Value_P A, Value_P B)
+      { return fuse_scalar_AB(A, B, &Cell::bif_add); }
+
+   /// overloaded Function::accepts_lazy()
+   virtual bool accepts_lazy() const   { return true; }
+
 protected:
    /// overloaded Function::eval_identity_fun();
    virtual Token eval_identity_fun(Value_P B, Axis axis)
@@ -568,6 +628,20 @@ public:
    static Bif_F12_MINUS * fun;       ///< Built-in function.
    static Bif_F12_MINUS  _fun;       ///< Built-in function.
 
+   /// overloaded Function::accepts_fused()
+   virtual bool accepts_fused() const   { return true; }
+
+   /// overloaded Function::fuse_B()
+   virtual Value_P fuse_B(Value_P B)
+      { return fuse_scalar_B(B, &Cell::bif_negative); }
+
+   /// overloaded Function::fuse_AB()
+   virtual Value_P fuse_AB(Value_P A, Value_P B)
+      { return fuse_scalar_AB(A, B, &Cell::bif_subtract); }
+
+   /// overloaded Function::accepts_lazy()
+   virtual bool accepts_lazy() const   { return true; }
+
 protected:
    /// overloaded Function::eval_B().
    virtual Token eval_B(Value_P B)
@@ -666,6 +740,20 @@ public:
    static Bif_F12_TIMES * fun;       ///< Built-in function.
    static Bif_F12_TIMES  _fun;       ///< Built-in function.
 
+   /// overloaded Function::accepts_fused()
+   virtual bool accepts_fused() const   { return true; }
+
+   /// overloaded Function::fuse_B()
+   virtual Value_P fuse_B(Value_P B)
+      { return fuse_scalar_B(B, &Cell::bif_direction); }
+
+   /// overloaded Function::fuse_AB()
+   virtual Value_P fuse_AB(Value_P A, Value_P B)
+      { return fuse_scalar_AB(A, B, &Cell::bif_multiply); }
+
+   /// overloaded Function::accepts_lazy()
+   virtual bool accepts_lazy() const   { return true; }
+
 protected:
    /// overloaded Function::eval_B().
    virtual Token eval_B(Value_P B)
@@ -710,6 +798,13 @@ public:
    static Bif_F12_DIVIDE * fun;      ///< Built-in function.
    static Bif_F12_DIVIDE  _fun;      ///< Built-in function.
 
+   /// overloaded Function::accepts_fused()
+   virtual bool accepts_fused() const   { return true; }
+
+   /// overloaded Function::fuse_AB()
+   virtual Value_P fuse_AB(Value_P A, Value_P B)
+      { return fuse_scalar_AB(A, B, &Cell::bif_divide); }
+
 protected:
    /// overloaded Function::eval_B().
    virtual Token eval_B(Value_P B)
@@ -795,6 +890,13 @@ public:
    static Bif_F12_RND_UP * fun;      ///< Built-in function.
    static Bif_F12_RND_UP  _fun;      ///< Built-in function.
 
+   /// overloaded Function::accepts_fused()
+   virtual bool accepts_fused() const   { return true; }
+
+   /// overloaded Function::fuse_AB()
+   virtual Value_P fuse_AB(Value_P A, Value_P B)
+      { return fuse_scalar_AB(A, B, &Cell::bif_maximum); }
+
 protected:
    /// overloaded Function::eval_B().
    virtual Token eval_B(Value_P B)
@@ -833,6 +935,13 @@ public:
    static Bif_F12_RND_DN * fun;      ///< Built-in function.
    static Bif_F12_RND_DN  _fun;      ///< Built-in function.
 
+   /// overloaded Function::accepts_fused()
+   virtual bool accepts_fused() const   { return true; }
+
+   /// overloaded Function::fuse_AB()
+   virtual Value_P fuse_AB(Value_P A, Value_P B)
+      { return fuse_scalar_AB(A, B, &Cell::bif_minimum); }
+
 protected:
    /// overloaded Function::eval_B().
    virtual Token eval_B(Value_P B)
@@ -871,6 +980,13 @@ public:
    static Bif_F12_STILE * fun;       ///< Built-in function.
    static Bif_F12_STILE  _fun;       ///< Built-in function.
 
+   /// overloaded Function::accepts_fused()
+   virtual bool accepts_fused() const   { return true; }
+
+   /// overloaded Function::fuse_B()
+   virtual Value_P fuse_B(Value_P B)
+      { return fuse_scalar_B(B, &Cell::bif_magnitude); }
+
    /// overloaded Function::eval_AB().
    virtual Token eval_AB(Value_P A, Value_P B)
       { return eval_scalar_AB(A, B, &Cell::bif_residue); }
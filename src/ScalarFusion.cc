@@ -0,0 +1,505 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2015  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+
+#include "Error.hh"
+#include "FloatCell.hh"
+#include "IntCell.hh"
+#include "Parallel.hh"
+#include "ScalarFusion.hh"
+#include "Value.icc"
+
+/// the largest magnitude of a fused result (leaving room below ∞)
+static const APL_Float MAX_BOUND = 1e300;
+
+/// the largest magnitude of a natively computed integer (exact as APL_Float
+/// and far from LARGE_INT, so that no IntCell function would return a float)
+static const APL_Float MAX_NATIVE_INT = 9e15;
+
+const ScalarFusion * ScalarFusion::parallel_fusion = 0;
+Cell * ScalarFusion::parallel_cZ = 0;
+vector<ErrorCode> ScalarFusion::parallel_errors;
+
+//-----------------------------------------------------------------------------
+ScalarFusion::ScalarFusion(ShapeItem len_Z)
+   : len(len_Z),
+     leaf_count(0),
+     op_count(0),
+     parallel_threshold(len_Z)
+{
+}
+//-----------------------------------------------------------------------------
+Value_P
+ScalarFusion::fuse_AB(Value_P A, prim_f2 fun, Value_P B, ShapeItem threshold)
+{
+   // lazy values (see Value::is_lazy()) are handled by eval_scalar_AB()
+   //
+   if (A->is_lazy() || B->is_lazy())   return Value_P();
+
+   if (fun != &Cell::bif_add     && fun != &Cell::bif_subtract &&
+       fun != &Cell::bif_multiply && fun != &Cell::bif_divide  &&
+       fun != &Cell::bif_maximum  && fun != &Cell::bif_minimum &&
+       fun != &Cell::bif_power)   return Value_P();
+
+   // A and B must conform (otherwise eval_scalar_AB() reports the error)
+   //
+const Value * shape_Z = 0;
+   if      (A->same_shape(*B))          shape_Z = B.get();
+   else if (A->is_scalar_extensible())   shape_Z = B.get();
+   else if (B->is_scalar_extensible())   shape_Z = A.get();
+   else                                  return Value_P();
+
+const ShapeItem len_Z = shape_Z->element_count();
+   if (len_Z < MIN_LEN)   return Value_P();
+
+ScalarFusion * fusion = new ScalarFusion(len_Z);
+const int a = fusion->add_value(A);
+const int b = a < 0 ? -1 : fusion->add_value(B);
+
+   // compute the largest magnitude of the result, or -1 if fun could fail
+   //
+APL_Float bound_Z = -1;
+   if (b >= 0)
+      {
+        const APL_Float bound_A = fusion->bound[a];
+        const APL_Float bound_B = fusion->bound[b];
+
+        if (fun == &Cell::bif_add || fun == &Cell::bif_subtract)
+           {
+             bound_Z = bound_A + bound_B;
+           }
+        else if (fun == &Cell::bif_multiply)
+           {
+             bound_Z = bound_A * bound_B;
+           }
+        else if (fun == &Cell::bif_maximum || fun == &Cell::bif_minimum)
+           {
+             bound_Z = bound_A > bound_B ? bound_A : bound_B;
+           }
+        else if (fun == &Cell::bif_divide && fusion->is_scalar_leaf(b))
+           {
+             // A ÷ non-zero scalar
+             const APL_Float divisor = fusion->leaf_ravel[b]->get_real_value();
+             if (divisor != 0.0)   bound_Z = bound_A / fabs(divisor);
+           }
+        else if (fun == &Cell::bif_power && fusion->is_scalar_leaf(b) &&
+                 fusion->leaf_ravel[b]->is_integer_cell())
+           {
+             // A ⋆ small non-negative integer
+             const APL_Integer expo = fusion->leaf_ravel[b]->get_int_value();
+             if (expo >= 0 && expo <= 64)
+                bound_Z = pow(bound_A > 1.0 ? bound_A : 1.0, APL_Float(expo));
+           }
+      }
+
+const Operation op = { 0, fun, a, b };
+   if (bound_Z < 0 || fusion->add_op(op, bound_Z) < 0)
+      {
+        delete fusion;
+        return Value_P();
+      }
+
+   if (fusion->parallel_threshold > threshold)
+      fusion->parallel_threshold = threshold;
+   return Value_P(new Value(shape_Z->get_shape(), fusion, LOC), LOC);
+}
+//-----------------------------------------------------------------------------
+Value_P
+ScalarFusion::fuse_B(prim_f1 fun, Value_P B, ShapeItem threshold)
+{
+   if (B->is_lazy())   return Value_P();
+
+const ShapeItem len_Z = B->element_count();
+   if (len_Z < MIN_LEN)   return Value_P();
+
+   if (fun != &Cell::bif_conjugate && fun != &Cell::bif_negative &&
+       fun != &Cell::bif_magnitude && fun != &Cell::bif_direction)
+      return Value_P();
+
+ScalarFusion * fusion = new ScalarFusion(len_Z);
+const int b = fusion->add_value(B);
+const APL_Float bound_Z = fun == &Cell::bif_direction ? 1.0 : fusion->bound[b];
+const Operation op = { fun, 0, -1, b };
+   if (b < 0 || fusion->add_op(op, bound_Z) < 0)
+      {
+        delete fusion;
+        return Value_P();
+      }
+
+   if (fusion->parallel_threshold > threshold)
+      fusion->parallel_threshold = threshold;
+   return Value_P(new Value(B->get_shape(), fusion, LOC), LOC);
+}
+//-----------------------------------------------------------------------------
+int
+ScalarFusion::add_value(Value_P value)
+{
+   if (!value->is_fused())   return add_leaf(value);
+
+   // value is itself a chain: add its leaves and its functions
+   //
+const ScalarFusion & other = *value->get_fusion();
+int operands[MAX_LEAVES + MAX_OPS];
+   loop(l, other.leaf_count)
+      {
+        operands[l] = add_leaf(other.leaves[l]);
+        if (operands[l] < 0)   return -1;
+      }
+
+int last = -1;
+   loop(o, other.op_count)
+      {
+        Operation op = other.ops[o];
+        if (op.fun2)   op.A = operands[op.A];
+        op.B = operands[op.B];
+        last = add_op(op, other.bound[MAX_LEAVES + o]);
+        if (last < 0)   return -1;
+        operands[MAX_LEAVES + o] = last;
+      }
+
+   if (parallel_threshold > other.parallel_threshold)
+      parallel_threshold = other.parallel_threshold;
+   return last;
+}
+//-----------------------------------------------------------------------------
+int
+ScalarFusion::add_leaf(Value_P value)
+{
+   // the same value used twice (like in A×A) is one leaf
+   //
+   loop(l, leaf_count)   if (leaves[l].get() == value.get())   return l;
+
+   if (leaf_count >= MAX_LEAVES)   return -1;
+
+   // the leaf must be simple and real (so that no function can fail).
+   // get_u0() reads the item without a (second) virtual function call.
+   //
+const ShapeItem len_V = value->element_count();
+const Cell * cV = &value->get_ravel(0);
+APL_Float bound_V = 0.0;
+int types = 0;
+   loop(v, len_V)
+      {
+        const Cell & cell = cV[v];
+        const CellType ct = cell.get_cell_type();
+        APL_Float mag;
+        if (ct == CT_INT)
+           mag = fabs(APL_Float(*(const APL_Integer *)cell.get_u0()));
+        else if (ct == CT_FLOAT)
+           mag = fabs(*(const APL_Float *)cell.get_u0());
+        else
+           return -1;
+
+        types |= ct;
+        if (bound_V < mag)   bound_V = mag;
+      }
+
+   if (bound_V > MAX_BOUND)   return -1;
+
+   value->set_leaf();   // see Symbol::get_indexed_value()
+   leaves[leaf_count] = value;
+   leaf_ravel[leaf_count] = cV;
+   leaf_inc[leaf_count] = len_V == 1 ? 0 : 1;
+   leaf_type[leaf_count] = types == CT_INT   ? CT_INT
+                         : types == CT_FLOAT ? CT_FLOAT : CT_NONE;
+   bound[leaf_count] = bound_V;
+   return leaf_count++;
+}
+//-----------------------------------------------------------------------------
+int
+ScalarFusion::add_op(const Operation & op, APL_Float bound_Z)
+{
+   if (op_count >= MAX_OPS)    return -1;
+   if (bound_Z > MAX_BOUND)    return -1;
+
+   ops[op_count] = op;
+   bound[MAX_LEAVES + op_count] = bound_Z;
+   return MAX_LEAVES + op_count++;
+}
+//-----------------------------------------------------------------------------
+void
+ScalarFusion::evaluate(Cell * cZ) const
+{
+#if PARALLEL_ENABLED
+   if (  Parallel::run_parallel
+      && Thread_context::get_active_core_count() > 1
+      && len > parallel_threshold)
+      {
+        const CoreCount cores = Thread_context::get_active_core_count();
+        parallel_fusion = this;
+        parallel_cZ = cZ;
+        parallel_errors.assign(cores, E_NO_ERROR);
+        Thread_context::M_distribute(len, cores);
+        Thread_context::do_work = PF_evaluate;
+        Thread_context::M_fork("ScalarFusion");   // start pool
+        PF_evaluate(Thread_context::get_master());
+        Thread_context::M_join();
+        loop(c, cores)
+           {
+             const ErrorCode ec = parallel_errors[c];
+             if (ec != E_NO_ERROR)   throw_apl_error(ec, LOC);
+           }
+        return;
+      }
+#endif // PARALLEL_ENABLED
+
+const ErrorCode ec = evaluate(cZ, 0, len);
+   if (ec != E_NO_ERROR)   throw_apl_error(ec, LOC);
+}
+//-----------------------------------------------------------------------------
+void
+ScalarFusion::PF_evaluate(Thread_context & tctx)
+{
+ShapeItem z, end_z;
+   while (tctx.PF_next_range(z, end_z))
+      {
+        const ErrorCode ec = parallel_fusion->evaluate(parallel_cZ, z, end_z);
+        if (ec != E_NO_ERROR && parallel_errors[tctx.get_N()] == E_NO_ERROR)
+           parallel_errors[tctx.get_N()] = ec;
+      }
+}
+//-----------------------------------------------------------------------------
+ErrorCode
+ScalarFusion::evaluate(Cell * cZ, ShapeItem from, ShapeItem to) const
+{
+   switch(get_native_type())
+      {
+        case CT_INT:   evaluate_native<APL_Integer>(cZ, from, to);
+                       return E_NO_ERROR;
+
+        case CT_FLOAT: evaluate_native<APL_Float>(cZ, from, to);
+                       return E_NO_ERROR;
+
+        default:       break;
+      }
+
+   // the results of all but the last function of a block. They are
+   // simple numeric cells and can therefore be overwritten without
+   // releasing them.
+   //
+Cell block[MAX_OPS - 1][BLOCK_LEN];
+
+   for (ShapeItem b0 = from; b0 < to; b0 += BLOCK_LEN)
+       {
+         const ShapeItem len_b = (to - b0) < BLOCK_LEN ? (to - b0) : BLOCK_LEN;
+         loop(o, op_count)
+            {
+              const Operation & op = ops[o];
+              Cell * dest = (o == op_count - 1) ? cZ + b0 : block[o];
+
+              // the right argument of the function
+              //
+              const Cell * cB;
+              int inc_B = 1;
+              if (op.B < MAX_LEAVES)   // argument
+                 {
+                   inc_B = leaf_inc[op.B];
+                   cB = leaf_ravel[op.B] + b0*inc_B;
+                 }
+              else                     // result of an earlier function
+                 {
+                   cB = block[op.B - MAX_LEAVES];
+                 }
+
+              if (op.fun1)   // monadic
+                 {
+                   loop(i, len_b)
+                      {
+                        const ErrorCode ec = (cB[i*inc_B].*op.fun1)(dest + i);
+                        if (ec != E_NO_ERROR)   return ec;
+                      }
+                   continue;
+                 }
+
+              const Cell * cA;
+              int inc_A = 1;
+              if (op.A < MAX_LEAVES)
+                 {
+                   inc_A = leaf_inc[op.A];
+                   cA = leaf_ravel[op.A] + b0*inc_A;
+                 }
+              else
+                 {
+                   cA = block[op.A - MAX_LEAVES];
+                 }
+
+              loop(i, len_b)
+                 {
+                   const ErrorCode ec = (cB[i*inc_B].*op.fun2)(dest + i,
+                                                               cA + i*inc_A);
+                   if (ec != E_NO_ERROR)   return ec;
+                 }
+            }
+       }
+
+   return E_NO_ERROR;
+}
+//-----------------------------------------------------------------------------
+ScalarFusion::Native_function
+ScalarFusion::get_native(const Operation & op)
+{
+   if (op.fun1 == &Cell::bif_conjugate)   return NF_CONJUGATE;
+   if (op.fun1 == &Cell::bif_negative)    return NF_NEGATIVE;
+   if (op.fun1 == &Cell::bif_magnitude)   return NF_MAGNITUDE;
+   if (op.fun1 == &Cell::bif_direction)   return NF_DIRECTION;
+   if (op.fun2 == &Cell::bif_add)         return NF_ADD;
+   if (op.fun2 == &Cell::bif_subtract)    return NF_SUBTRACT;
+   if (op.fun2 == &Cell::bif_multiply)    return NF_MULTIPLY;
+   if (op.fun2 == &Cell::bif_divide)      return NF_DIVIDE;
+   if (op.fun2 == &Cell::bif_maximum)     return NF_MAXIMUM;
+   if (op.fun2 == &Cell::bif_minimum)     return NF_MINIMUM;
+   return NF_NONE;
+}
+//-----------------------------------------------------------------------------
+CellType
+ScalarFusion::get_native_type() const
+{
+const CellType type = leaf_type[0];
+   if (type == CT_NONE)   return CT_NONE;
+
+   loop(l, leaf_count)
+      {
+        if (leaf_type[l] != type)   return CT_NONE;
+        if (type == CT_INT && bound[l] > MAX_NATIVE_INT)   return CT_NONE;
+      }
+
+   // the functions must return cells of the same type as their arguments:
+   // × B returns integers and A ÷ B can return floats for integer A and B
+   //
+   loop(o, op_count)
+      {
+        const Native_function nf = get_native(ops[o]);
+        if (nf == NF_NONE)   return CT_NONE;
+        if (type == CT_INT)
+           {
+             if (nf == NF_DIVIDE)                            return CT_NONE;
+             if (bound[MAX_LEAVES + o] > MAX_NATIVE_INT)   return CT_NONE;
+           }
+        else if (nf == NF_DIRECTION)                         return CT_NONE;
+      }
+
+   return type;
+}
+//-----------------------------------------------------------------------------
+/// store an integer item into \b cZ
+inline void
+store_item(Cell * cZ, APL_Integer z)
+{
+   new (cZ) IntCell(z);
+}
+//-----------------------------------------------------------------------------
+/// store a float item into \b cZ
+inline void
+store_item(Cell * cZ, APL_Float z)
+{
+   new (cZ) FloatCell(z);
+}
+//-----------------------------------------------------------------------------
+template<typename T>
+void
+ScalarFusion::evaluate_native(Cell * cZ, ShapeItem from, ShapeItem to) const
+{
+   // the operands of a block: the arguments (copied from their ravels)
+   // followed by the results of the functions
+   //
+T block[MAX_LEAVES + MAX_OPS][BLOCK_LEN];
+
+   loop(l, leaf_count)   // scalar arguments are copied once
+      {
+        if (leaf_inc[l])   continue;
+        const T item = *(const T *)leaf_ravel[l]->get_u0();
+        loop(i, BLOCK_LEN)   block[l][i] = item;
+      }
+
+   for (ShapeItem b0 = from; b0 < to; b0 += BLOCK_LEN)
+       {
+         const ShapeItem len_b = (to - b0) < BLOCK_LEN ? (to - b0) : BLOCK_LEN;
+         loop(l, leaf_count)
+            {
+              if (leaf_inc[l] == 0)   continue;
+              const Cell * cL = leaf_ravel[l] + b0;
+              T * dest = block[l];
+              loop(i, len_b)   dest[i] = *(const T *)cL[i].get_u0();
+            }
+
+         loop(o, op_count)
+            {
+              const Operation & op = ops[o];
+              const T * b = block[op.B];
+              const T * a = op.fun2 ? block[op.A] : 0;
+              T * z = block[MAX_LEAVES + o];
+              switch(get_native(op))
+                 {
+                   case NF_CONJUGATE:
+                        loop(i, len_b)   z[i] = b[i];
+                        break;
+
+                   case NF_NEGATIVE:
+                        loop(i, len_b)   z[i] = -b[i];
+                        break;
+
+                   case NF_MAGNITUDE:
+                        loop(i, len_b)   z[i] = b[i] < 0 ? -b[i] : b[i];
+                        break;
+
+                   case NF_DIRECTION:
+                        loop(i, len_b)   z[i] = (b[i] > 0) - (b[i] < 0);
+                        break;
+
+                   case NF_ADD:
+                        loop(i, len_b)   z[i] = a[i] + b[i];
+                        break;
+
+                   case NF_SUBTRACT:
+                        loop(i, len_b)   z[i] = a[i] - b[i];
+                        break;
+
+                   case NF_MULTIPLY:
+                        loop(i, len_b)   z[i] = a[i] * b[i];
+                        break;
+
+                   case NF_DIVIDE:
+                        loop(i, len_b)   z[i] = a[i] / b[i];
+                        break;
+
+                   case NF_MAXIMUM:
+                        loop(i, len_b)   z[i] = a[i] >= b[i] ? a[i] : b[i];
+                        break;
+
+                   case NF_MINIMUM:
+                        loop(i, len_b)   z[i] = a[i] <= b[i] ? a[i] : b[i];
+                        break;
+
+                   default: FIXME;
+                 }
+            }
+
+         const T * z = block[MAX_LEAVES + op_count - 1];
+         loop(i, len_b)   store_item(cZ + b0 + i, z[i]);
+       }
+}
+//-----------------------------------------------------------------------------
+void
+ScalarFusion::unmark() const
+{
+   loop(l, leaf_count)   leaves[l]->unmark();
+}
+//-----------------------------------------------------------------------------
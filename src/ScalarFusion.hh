@@ -0,0 +1,186 @@
+/*
+    This file is part of GNU APL, a free implementation of the
+    ISO/IEC Standard 13751, "Programming Language APL, Extended"
+
+    Copyright (C) 2008-2015  Dr. Jürgen Sauermann
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __SCALAR_FUSION_HH_DEFINED__
+#define __SCALAR_FUSION_HH_DEFINED__
+
+#include <vector>
+
+#include "Cell.hh"
+#include "Parallel.hh"
+#include "Value.icc"
+
+//-----------------------------------------------------------------------------
+/**
+    A deferred chain of scalar functions. An expression like 0.5×(A+B)⋆2
+    is normally computed one function after the other, and every function
+    creates a new value and reads and writes all items. If the arguments
+    are long simple real arrays, then the functions are instead recorded in
+    a ScalarFusion and the result is a fused value (see Value::is_fused())
+    whose ravel is computed in a single pass when the value is used by a
+    function that is not fused (or is assigned or printed).
+
+    The pass computes the items in blocks of BLOCK_LEN items: every
+    function of the chain computes a block before the next function uses
+    it, so that intermediate results remain in the cache.
+
+    Only functions that cannot fail are fused, so that errors are always
+    reported for the function that caused them. To ensure that, the
+    largest magnitude of every argument and intermediate result is tracked
+    and fusion stops before a result could overflow.
+
+    If all arguments are integers (or all are floats) and the functions
+    produce results of the same type, then the blocks are computed as
+    C arrays of APL_Integer (or APL_Float) and only the final result is
+    stored as cells (see evaluate_native()).
+ **/
+class ScalarFusion
+{
+public:
+   enum
+      {
+        MAX_LEAVES = 8,     ///< max. number of arguments (values) of a chain
+        MAX_OPS    = 8,     ///< max. number of functions in a chain
+        BLOCK_LEN  = 256,   ///< items computed by a function at a time
+        MIN_LEN    = 1024,  ///< shorter values are computed directly
+      };
+
+   /// return the fused value A fun B, or 0 if A fun B shall be computed
+   /// directly. \b threshold is the parallel threshold of \b fun
+   static Value_P fuse_AB(Value_P A, prim_f2 fun, Value_P B,
+                          ShapeItem threshold);
+
+   /// return the fused value fun B, or 0 if fun B shall be computed directly
+   static Value_P fuse_B(prim_f1 fun, Value_P B, ShapeItem threshold);
+
+   /// compute the \b len items of the fused value into \b cZ
+   void evaluate(Cell * cZ) const;
+
+   /// unmark all arguments of the chain
+   void unmark() const;
+
+protected:
+   /// constructor
+   ScalarFusion(ShapeItem len_Z);
+
+   /// the functions that evaluate_native() can compute
+   enum Native_function
+      {
+        NF_NONE = 0,     ///< not computed natively
+        NF_CONJUGATE,    ///< + B
+        NF_NEGATIVE,     ///< - B
+        NF_MAGNITUDE,    ///< ∣ B
+        NF_DIRECTION,    ///< × B
+        NF_ADD,          ///< A + B
+        NF_SUBTRACT,     ///< A - B
+        NF_MULTIPLY,     ///< A × B
+        NF_DIVIDE,       ///< A ÷ B
+        NF_MAXIMUM,      ///< A ⌈ B
+        NF_MINIMUM,      ///< A ⌊ B
+      };
+
+   /// one function of the chain
+   struct Operation
+      {
+        prim_f1 fun1;   ///< monadic function (or 0)
+        prim_f2 fun2;   ///< dyadic function (or 0)
+        int A;          ///< left argument (operand number)
+        int B;          ///< right argument (operand number)
+      };
+
+   /// return the Native_function for \b op
+   static Native_function get_native(const Operation & op);
+
+   /// add \b value (an argument or a fused value) to \b this chain and
+   /// return its operand number (or -1 if the chain is full or \b value
+   /// cannot be fused)
+   int add_value(Value_P value);
+
+   /// add \b value as an argument (leaf) of \b this chain and return its
+   /// operand number (or -1 if that is not possible)
+   int add_leaf(Value_P value);
+
+   /// add the function \b op to \b this chain and return its operand
+   /// number (or -1 if the chain is full)
+   int add_op(const Operation & op, APL_Float bound_Z);
+
+   /// return \b true if \b operand is a leaf with only one item
+   bool is_scalar_leaf(int operand) const
+      { return operand < MAX_LEAVES && leaf_inc[operand] == 0; }
+
+   /// compute the items [\b from, \b to) of the result into \b cZ
+   ErrorCode evaluate(Cell * cZ, ShapeItem from, ShapeItem to) const;
+
+   /// return CT_INT or CT_FLOAT if evaluate_native() can compute \b this
+   /// chain with APL_Integer or APL_Float items, or else CT_NONE
+   CellType get_native_type() const;
+
+   /// compute the items [\b from, \b to) of the result into \b cZ with
+   /// items of type T (APL_Integer or APL_Float)
+   template<typename T>
+   void evaluate_native(Cell * cZ, ShapeItem from, ShapeItem to) const;
+
+   /// compute parallel_fusion in parallel
+   static Thread_context::PoolFunction PF_evaluate;
+
+   /// the number of items of the result
+   const ShapeItem len;
+
+   /// the arguments of the chain (operands 0 ... leaf_count-1)
+   Value_P leaves[MAX_LEAVES];
+
+   /// the ravels of the arguments
+   const Cell * leaf_ravel[MAX_LEAVES];
+
+   /// 0 for scalar arguments, else 1
+   int leaf_inc[MAX_LEAVES];
+
+   /// CT_INT if all items of an argument are integers, CT_FLOAT if all
+   /// are floats, or else CT_NONE
+   CellType leaf_type[MAX_LEAVES];
+
+   /// the number of arguments
+   int leaf_count;
+
+   /// the functions of the chain (operands MAX_LEAVES + n)
+   Operation ops[MAX_OPS];
+
+   /// the number of functions
+   int op_count;
+
+   /// the largest magnitude of every operand
+   APL_Float bound[MAX_LEAVES + MAX_OPS];
+
+   /// compute the result in parallel if it has more items
+   ShapeItem parallel_threshold;
+
+   /// the fusion being evaluated in parallel
+   static const ScalarFusion * parallel_fusion;
+
+   /// the result ravel of parallel_fusion
+   static Cell * parallel_cZ;
+
+   /// the first error detected by every core in PF_evaluate(), indexed
+   /// by core number (so that no two cores write the same item)
+   static vector<ErrorCode> parallel_errors;
+};
+//-----------------------------------------------------------------------------
+
+#endif // __SCALAR_FUSION_HH_DEFINED__
@@ -86,6 +86,10 @@ public:
    /// return the number of Value_P that point to \b value_p
    inline int use_count() const;
 
+   /// compute the ravel of a lazy or fused value (if needed), but keep
+   /// lazy progressions if \b keep_lazy is \b true. Return \b this
+   inline const Value_P & computed(bool keep_lazy = false) const;
+
    /// decrement owner-count and reset pointer to 0
    inline void reset();
 
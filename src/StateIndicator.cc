@@ -31,6 +31,9 @@
 #include "UserFunction.hh"
 #include "Workspace.hh"
 
+void * StateIndicator::deleted_SIs = 0;
+int StateIndicator::deleted_SIs_count = 0;
+
 //-----------------------------------------------------------------------------
 StateIndicator::StateIndicator(Executable * exec, StateIndicator * _par)
    : executable(exec),
@@ -184,7 +184,47 @@ public:
    /// a small storage for DerivedFunction objects.
   DerivedFunctionCache fun_oper_cache;
 
+   /// allocate space for a new StateIndicator. Every call of a defined
+   /// function creates one, so a pool of deleted_SIs_MAX StateIndicators
+   /// is kept and the StateIndicators in that pool are reused before
+   /// calling malloc().
+   static void * operator new(size_t sz)
+      {
+        if (deleted_SIs)   // we have deleted SIs: recycle one
+           {
+             void * ret = deleted_SIs;
+             deleted_SIs = *(void **)deleted_SIs;
+             --deleted_SIs_count;
+             return ret;
+           }
+
+        return malloc(sz);
+      }
+
+   /// free space for a new StateIndicator
+   static void operator delete(void * ptr)
+      {
+        if (deleted_SIs_count < deleted_SIs_MAX)   // space in the pool
+           {
+             ++deleted_SIs_count;
+             *(void **)ptr = deleted_SIs;
+             deleted_SIs = ptr;
+             return;
+           }
+
+        free(ptr);   // no more space
+      }
+
 protected:
+   /// deleted StateIndicators (a chain linked by their first pointer)
+   static void * deleted_SIs;
+
+   /// number of StateIndicators in the deleted_SIs chain
+   static int deleted_SIs_count;
+
+   /// max. number of StateIndicators in the deleted_SIs chain
+   enum { deleted_SIs_MAX = 64 };
+
    /// the user function that is being executed
    Executable * executable;
 
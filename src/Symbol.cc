@@ -45,9 +45,11 @@ Symbol::Symbol(ID::Id id)
      next(0),
      name(UCS_string(UTF8_string(ID::name(id)))),
      erased(false),
+     dirty(false),
      monitor_callback(0)
 {
    push();
+   clear_dirty();
 }
 //-----------------------------------------------------------------------------
 Symbol::Symbol(const UCS_string & ucs, ID::Id id)
@@ -55,9 +57,11 @@ Symbol::Symbol(const UCS_string & ucs, ID::Id id)
      next(0),
      name(ucs),
      erased(false),
+     dirty(false),
      monitor_callback(0)
 {
    push();
+   clear_dirty();
 }
 //-----------------------------------------------------------------------------
 ostream &
@@ -145,7 +149,7 @@ ValueStackItem & vs = value_stack.back();
 
              vs.name_class = NC_VARIABLE;
              vs.apl_val = new_value;
-             if (monitor_callback)   monitor_callback(*this, SEV_ASSIGNED);
+             call_monitor_callback(SEV_ASSIGNED);
              return;
 
         case NC_VARIABLE:
@@ -154,18 +158,54 @@ ValueStackItem & vs = value_stack.back();
              new_value = new_value->clone(loc);
 
              vs.apl_val = new_value;
-             if (monitor_callback)   monitor_callback(*this, SEV_ASSIGNED);
+             call_monitor_callback(SEV_ASSIGNED);
              return;
 
         case NC_SHARED_VAR:
              assign_shared_variable(new_value, loc);
-             if (monitor_callback)   monitor_callback(*this, SEV_ASSIGNED);
+             call_monitor_callback(SEV_ASSIGNED);
              return;
 
         default: SYNTAX_ERROR;
       }
 }
 //-----------------------------------------------------------------------------
+Value_P
+Symbol::append_value(const Value & B, const char * loc)
+{
+   Assert(value_stack.size());
+
+ValueStackItem & vs = value_stack.back();
+   if (vs.name_class != NC_VARIABLE)   return Value_P();
+
+   // the value must not be referenced from anywhere else, since it is
+   // modified rather than replaced.
+   //
+   if (vs.apl_val->get_owner_count() != 1)   return Value_P();
+   if (!vs.apl_val->append_ravel(B, loc))     return Value_P();
+
+   call_monitor_callback(SEV_ASSIGNED);
+   return vs.apl_val;
+}
+//-----------------------------------------------------------------------------
+Value_P
+Symbol::get_indexed_value()
+{
+Value_P A = get_apl_value();
+
+   // A[X]←B modifies A in place. If A is an argument of a fused value that
+   // is not yet computed (see ScalarFusion) then modify a copy of A so that
+   // the fused value sees the old A.
+   //
+   if (A->is_leaf() && value_stack.back().name_class == NC_VARIABLE)
+      {
+        A = A->clone(LOC);
+        value_stack.back().apl_val = A;
+      }
+
+   return A;
+}
+//-----------------------------------------------------------------------------
 void
 Symbol::assign_indexed(Value_P X, Value_P B)   // A[X] ← B
 {
@@ -173,7 +213,7 @@ Symbol::assign_indexed(Value_P X, Value_P B)   // A[X] ← B
    // an index with no semicolons. If X contains semicolons, then
    // assign_indexed(IndexExpr IX, ...) is called instead.
    // 
-Value_P A = get_apl_value();
+Value_P A = get_indexed_value();
    if (A->get_rank() != 1)   RANK_ERROR;
 
 const ShapeItem max_idx = A->element_count();
@@ -186,7 +226,7 @@ const ShapeItem max_idx = A->element_count();
               dest.release(LOC);   // free sub-values etc (if any)
               dest.init(src, A.getref(), LOC);
             }
-        if (monitor_callback)   monitor_callback(*this, SEV_ASSIGNED);
+        call_monitor_callback(SEV_ASSIGNED);
         return;
       }
 
@@ -211,7 +251,7 @@ const Cell * cB = &B->get_ravel(0);
          cB += incr_B;
       }
 
-   if (monitor_callback)   monitor_callback(*this, SEV_ASSIGNED);
+   call_monitor_callback(SEV_ASSIGNED);
 }
 //-----------------------------------------------------------------------------
 void
@@ -225,7 +265,7 @@ Symbol::assign_indexed(IndexExpr & IX, Value_P B)   // A[IX;...] ← B
 
    // see Value::index() for comments.
 
-Value_P A = get_apl_value();
+Value_P A = get_indexed_value();
    if (A->get_rank() != IX.value_count())   RANK_ERROR;   // ISO p. 159
 
    // B must either be a scalar (and is then scalar extended to the size
@@ -294,7 +334,7 @@ const int incr_B = (ec_B == 1) ? 0 : 1;
         cB += incr_B;
      }
 
-   if (monitor_callback)   monitor_callback(*this, SEV_ASSIGNED);
+   call_monitor_callback(SEV_ASSIGNED);
 }
 //-----------------------------------------------------------------------------
 void
@@ -320,7 +360,7 @@ UserFunction * ufun = lambda->get_ufun1();
 
              vs.sym_val.function = ufun;
              ufun->increment_refcount(LOC);
-             if (monitor_callback)   monitor_callback(*this, SEV_ASSIGNED);
+             call_monitor_callback(SEV_ASSIGNED);
              return;
 
         default: SYNTAX_ERROR;
@@ -351,7 +391,7 @@ const ValueStackItem & vs = value_stack.back();
         ptr_clear(ret, LOC);
 
         value_stack.pop_back();
-        if (monitor_callback)   monitor_callback(*this, SEV_POPED);
+        call_monitor_callback(SEV_POPED);
       }
    else
       {
@@ -363,7 +403,7 @@ const ValueStackItem & vs = value_stack.back();
              CERR << endl;
            }
         value_stack.pop_back();
-        if (monitor_callback)   monitor_callback(*this, SEV_POPED);
+        call_monitor_callback(SEV_POPED);
       }
 }
 //-----------------------------------------------------------------------------
@@ -378,7 +418,7 @@ Symbol::push()
       }
 
    value_stack.push_back(ValueStackItem());
-   if (monitor_callback)   monitor_callback(*this, SEV_PUSHED);
+   call_monitor_callback(SEV_PUSHED);
 }
 //-----------------------------------------------------------------------------
 void
@@ -392,7 +432,7 @@ Symbol::push_label(Function_Line label)
       }
 
    value_stack.push_back(ValueStackItem(label));
-   if (monitor_callback)   monitor_callback(*this, SEV_PUSHED);
+   call_monitor_callback(SEV_PUSHED);
 }
 //-----------------------------------------------------------------------------
 void
@@ -410,7 +450,7 @@ ValueStackItem vs;
    else                           vs.name_class = NC_FUNCTION;
    vs.sym_val.function = function;
    value_stack.push_back(vs);
-   if (monitor_callback)   monitor_callback(*this, SEV_PUSHED);
+   call_monitor_callback(SEV_PUSHED);
 }
 //-----------------------------------------------------------------------------
 void
@@ -418,7 +458,7 @@ Symbol::push_value(Value_P value)
 {
 ValueStackItem vs;
    value_stack.push_back(vs);
-   if (monitor_callback)   monitor_callback(*this, SEV_PUSHED);
+   call_monitor_callback(SEV_PUSHED);
    assign(value, LOC);
 
    Log(LOG_SYMBOL_push_pop)
@@ -805,6 +845,7 @@ ValueStackItem & vs = value_stack.back();
    if (vs.name_class == NC_UNUSED_USER_NAME)
       {
         vs.name_class = nc;
+        set_dirty();
         return;
       }
 
@@ -877,6 +918,7 @@ const bool can_set = (vs.name_class == NC_FUNCTION) ||
    vs.sym_val.function = fun;
    if (fun)   vs.name_class = nc;
    else       vs.name_class = NC_UNUSED_USER_NAME;
+   set_dirty();
 }
 //-----------------------------------------------------------------------------
 ostream &
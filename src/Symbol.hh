@@ -160,6 +160,11 @@ public:
    /// Assign \b value to \b this \b Symbol
    virtual void assign(Value_P value, const char * loc);
 
+   /// A←A,B: append \b B to the value of \b this variable in place and
+   /// return the new value. Return an invalid Value_P if that is not
+   /// possible (and the normal A←A,B shall be performed instead).
+   Value_P append_value(const Value & B, const char * loc);
+
    /// Assign \b value to \b this \b Symbol (which is a shared variable)
    void assign_shared_variable(Value_P value, const char * loc);
 
@@ -218,7 +223,16 @@ public:
 
    /// set \b erased to \b on_off
    void set_erased(bool on_off)
-      { erased = on_off; }
+      { erased = on_off;   if (on_off)   set_dirty(); }
+
+   /// return \b true if the global value of \b this Symbol has changed
+   /// since the last )SAVE or )LOAD
+   bool is_dirty() const
+      { return dirty; }
+
+   /// clear the dirty flag (after the symbol was )SAVEd or )LOADed)
+   void clear_dirty()
+      { dirty = false; }
 
    /// Return the current function (or throw a VALUE_ERROR)
    virtual const Function * get_function() const;
@@ -285,7 +299,8 @@ public:
 
    /// call the monitor callback function (if any) with event \b ev
    void call_monitor_callback(Symbol_Event ev)
-      { if (monitor_callback)   monitor_callback(*this, ev); }
+      { if (ev != SEV_POPED)   set_dirty();   // a pop restores a value
+        if (monitor_callback)   monitor_callback(*this, ev); }
 
    /// Compare the name of \b this \b Symbol with \b ucs
    bool equal(const UCS_string & ucs) const
@@ -295,12 +310,25 @@ public:
    Symbol * next;
 
 protected:
+   /// return the value of \b this variable for A[X]←B
+   Value_P get_indexed_value();
+
+   /// set the dirty flag if the global value of \b this Symbol was changed.
+   /// Changes of localized values are lost when the SI is cleared and are
+   /// therefore ignored.
+   void set_dirty()
+      { if (value_stack.size() <= 1)   dirty = true; }
+
    /// The name of \b this \b Symbol
    UCS_string name;
 
    /// \b True if \b this \b Symbol is/was erased
    bool erased;
 
+   /// \b true if the global value of \b this Symbol has changed since the
+   /// last )SAVE or )LOAD (for incremental )SAVEs)
+   bool dirty;
+
    /// called on symbol events (if non-0)
    void (*monitor_callback)(const Symbol &, Symbol_Event sev);
 
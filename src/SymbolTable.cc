@@ -469,6 +469,16 @@ int idx = 0;
 }
 //-----------------------------------------------------------------------------
 void
+SymbolTable::clear_dirty()
+{
+   loop(hash, SYMBOL_HASH_TABLE_SIZE)
+      {
+        for (Symbol * sym = symbol_table[hash]; sym; sym = sym->next)
+            sym->clear_dirty();
+      }
+}
+//-----------------------------------------------------------------------------
+void
 SymbolTable::dump(ostream & out, int & fcount, int & vcount) const
 {
 vector<const Symbol *> symbols;
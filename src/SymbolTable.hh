@@ -149,6 +149,9 @@ public:
    /// return all symbols  (including erased symbols)
    void get_all_symbols(Symbol ** table, int table_size) const;
 
+   /// clear the dirty flags of all symbols (after )SAVE or )LOAD)
+   void clear_dirty();
+
    /// dump symbols to out
    void dump(ostream & out, int & fcount, int & vcount) const;
 
@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include <sys/resource.h>   // for ⎕WA
 #include <sys/time.h>
+#include <unistd.h>         // for ⎕WA
 
 // FreeBSD 8.x lacks utmpx.h
 #ifdef HAVE_UTMPX_H
@@ -1059,57 +1060,45 @@ Quad_WA::get_apl_value() const
 {
 Value_P Z(LOC);
 
+   // the memory used by all values (the Value objects and their long
+   // ravels) is counted as they are created and released, so that ⎕WA is
+   // cheap. Other memory of the interpreter (symbols, functions, the
+   // overhead of the heap, ...) is not counted.
+   //
+const uint64_t used = Value::total_bytes();
 uint64_t total = total_memory;   // max memory as reported by RLIM_INFINITY
-uint64_t proc_mem = 0;            // memory as reported proc/mem_info
+uint64_t free_mem = 0;           // free physical memory (if known)
 
+#ifdef _SC_AVPHYS_PAGES
    {
-     FILE * pm = fopen("/proc/meminfo", "r");
-
-     if (pm)   // /proc/meminfo exists
-        {
-          for (;;)
-              {
-                char buffer[2000];
-                if (fgets(buffer, sizeof(buffer) - 1, pm) == 0)   break;
-                buffer[sizeof(buffer) - 1] = 0;
-                if (!strncmp(buffer, "MemFree:", 8))
-                   {
-                     proc_mem = atoi(buffer + 8);
-                     proc_mem *= 1024;
-                     break;
-                   }
-              }
-
-          fclose(pm);
-        }
+     const long pages = sysconf(_SC_AVPHYS_PAGES);
+     const long page_size = sysconf(_SC_PAGESIZE);
+     if (pages > 0 && page_size > 0)   free_mem = uint64_t(pages) * page_size;
    }
+#endif
 
-   if (proc_mem == 0)   // nothing from /proc/meminfo
+   if (uprefs.workspace_quota)   // per-interpreter quota
       {
-        if (total == RLIM_INFINITY)   // no rlimit
+        total = uprefs.workspace_quota > used ? uprefs.workspace_quota - used
+                                              : 0;
+      }
+   else if (total == RLIM_INFINITY)   // no rlimit
+      {
+        if (free_mem == 0)   // no info about physical memory
            {
              CERR << "Cannot properly determine ⎕WA (process has no memory"
-                     " limit and /proc/meminfo provided no info)" << endl;
+                     " limit and no info about free memory)" << endl;
              total = 1000000;
            }
-        else                          // process has rlimit
+        else
            {
-             total -= Value::total_ravel_count * sizeof(Cell)
-                    + Value::value_count * sizeof(Value);
+             total = free_mem;
            }
       }
-   else
+   else                          // process has rlimit
       {
-        if (total == RLIM_INFINITY)   // no rlimit
-           {
-             total = proc_mem;   // use value from .proc/meminfo
-           }
-        else                          // process has rlimit
-           {
-             total -= Value::total_ravel_count * sizeof(Cell)
-                    + Value::value_count * sizeof(Value);
-             if (total > proc_mem)   total = proc_mem;   // use minimum
-           }
+        total = total > used ? total - used : 0;
+        if (free_mem && total > free_mem)   total = free_mem;   // use minimum
       }
 
    new (&Z->get_ravel(0))   IntCell(total);
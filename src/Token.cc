@@ -390,7 +390,7 @@ Token::print_value(ostream & out) const
         case TOK_APL_VALUE1:
         case TOK_APL_VALUE3:
              {
-               Value_P v = value._apl_val();
+               Value_P v = get_apl_val();
                if (v->get_rank() == 0)   out << "''";
                loop(r, v->get_rank())
                    {
@@ -107,7 +107,7 @@ public:
    Token(TokenTag tg, IndexExpr & idx);
 
    ~Token()
-     { extract_apl_val("~Token()");  }
+     { if (is_apl_val())   extract_apl_val("~Token()");  }
 
    /// return the TokenValueType of this token.
    TokenValueType get_ValueType() const
@@ -181,6 +181,18 @@ public:
    /// return the Value_P value of this token. The token could be TOK_NO_VALUE;
    /// in that case VALUE_ERROR is thrown.
    Value_P get_apl_val() const
+      { if (!is_apl_val())   VALUE_ERROR;
+        return value._apl_val().computed(); }
+
+   /// return the Value_P value of this token, even if it is lazy (i.e.
+   /// its ravel was not yet computed, see Value::is_lazy()).
+   Value_P get_lazy_apl_val() const
+      { if (!is_apl_val())   VALUE_ERROR;
+        return value._apl_val().computed(true); }
+
+   /// return the Value_P value of this token, even if it is lazy or fused
+   /// (see Value::is_lazy() and Value::is_fused()).
+   Value_P get_deferred_apl_val() const
       { if (!is_apl_val())   VALUE_ERROR;   return value._apl_val(); }
 
    /// return the address of the Value_P value of this token.
@@ -201,11 +213,11 @@ public:
    /// return the axis specification of this token (expect non-zero axes)
    Value_P get_nonzero_axes() const
       { Assert1(!!value._apl_val() && (get_tag() == TOK_AXES));
-        return value._apl_val(); }
+        return value._apl_val().computed(); }
 
    /// return the axis specification of this token
    Value_P get_axes() const
-      { Assert1(get_tag() == TOK_AXES);  return value._apl_val(); }
+      { Assert1(get_tag() == TOK_AXES);  return value._apl_val().computed(); }
 
    /// set the Value_P value of this token
    void set_apl_val(Value_P val)
@@ -18,7 +18,10 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <float.h>
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "Common.hh"
@@ -109,112 +112,208 @@ UCS_string::UCS_string(const UTF8_string & utf)
    Log(LOG_char_conversion)
       CERR << "UCS_string::UCS_string(): ucs = " << *this << endl;
 }
+//=============================================================================
+// decimal digits of APL_Float values. The digits are obtained by scaling the
+// value with a power of 10 in long double precision and rounding the scaled
+// value to an integer. The (rare) cases where the scaled value is too close
+// to a rounding boundary for that are resolved with snprintf(), which is
+// exact but much slower.
 //-----------------------------------------------------------------------------
-UCS_string::UCS_string(APL_Float value, bool & scaled,
-                       const PrintContext & pctx)
-   : Simple_string<Unicode>(0, 0)
+/// powers of 10 that are exact doubles
+static const double exact_pow10[] =
 {
-int quad_pp = pctx.get_PP();
-   if (quad_pp > MAX_Quad_PP)   quad_pp = MAX_Quad_PP;
-   if (quad_pp < MIN_Quad_PP)   quad_pp = MIN_Quad_PP;
+  1E0,  1E1,  1E2,  1E3,  1E4,  1E5,  1E6,  1E7,  1E8,  1E9,  1E10, 1E11,
+  1E12, 1E13, 1E14, 1E15, 1E16, 1E17, 1E18, 1E19, 1E20, 1E21, 1E22
+};
 
-const bool negative = (value < 0);
-   if (negative)   value = -value;
+/// integer powers of 10
+static const uint64_t int_pow10[] =
+{
+                    1ULL,                 10ULL,                 100ULL,
+                 1000ULL,              10000ULL,              100000ULL,
+              1000000ULL,           10000000ULL,           100000000ULL,
+           1000000000ULL,        10000000000ULL,        100000000000ULL,
+        1000000000000ULL,     10000000000000ULL,     100000000000000ULL,
+     1000000000000000ULL,  10000000000000000ULL,  100000000000000000ULL,
+  1000000000000000000ULL
+};
+
+/// return 10^k (k ≥ 0) as long double (exact for k ≤ 27)
+static inline long double
+pow10_ld(int k)
+{
+static const long double exact[] =
+{
+  1E0L,  1E1L,  1E2L,  1E3L,  1E4L,  1E5L,  1E6L,  1E7L,  1E8L,  1E9L,
+  1E10L, 1E11L, 1E12L, 1E13L, 1E14L, 1E15L, 1E16L, 1E17L, 1E18L, 1E19L,
+  1E20L, 1E21L, 1E22L, 1E23L, 1E24L, 1E25L, 1E26L, 1E27L
+};
 
-int expo = 0;
+   if (k < int(sizeof(exact)/sizeof(*exact)))   return exact[k];
+   return powl(10.0L, k);
+}
+//-----------------------------------------------------------------------------
+/// return an estimate (possibly 1 too small) of the decimal exponent of
+/// \b value > 0, i.e. of ⌊10⍟value
+static inline int
+decimal_expo(APL_Float value)
+{
+int e2;
+   frexp(value, &e2);   // value = m × 2^e2 with 0.5 ≤ m < 1
+   return int(floor((e2 - 1) * 0.30102999566398119521));   // × 10⍟2
+}
+//-----------------------------------------------------------------------------
+/// return \b value × 10^k rounded half up. The result must be < 1E18.
+static uint64_t
+round_scaled(APL_Float value, int k)
+{
+const long double scaled = k >= 0 ? value * pow10_ld(k)
+                                  : value / pow10_ld(-k);
+   if (isfinite(scaled))
+      {
+        // scaled has a (relative) error of at most a few ulps
+        const long double floor_scaled = floorl(scaled);
+        const long double fract = scaled - floor_scaled;
+        const long double uncertain = scaled * (16*LDBL_EPSILON);
+        if (fract < 0.5L - uncertain)   return uint64_t(floor_scaled);
+        if (fract > 0.5L + uncertain)   return uint64_t(floor_scaled) + 1;
+      }
 
-   if (value >= 10.0)   // large number, positive exponent
+   // scaled is too close to ….5 to decide. snprintf() prints the exact
+   // decimal expansion of value, and 40 digits beyond the rounded digit
+   // are enough to tell an exact tie from a near one.
+   //
+char buffer[100];
+   snprintf(buffer, sizeof(buffer), "%.60e", double(value));
+const char * e = strchr(buffer, 'e');
+const int int_digits = atoi(e + 1) + 1 + k;   // integer digits of scaled
+   if (int_digits < 0)   return 0;
+
+uint64_t ret = 0;
+const char * b = buffer;
+   loop(d, int_digits)
       {
-       while (value >= 1e16)
-             {
-               if (value > 1e307)
-                  {
-                    if (negative)   append_utf8("¯∞");
-                    else            append_utf8("∞");
-                    FloatCell::map_FC(*this);
-                    return;
-                  }
-               value *= 1e-16;   expo += 16;
-             }
-       while (value >= 1e4)    { value *= 1e-4;    expo +=  4; }
-       while (value >= 1e1)    { value *= 1e-1;    ++expo;     }
+        if (*b == '.')   ++b;
+        ret = 10*ret + (*b++ - '0');
       }
-   else if (value < 1.0)   // small number, negative exponent
+   if (*b == '.')   ++b;
+   if (*b >= '5')   ++ret;
+   return ret;
+}
+//-----------------------------------------------------------------------------
+/// round \b value > 0 to \b n ≤ MAX_Quad_PP significant digits (half up).
+/// On entry \b expo is an estimate of the decimal exponent of \b value, on
+/// return the decimal exponent of the rounded value. Return the digits as
+/// an integer 10^(n-1) ≤ M < 10^n.
+static uint64_t
+round_digits(APL_Float value, int n, int & expo)
+{
+   for (;;)
+       {
+         const uint64_t M = round_scaled(value, n - 1 - expo);
+         if (M < int_pow10[n - 1])   { --expo;   continue; }   // expo too big
+         if (M > int_pow10[n])       { ++expo;   continue; }   // expo too small
+         if (M == int_pow10[n])      { ++expo;   return int_pow10[n - 1]; }
+         return M;
+       }
+}
+//-----------------------------------------------------------------------------
+/// return \b true if M × 10^-k converts back to \b value
+static bool
+round_trips(APL_Float value, uint64_t M, int k)
+{
+   if (M < (1ULL << 53))   // M and 10^|k| are exact: one rounding only
       {
-       while (value < 1e-16)
-             {
-               if (value < 1e-305)   // very small number: make it 0
-                  {
-                    append(UNI_ASCII_0);
-                    return;
-                  }
-               value *= 1e16;   expo -= 16;
-             }
-       while (value < 1e-4)    { value *= 1e4;    expo -=  4; }
-       while (value < 1.0)     { value *= 10.0;   --expo;     }
+        if (k >= 0 && k <= 22)    return double(M) / exact_pow10[k]  == value;
+        if (k < 0  && k >= -22)   return double(M) * exact_pow10[-k] == value;
       }
 
-   // In theory, at this point, 1.0 ≤ value < 10.0. In reality value can
-   // be outside, though, due to rounding errors.
+char buffer[40];
+   snprintf(buffer, sizeof(buffer), "%llue%d", (unsigned long long)M, -k);
+   return strtod(buffer, 0) == value;
+}
+//-----------------------------------------------------------------------------
+/// store the significant digits of \b value > 0, rounded to \b max_digits
+/// digits, into \b digits and return their number (trailing zeros removed).
+/// If \b shortest is set and \b max_digits exceeds 15 then the shortest
+/// number of digits (≤ max_digits) that converts back to \b value is used
+/// instead (so that e.g. 0.1 is not shown as 0.10000000000000001). \b expo
+/// is set to the decimal exponent of the first digit.
+static int
+float_digits(APL_Float value, int max_digits, char * digits, int & expo,
+             bool shortest)
+{
+   if (max_digits > MAX_Quad_PP)   max_digits = MAX_Quad_PP;
 
-   // create a string with quad_pp + 1 significant digits.
-   // The last digit is used for rounding and then discarded.
-   //
-UCS_string digits;
-   loop(d, (quad_pp + 2))
-      {
-        if (value >= 10.0)
-           {
-             digits.append((Unicode)(10 + '0'));
-             value = 0.0;
-           }
-        else if (value < 0.0)
-           {
-             digits.append((Unicode)('0'));
-             value = 0.0;
-           }
-        else
-           {
-             const int dig = (int)value;
-             value -= dig;
-             value *= 10;
-             digits.append((Unicode)(dig + '0'));
-           }
-      }
+   expo = decimal_expo(value);
+int n = (max_digits <= 15 || !shortest) ? max_digits : 15;
+uint64_t M = round_digits(value, n, expo);
+   while (n < max_digits && !round_trips(value, M, n - 1 - expo))
+         M = round_digits(value, ++n, expo);
 
-   if (digits[0] != '0')   digits.pop();
+   for (int d = n - 1; d >= 0; --d)   { digits[d] = '0' + M % 10;   M /= 10; }
+   while (n > 1 && digits[n - 1] == '0')   --n;
+   return n;
+}
+//-----------------------------------------------------------------------------
+/// return the digit at position 10^p of the number with significant
+/// \b digits and decimal exponent \b expo
+static inline Unicode
+digit_at(const char * digits, int len, int expo, int p)
+{
+const int d = expo - p;
+   return (d >= 0 && d < len) ? Unicode(digits[d]) : UNI_ASCII_0;
+}
+//-----------------------------------------------------------------------------
+/// append \b value (given by its \b len significant \b digits and decimal
+/// exponent \b expo) in fixed point format with \b fract_digits fractional
+/// digits to \b ucs.
+static void
+append_fixed(UCS_string & ucs, const char * digits, int len, int expo,
+             int fract_digits)
+{
+   if (expo < 0)   ucs.append(UNI_ASCII_0);
+   for (int p = expo; p >= 0; --p)   ucs.append(digit_at(digits, len, expo, p));
 
-   // round last digit
-   //
-const Unicode last = digits.last();
-   digits.pop();
+   if (fract_digits == 0)   return;
 
-   if (last >= '5')   digits.last() = (Unicode)(digits.last() + 1);
- 
-   // adjust carries of 2nd to last digit
-   //
-   for (int d = digits.size() - 1; d > 0; --d)   // all but first
-       {
-        if (digits[d] > '9')
-           {
-             digits[d] =     (Unicode)(digits[d]     - 10);
-             digits[d - 1] = (Unicode)(digits[d - 1] +  1);
-           }
-       }
+   ucs.append(UNI_ASCII_FULLSTOP);
+   for (int p = -1; p >= -fract_digits; --p)
+       ucs.append(digit_at(digits, len, expo, p));
+}
+//-----------------------------------------------------------------------------
+UCS_string::UCS_string(APL_Float value, bool & scaled,
+                       const PrintContext & pctx)
+   : Simple_string<Unicode>(0, 0)
+{
+int quad_pp = pctx.get_PP();
+   if (quad_pp > MAX_Quad_PP)   quad_pp = MAX_Quad_PP;
+   if (quad_pp < MIN_Quad_PP)   quad_pp = MIN_Quad_PP;
 
-   // adjust carry of 1st digit
-   //
-   if (digits[0] > '9')
+const bool negative = (value < 0);
+   if (negative)   value = -value;
+
+   if (value > 1e307)
+      {
+        if (negative)   append_utf8("¯∞");
+        else            append_utf8("∞");
+        FloatCell::map_FC(*this);
+        return;
+      }
+
+   if (value < 1e-305)   // very small number: make it 0
       {
-        digits[0] = (Unicode)(digits[0] - 10);
-        digits.insert_before(0, UNI_ASCII_1);
-        ++expo;
-        digits.pop();
+        append(UNI_ASCII_0);
+        return;
       }
 
-   // remove trailing zeros
+char digits[MAX_Quad_PP];
+int expo;
+   // ⎕PP 16 shows the shortest digits that read back as value,
+   // ⎕PP 17 (MAX_Quad_PP) all 17 significant digits.
    //
-   while (digits.size() && digits.last() == UNI_ASCII_0)   digits.pop();
+const int len = float_digits(value, quad_pp, digits, expo,
+                             quad_pp < MAX_Quad_PP);
 
    // force scaled format if:
    //
@@ -227,11 +326,11 @@ const Unicode last = digits.last();
 
    if (scaled)
       {
-        append(digits[0]);       // integer part
-        if (digits.size() > 1)   // fractional part
+        append(Unicode(digits[0]));   // integer part
+        if (len > 1)                  // fractional part
            {
              append(UNI_ASCII_FULLSTOP);
-             loop(d, (digits.size() - 1))   append(digits[d + 1]);
+             loop(d, (len - 1))   append(Unicode(digits[d + 1]));
            }
         if (expo < 0)
            {
@@ -252,31 +351,10 @@ const Unicode last = digits.last();
       }
    else
       {
-        if (expo < 0)   // 0.000...
-           {
-             append(UNI_ASCII_0);
-             append(UNI_ASCII_FULLSTOP);
-             loop(e, (-(expo + 1)))   append(UNI_ASCII_0);
-             append(digits);
-           }
-        else   // expo >= 0
-           {
-             loop(e, expo + 1)
-                {
-                  if (e < digits.size())   append(digits[e]);
-                  else                     append(UNI_ASCII_0);
-                }
-
-             if ((expo + 1) < digits.size())   // there are fractional digits
-                {
-                  append(UNI_ASCII_FULLSTOP);
-                  for (int e = expo + 1; e < digits.size(); ++e)
-                     {
-                       if (e < digits.size())   append(digits[e]);
-                       else                     break;
-                     }
-                }
-           }
+        // the fractional digits (if any) of the len digits
+        const int fract_digits = len - 1 - expo;
+        append_fixed(*this, digits, len, expo,
+                     fract_digits > 0 ? fract_digits : 0);
       }
 
    FloatCell::map_FC(*this);
@@ -907,33 +985,6 @@ UCS_string ret;
 }
 //-----------------------------------------------------------------------------
 UCS_string
-UCS_string::from_big(double & val)
-{
-   Assert(val >= 0);
-
-long double value = val;
-int digits[320];   // DBL_MAX is 1.79769313486231470E+308
-int * d = digits;
-
-const long double initial_fract = modf(value, &value);
-long double fract;
-   for (; value >= 1.0; ++d)
-      {
-         fract = modf(value / 10.0, &value);   // U.x -> .U
-         *d = (int)((fract + .02) * 10.0);
-         fract -= 0.1 * *d;
-      }
-
-   val = initial_fract;
-
-UCS_string ret;
-   if (d == digits)   ret.append(UNI_ASCII_0);   // 0.xxx
-
-   while (d > digits)   ret.append(Unicode(UNI_ASCII_0 + *--d));
-   return ret;
-}
-//-----------------------------------------------------------------------------
-UCS_string
 UCS_string::from_double_expo_prec(double v, int fract_digits)
 {
 UCS_string ret;
@@ -953,92 +1004,25 @@ UCS_string ret;
 
    if (v < 0)   { ret.append(UNI_OVERBAR);   v = - v; }
 
-int expo = 0;
-   while (v >= 1.0E1)
+char digits[MAX_Quad_PP];
+int expo;
+int len;
+   if (fract_digits < MAX_Quad_PP)   // round to fract_digits + 1 digits
       {
-        if (v >= 1.0E9)
-           if (v >= 1.0E13)
-              if (v >= 1.0E15)
-                 if     (v >= 1.0E16)      { v *= 1.0E-16;   expo += 16; }
-                 else /* v >= 1.0E15 */    { v *= 1.0E-15;   expo += 15; }
-              else
-                 if     (v >= 1.0E14)      { v *= 1.0E-14;   expo += 14; }
-                 else /* v >= 1.0E13 */    { v *= 1.0E-13;   expo += 13; }
-           else
-              if (v >= 1.0E11)
-                 if     (v >= 1.0E12)      { v *= 1.0E-12;   expo += 12; }
-                 else /* v >= 1.0E11 */    { v *= 1.0E-11;   expo += 11; }
-              else
-                 if     (v >= 1.0E10)      { v *= 1.0E-10;   expo += 10; }
-                 else /* v >= 1.0E9 */     { v *= 1.0E-9;    expo += 9;  }
-        else
-           if (v >= 1.0E5)
-              if (v >= 1.0E7)
-                 if     (v >= 1.0E8)       { v *= 1.0E-8;    expo += 8;  }
-                 else /* v >= 1.0E7 */     { v *= 1.0E-7;    expo += 7;  }
-              else
-                 if     (v >= 1.0E6)       { v *= 1.0E-6;    expo += 6;  }
-                 else /* v >= 1.0E5 */     { v *= 1.0E-5;    expo += 5;  }
-           else
-              if (v >= 1.0E3)
-                 if     (v >= 1.0E4)       { v *= 1.0E-4;    expo += 4;  }
-                 else /* v >= 1.0E3 */     { v *= 1.0E-3;    expo += 3;  }
-              else
-                 if     (v >= 1.0E2)       { v *= 1.0E-2;    expo += 2;  }
-                 else /* v >= 1.0E1 */     { v *= 1.0E-1;    expo += 1;  }
+        expo = decimal_expo(v);
+        uint64_t M = round_digits(v, fract_digits + 1, expo);
+        len = fract_digits + 1;
+        for (int d = len - 1; d >= 0; --d)
+            { digits[d] = '0' + M % 10;   M /= 10; }
       }
-
-   while (v < 1.0E0)
+   else                              // all digits (and pad with 0)
       {
-        if (v < 1.0E-8)
-           if (v < 1.0E-12)
-              if (v < 1.0E-14)
-                 if     (v < 1.0E-15)      { v *= 1.0E-16;   expo += 16; }
-                 else /* v < 1.0E-14 */    { v *= 1.0E-15;   expo += 15; }
-              else
-                 if     (v < 1.0E-13)      { v *= 1.0E-14;   expo += 14; }
-                 else /* v < 1.0E-12 */    { v *= 1.0E-13;   expo += 13; }
-           else
-              if (v < 1.0E-10)
-                 if     (v < 1.0E-11)      { v *= 1.0E12;   expo += -12; }
-                 else /* v < 1.0E-10 */    { v *= 1.0E11;   expo += -11; }
-              else
-                 if     (v < 1.0E-9 )      { v *= 1.0E10;   expo += -10; }
-                 else /* v < 1.0E-8 */     { v *= 1.0E9;    expo += -9;  }
-        else
-           if (v < 1.0E-4)
-              if (v < 1.0E-6)
-                 if     (v < 1.0E-7)       { v *= 1.0E8;    expo += -8;  }
-                 else /* v < 1.0E-6 */     { v *= 1.0E7;    expo += -7;  }
-              else
-                 if     (v < 1.0E-5)       { v *= 1.0E6;    expo += -6;  }
-                 else /* v < 1.0E-4 */     { v *= 1.0E5;    expo += -5;  }
-           else
-              if (v < 1.0E-2)
-                 if     (v < 1.0E-3)       { v *= 1.0E4;    expo += -4;  }
-                 else /* v < 1.0E-2 */     { v *= 1.0E3;    expo += -3;  }
-              else
-                 if     (v < 1.0E-1)       { v *= 1.0E2;    expo += -2;  }
-                 else /* v < 1.0E0  */     { v *= 1.0E1;    expo += -1;  }
+        len = float_digits(v, MAX_Quad_PP, digits, expo, true);
       }
 
-   Assert(v >= 1.0);
-   Assert(v < 10.0);
-
    // print mantissa in fixed format
    //
-UCS_string mantissa = from_double_fixed_prec(v, fract_digits);
-   if (mantissa.size() > 2 &&
-       mantissa[0] == UNI_ASCII_1 &&
-       mantissa[1] == UNI_ASCII_0 &&
-       mantissa[2] == UNI_ASCII_FULLSTOP)   // 9.xxx rounded up to 10.xxx
-      {
-        mantissa[1] = UNI_ASCII_FULLSTOP;
-        mantissa[2] = UNI_ASCII_0;
-       ++expo;
-      }
-       
-   ret.append(mantissa);
+   append_fixed(ret, digits, len, 0, fract_digits);
    ret.append(UNI_ASCII_E);
    ret.append(from_int(expo));
 
@@ -1052,56 +1036,36 @@ UCS_string ret;
 
    if (v < 0)   { ret.append(UNI_OVERBAR);   v = - v; }
 
-   // in the loop below, there could be rounding errors when casting float
-   // to int. We therefore increase v slighly (by 0.3 of the rounded digit)
-   // to avoid that.
-   //
-   v += 0.03 * pow(10.0, -fract_digits);
-
-   ret.append(from_big(v));   // leaves fractional part of v in v
-
-   ret.append(UNI_ASCII_FULLSTOP);
-
-   loop(f, fract_digits + 1)
+   if (v == 0.0)   // all digits 0
       {
-        v *= 10;
-        const int vv = v;   // subject to rounding errors!
-        ret.append(Unicode(UNI_ASCII_0 + vv));
-        v -= vv;
+        append_fixed(ret, 0, 0, 0, fract_digits);
+        return ret;
       }
 
-   ret.round_last_digit();
-   return ret;
-}
-//-----------------------------------------------------------------------------
-void
-UCS_string::round_last_digit()
-{
-   Assert1(size() > 1);
-   if (back() >= UNI_ASCII_5)   // round up
+char digits[20];
+int expo = decimal_expo(v);
+int len;
+   if (expo + fract_digits < 16)   // v × 10^fract_digits < 10^17
       {
-        for (int q = size() - 2; q >= 0; --q)
-            {
-              const Unicode cc = items[q];
-              if (cc < UNI_ASCII_0)   continue;   // not a digit
-              if (cc > UNI_ASCII_9)   continue;   // not a digit
-
-              items[q] = Unicode(cc + 1);   // round up
-              if (cc != UNI_ASCII_9)   break;    // 0-8 rounded up: stop
-
-              items[q] = UNI_ASCII_0;    // 9 rounded up: say 0 and repeat
-              if (q)   continue;   // not first difit
-
-              // something like 9.xxx has been rounded up to, say, 0.xxx
-              // but should be 10.xxx Fix it.
-              //
-              for (int d = size() - 1; d > 0; --d)   items[d] = items[d - 1];
-              items[0] = UNI_ASCII_1;
-            }
+        // round v to a multiple of 10^-fract_digits
+        //
+        uint64_t M = round_scaled(v, fract_digits);
+        for (len = 0; M; ++len)   { digits[len] = '0' + M % 10;   M /= 10; }
+        loop(d, len/2)
+           {
+             const char tmp = digits[d];
+             digits[d] = digits[len - d - 1];
+             digits[len - d - 1] = tmp;
+           }
+        expo = len - 1 - fract_digits;
+      }
+   else   // more digits than a double has: the shortest digits and 0s
+      {
+        len = float_digits(v, MAX_Quad_PP, digits, expo, true);
       }
 
-   shrink(size() - 1);
-   if (items[size() - 1] == UNI_ASCII_FULLSTOP)   shrink(size() - 1);
+   append_fixed(ret, digits, len, expo, fract_digits);
+   return ret;
 }
 //----------------------------------------------------------------------------
 bool
@@ -264,9 +264,6 @@ public:
    UCS_string::iterator begin() const
       { return iterator(*this, 0); }
 
-   /// round last digit and discard it.
-   void round_last_digit();
-
    /// return true if \b this string contains \b uni
    bool contains(Unicode uni);
 
@@ -282,10 +279,6 @@ public:
    /// convert an unsigned integer value to an UCS_string (like sprintf())
    static UCS_string from_uint(uint64_t value);
 
-   /// convert the integer part of value to an UCS_string and remove it
-   /// from value
-   static UCS_string from_big(double & value);
-
    /// convert double \b value to an UCS_string with \b fract_digits fractional
    /// digits in scaled (exponential) format
    static UCS_string from_double_expo_prec(double value, int fract_digits);
@@ -143,6 +143,30 @@ UserFunction::eval_()
    return Token(TOK_SI_PUSHED);
 }
 //-----------------------------------------------------------------------------
+bool
+UserFunction::tail_call()
+{
+StateIndicator * si = Workspace::SI_top();
+   if (si == 0)                                         return false;
+   if (si->get_executable() != this)                    return false;
+   if (si->get_eoc_handlers())                          return false;
+   if (si->get_safe_execution())                        return false;
+   if (attention_raised)                                return false;
+   if (!si->get_prefix().is_tail_call(this, header.Z()))   return false;
+
+   Log(LOG_optimization)   CERR << "optimizing tail call of "
+                                << get_name() << endl;
+
+   // our caller is (another instance of) ourselves and it would return our
+   // result unchanged. Discard its local variables and let it start over
+   // with the new arguments instead of pushing a new SI entry.
+   //
+   header.pop_local_vars();
+   si->fun_oper_cache.reset();
+   si->get_prefix().restart_body();
+   return true;
+}
+//-----------------------------------------------------------------------------
 Token
 UserFunction::eval_B(Value_P B)
 {
@@ -154,7 +178,7 @@ UserFunction::eval_B(Value_P B)
 
    if (header.LO())    SYNTAX_ERROR;   // defined as operator
 
-   Workspace::push_SI(this, LOC);
+   if (!tail_call())   Workspace::push_SI(this, LOC);
 
    if (header.Z())   header.Z()->push();
    if (header.A())   header.A()->push();
@@ -202,7 +226,7 @@ UserFunction::eval_AB(Value_P A, Value_P B)
    if (header.LO())    SYNTAX_ERROR;    // defined as operator
    if (!header.A())    VALENCE_ERROR;   // monadic
 
-   Workspace::push_SI(this, LOC);
+   if (!tail_call())   Workspace::push_SI(this, LOC);
 
    if (header.Z())   header.Z()->push();
    if (header.A())   header.A()->push_value(A);
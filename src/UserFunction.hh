@@ -239,6 +239,12 @@ protected:
    /// overladed Function::may_push_SI()
    virtual bool may_push_SI() const   { return true; }
 
+   /// if \b this function is called in tail position from its own SI entry
+   /// (i.e. recursively as Z←fun B or Z←A fun B followed by the return of Z)
+   /// then pop the local variables of that SI entry and let it restart its
+   /// body (instead of pushing a new SI entry). Return true if so.
+   bool tail_call();
+
    /// Overloaded Function::eval_fill_B()
    virtual Token eval_fill_B(Value_P B);
 
@@ -292,6 +292,7 @@ const int sc100_tc = sym_count * 100 + tos_idx;
       }
 
    remove_duplicate_local_variables();
+   make_pop_plan();
 
    error_info = 0;
    error = E_NO_ERROR;
@@ -336,6 +337,7 @@ bool valid_signature = false;
    if (sig & SIG_RO)   sym_RO = &Workspace::get_v_OMEGA_U();
    if (sig & SIG_B)    sym_B  = &Workspace::get_v_OMEGA();
    if (sig & SIG_X)    sym_X  = &Workspace::get_v_CHI();
+   make_pop_plan();
 
    error_info = 0;
    error = E_NO_ERROR;
@@ -344,16 +346,21 @@ bool valid_signature = false;
 void
 UserFunction_header::pop_local_vars() const
 {
-   loop(l, label_values.size())   label_values[l].sym->pop();
-
-   loop(l, local_vars.size())   local_vars[l]->pop();
-
-   if (sym_B)    sym_B ->pop();
-   if (sym_X)    sym_X ->pop();
-   if (sym_RO)   sym_RO->pop();
-   if (sym_LO)   sym_LO->pop();
-   if (sym_A)    sym_A ->pop();
-   if (sym_Z)    sym_Z ->pop();
+   for (size_t p = pop_plan.size(); p > 0;)   pop_plan[--p]->pop();
+}
+//-----------------------------------------------------------------------------
+void
+UserFunction_header::make_pop_plan()
+{
+   pop_plan.clear();
+   if (sym_Z)    pop_plan.push_back(sym_Z);
+   if (sym_A)    pop_plan.push_back(sym_A);
+   if (sym_LO)   pop_plan.push_back(sym_LO);
+   if (sym_RO)   pop_plan.push_back(sym_RO);
+   if (sym_X)    pop_plan.push_back(sym_X);
+   if (sym_B)    pop_plan.push_back(sym_B);
+   loop(l, local_vars.size())     pop_plan.push_back(local_vars[l]);
+   loop(l, label_values.size())   pop_plan.push_back(label_values[l].sym);
 }
 //-----------------------------------------------------------------------------
 void
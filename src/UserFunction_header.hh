@@ -117,6 +117,7 @@ public:
       {
         labVal label = { sym, line };
         label_values.push_back(label);
+        pop_plan.push_back(sym);
       }
 
    /// Check that all function params, local vars. and labels are unique.
@@ -176,6 +177,14 @@ protected:
 
    /// The labels of \b this function.
    vector<labVal> label_values;
+
+   /// the symbols pushed when \b this function is called (Z, A, LO, RO, X,
+   /// B, local variables, and labels), so that they can be popped in one
+   /// loop (in reverse order) when the function returns.
+   vector<Symbol *> pop_plan;
+
+   /// compute pop_plan from the symbols of the header
+   void make_pop_plan();
 };
 //-----------------------------------------------------------------------------
 
@@ -18,12 +18,16 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <sys/time.h>
 #include <unistd.h>
 
+#include <fstream>
+
 #include "../config.h"
 
 #include "buildtag.hh"
@@ -82,6 +86,7 @@ char cc[4000];
 #endif
 
    snprintf(cc, sizeof(cc),
+"    --calibrate          calibrate (and save) parallel thresholds\n"
 "    --cfg                show ./configure options used and exit\n"
 "    --noCIN              do not echo input(for scripting)\n"
 "    --echoCIN            echo (final) input to COUT\n"
@@ -264,6 +269,12 @@ UserPreferences::parse_argv_2(bool logit)
               continue;
             }
 #endif
+         if (!strcmp(opt, "--calibrate"))
+            {
+              calibrate_parallel = true;
+              continue;
+            }
+
          if (!strcmp(opt, "--cfg"))
             {
               show_configure_options();
@@ -1161,6 +1172,16 @@ int file_profile = 0;   // the current profile in the preferences file
             {
               backup_before_save = yes;
             }
+         else if (!strcasecmp(opt, "INCREMENTAL_SAVE"))
+            {
+              incremental_save = atoi(arg);
+              if (incremental_save < 0)   incremental_save = 0;
+            }
+         else if (!strcasecmp(opt, "WORKSPACE_QUOTA"))
+            {
+              const int mb = atoi(arg);
+              workspace_quota = mb > 0 ? 1024*1024*uint64_t(mb) : 0;
+            }
          else if (!strcasecmp(opt, "KEYBOARD_LAYOUT_FILE"))
             {
               keyboard_layout_file = UTF8_string(arg);
@@ -1251,6 +1272,62 @@ int line = 0;
 }
 //-----------------------------------------------------------------------------
 void
+UserPreferences::write_threshold_file(ostream & out)
+{
+const char * HOME = getenv("HOME");
+   if (HOME == 0)
+      {
+        out << "environment variable 'HOME' is not defined!" << endl;
+        return;
+      }
+
+   // use $HOME/.gnu-apl if it exists (and $HOME/.config/gnu-apl otherwise)
+   // like open_user_file() does.
+   //
+char filename[APL_PATH_MAX + 1];
+   snprintf(filename, APL_PATH_MAX, "%s/.gnu-apl", HOME);
+   filename[APL_PATH_MAX] = 0;
+   if (access(filename, F_OK) != 0)   // directory does not exist
+      {
+        snprintf(filename, APL_PATH_MAX, "%s/.config", HOME);
+        mkdir(filename, 0755);
+        snprintf(filename, APL_PATH_MAX, "%s/.config/gnu-apl", HOME);
+        mkdir(filename, 0755);
+      }
+
+   strncat(filename, "/parallel_thresholds", APL_PATH_MAX - strlen(filename));
+
+ofstream outf(filename, ofstream::out);
+   if (!outf.is_open())
+      {
+        out << "opening " << filename
+            << " failed: " << strerror(errno) << endl;
+        return;
+      }
+
+   outf << "#" << endl
+        << "# parallel thresholds for "
+        << Thread_context::get_active_core_count() << " cores" << endl
+        << "# (written by ]PSTAT CALIBRATE or apl --calibrate)" << endl
+        << "#" << endl;
+
+#define perfo_1(bif, ab, name, _thr)                             \
+   outf << "perfo_1(" #bif ", " #ab ", \"" name "\", "              \
+        << Bif_ ## bif::fun->get_monadic_threshold() << ")" << endl;
+
+#define perfo_2(bif, ab, name, _thr)                             \
+   outf << "perfo_2(" #bif ", " #ab ", \"" name "\", "              \
+        << Bif_ ## bif::fun->get_dyadic_threshold() << ")" << endl;
+
+#define perfo_3(bif, ab, _name, _thr)
+#define perfo_4(bif, ab, _name, _thr)
+
+#include "Performance.def"
+
+   out << "Parallel thresholds written to file " << filename << endl;
+}
+//-----------------------------------------------------------------------------
+void
 UserPreferences::set_threshold(Function * fun, int ab, int i_ab,
                                ShapeItem threshold)
 {
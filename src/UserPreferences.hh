@@ -52,12 +52,15 @@ struct UserPreferences
      randomize_testfiles(false),
      user_profile(0),
      backup_before_save(false),
+     incremental_save(0),
+     workspace_quota(0),
      script_argc(0),
      line_history_path(".apl.history"),
      line_history_len(500),
      nabla_to_history(1),   // if function was modified
      control_Ds_to_exit(0),
-     raw_cin(false)
+     raw_cin(false),
+     calibrate_parallel(false)
    {}
 
    /// read a \b preference file and update parameters set there
@@ -66,6 +69,10 @@ struct UserPreferences
    /// read a \b parallel_thresholds file and update parameters set there
    void read_threshold_file(bool sys, bool log_startup);
 
+   /// write the current parallel thresholds to the user's
+   /// \b parallel_thresholds file
+   void write_threshold_file(ostream & out);
+
    /// print possible command line options and exit
    static void usage(const char * prog);
 
@@ -161,6 +168,13 @@ struct UserPreferences
    /// backup on )SAVE
    bool backup_before_save;
 
+   /// the max. number of incremental )SAVEs between two full )SAVEs
+   /// (0 = always save the full workspace)
+   int incremental_save;
+
+   /// the max. number of bytes used by all APL values (0 = no limit)
+   uint64_t workspace_quota;
+
    /// the argument number of the APL script name (if run from a script)
    /// in expanded_argv, or 0 if apl is started directly.
    int script_argc;
@@ -183,6 +197,9 @@ struct UserPreferences
    /// send no ESC sequences on stderr
    bool raw_cin;
 
+   /// calibrate the parallel thresholds at start-up (--calibrate)
+   bool calibrate_parallel;
+
 protected:
    /// open a user-supplied config file (in $HOME or gnu-apl.d)
    FILE * open_user_file(const char * fname, char * opened_filename,
@@ -18,7 +18,9 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <sys/mman.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #include "CDR_string.hh"
 #include "CharCell.hh"
@@ -35,9 +37,11 @@
 #include "PointerCell.hh"
 #include "Parallel.hh"
 #include "PrintOperator.hh"
+#include "ScalarFusion.hh"
 #include "SystemVariable.hh"
 #include "UCS_string.hh"
 #include "UserFunction.hh"
+#include "UserPreferences.hh"
 #include "Value.icc"
 #include "ValueHistory.hh"
 #include "Workspace.hh"
@@ -58,7 +62,7 @@ Value::init_ravel()
    pointer_cell_count = 0;
    nz_subcell_count = 0;
 
-   ++value_count;
+   VALUE_LOCK(++value_count)
    if (Quad_SYL::value_count_limit &&
        Quad_SYL::value_count_limit < value_count)
       {
@@ -80,37 +84,27 @@ Value::init_ravel()
       }
 
 const ShapeItem length = shape.get_volume();
+   ravel_capacity = 0;
 
    if (length > SHORT_VALUE_LENGTH_WANTED)
       {
-        total_ravel_count += length;
-        if (Quad_SYL::ravel_count_limit &&
-            Quad_SYL::ravel_count_limit < total_ravel_count)
+        if (ravel_count_limit_reached(length, true))
            {
-             total_ravel_count -= length;
-
              // make sure that the value is properly initialized
              //
              ravel = short_value;
              new (&shape) Shape();
              new (ravel)   IntCell(42);
-
-             Workspace::more_error() = UCS_string(
-             "the system limit on the total ravel size (as set in ⎕SYL) "
-             "was reached\n(and to avoid lock-up, the limit in ⎕SYL "
-             "was automatically cleared).");
-
-             // reset the limit so that we don't get stuck here.
-             //
-             Quad_SYL::ravel_count_limit = 0;
-             attention_raised = interrupt_raised = true;
            }
 
+        // the ravel is deliberately left uninitialized: its pages are then
+        // mapped (first-touch) on the NUMA node of the core that computes
+        // (i.e. writes) them, which is what parallel functions want.
+        //
         try
            {
-             Cell * long_ravel = (Cell *)(new char[length * sizeof(Cell)]);
-//           Cell * long_ravel =  new Cell[length];
-             ravel = long_ravel;
+             ravel = alloc_ravel(length);
+             ravel_capacity = length;
            }
         catch (...)
            {
@@ -234,11 +228,124 @@ const ShapeItem width = pb.get_width(0);
    set_complete();
 }
 //-----------------------------------------------------------------------------
+Value::Value(ShapeItem len, APL_Integer start, APL_Integer step,
+             const char * loc)
+   : DynamicObject(loc, &all_values),
+     flags(VF_NONE),
+     valid_ravel_items(0),
+     lazy_start(start),
+     lazy_step(step)
+{
+   ADD_EVENT(this, VHE_Create, 0, loc);
+   init_ravel();   // as a scalar, i.e. ravel is short_value
+
+   // the ravel is allocated and computed by materialize(). Until then
+   // only the shape, lazy_start, and lazy_step are valid.
+   //
+   new (&get_ravel(0)) IntCell(start);
+   new (&shape) Shape(len);
+   set_lazy();
+   set_complete();
+}
+//-----------------------------------------------------------------------------
+Value::Value(const Shape & sh, ScalarFusion * _fusion, const char * loc)
+   : DynamicObject(loc, &all_values),
+     flags(VF_NONE),
+     valid_ravel_items(0),
+     fusion(_fusion)
+{
+   ADD_EVENT(this, VHE_Create, 0, loc);
+   init_ravel();   // as a scalar, i.e. ravel is short_value
+
+   // the ravel is allocated and computed by materialize()
+   //
+   new (&get_ravel(0)) IntCell(0);
+   new (&shape) Shape(sh);
+   set_fused();
+   set_complete();
+}
+//-----------------------------------------------------------------------------
+Value_P
+Value::progression(ShapeItem len, APL_Integer start, APL_Integer step,
+                   const char * loc)
+{
+   if (len > SHORT_VALUE_LENGTH_WANTED && step != 0)
+      {
+        return Value_P(new Value(len, start, step, loc), loc);
+      }
+
+Value_P Z(len, loc);
+   loop(z, len)   new (Z->next_ravel()) IntCell(start + z*step);
+   Z->set_default_Zero();
+   Z->check_value(loc);
+   return Z;
+}
+//-----------------------------------------------------------------------------
+void
+Value::materialize()
+{
+   Assert(is_lazy() || is_fused());
+   Assert(ravel == short_value);
+
+const ShapeItem length = element_count();
+
+   // like init_ravel(), report the ⎕SYL limit but compute the ravel (the
+   // interrupt raised then stops the computation)
+   //
+   ravel_count_limit_reached(length, true);
+
+Cell * long_ravel = 0;
+   try
+      {
+        long_ravel = alloc_ravel(length);
+      }
+   catch (...)
+      {
+        throw_apl_error(E_WS_FULL, LOC);
+      }
+
+   ravel = long_ravel;
+   ravel_capacity = length;
+
+   if (is_fused())
+      {
+        fusion->evaluate(ravel);
+        valid_ravel_items = length;
+        delete fusion;
+        fusion = 0;
+        clear_fused();
+        return;
+      }
+
+APL_Integer item = lazy_start;
+   loop(z, length)
+      {
+        new (ravel + z) IntCell(item);
+        item += lazy_step;
+      }
+
+   valid_ravel_items = length;
+   clear_lazy();
+}
+//-----------------------------------------------------------------------------
+Value_P
+Value::fused_copy(const char * loc) const
+{
+   Assert(is_fused());
+
+Value_P Z(get_shape(), loc);
+   fusion->evaluate(&Z->get_ravel(0));
+   Z->check_value(loc);
+   return Z;
+}
+//-----------------------------------------------------------------------------
 Value::~Value()
 {
    ADD_EVENT(this, VHE_Destruct, 0, LOC);
    unlink();
 
+   if (is_fused())   delete fusion;
+
 const ShapeItem length = nz_element_count();
 
    if (get_pointer_cell_count() > 0)
@@ -256,18 +363,166 @@ const ShapeItem length = nz_element_count();
 
       }
 
-   --value_count;
+   VALUE_LOCK(--value_count)
 
-   if (ravel != short_value)
-      {
-        total_ravel_count -= length;
-        delete [] ravel;
-      }
+   if (ravel != short_value)   free_ravel(ravel, ravel_capacity);
 
    Assert(check_ptr == (const char *)this + 7);
    check_ptr = 0;
 }
 //-----------------------------------------------------------------------------
+bool
+Value::ravel_count_limit_reached(ShapeItem length, bool report)
+{
+   if (Quad_SYL::ravel_count_limit == 0)   return false;   // no limit
+
+ShapeItem total;
+   VALUE_LOCK(total = total_ravel_count)
+   if (Quad_SYL::ravel_count_limit >= total + length)   return false;
+
+   if (report)
+      {
+        Workspace::more_error() = UCS_string(
+        "the system limit on the total ravel size (as set in ⎕SYL) "
+        "was reached\n(and to avoid lock-up, the limit in ⎕SYL "
+        "was automatically cleared).");
+
+        // reset the limit so that we don't get stuck here.
+        //
+        Quad_SYL::ravel_count_limit = 0;
+        attention_raised = interrupt_raised = true;
+      }
+
+   return true;
+}
+//-----------------------------------------------------------------------------
+Cell *
+Value::alloc_ravel(ShapeItem capacity)
+{
+const uint64_t bytes = capacity * sizeof(Cell);
+
+   // check the WORKSPACE_QUOTA and count the ravel in the same locked
+   // section. Otherwise two threads (e.g. computing items of ¨ in parallel)
+   // could both pass the check and exceed the quota together.
+   //
+bool over_quota = false;
+   VALUE_LOCK(if (uprefs.workspace_quota &&
+                  uprefs.workspace_quota < total_ravel_count*sizeof(Cell)
+                                         + value_count*sizeof(Value) + bytes)
+                 over_quota = true;
+              else
+                 total_ravel_count += capacity;)
+   if (over_quota)   throw bad_alloc();
+
+   if (bytes < HUGE_RAVEL_BYTES)
+      {
+        try
+           {
+             return (Cell *)(new char[bytes]);
+           }
+        catch (...)
+           {
+             VALUE_LOCK(total_ravel_count -= capacity)
+             throw;
+           }
+      }
+
+   // large ravels are mapped directly (rather than taken from the heap) so
+   // that they can use huge pages (fewer TLB misses) and are returned to the
+   // OS when released. mmap() only aligns to (small) pages, therefore
+   // HUGE_PAGE_BYTES more are mapped and the unaligned head and the unused
+   // tail are unmapped again.
+   //
+const uint64_t page = sysconf(_SC_PAGESIZE);
+const uint64_t mapped = (bytes + page - 1) & ~(page - 1);
+const uint64_t len = mapped + HUGE_PAGE_BYTES;
+void * addr = mmap(0, len, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (addr == MAP_FAILED)
+      {
+        VALUE_LOCK(total_ravel_count -= capacity)
+        throw bad_alloc();
+      }
+
+char * base = (char *)addr;
+char * aligned = (char *)(((uintptr_t)base + HUGE_PAGE_BYTES - 1)
+                          & ~uintptr_t(HUGE_PAGE_BYTES - 1));
+   if (aligned > base)   munmap(base, aligned - base);
+   if (base + len > aligned + mapped)
+      munmap(aligned + mapped, base + len - (aligned + mapped));
+
+#ifdef MADV_HUGEPAGE
+   madvise(aligned, mapped, MADV_HUGEPAGE);
+#endif
+
+   return (Cell *)aligned;
+}
+//-----------------------------------------------------------------------------
+void
+Value::free_ravel(Cell * ravel, ShapeItem capacity)
+{
+const uint64_t bytes = capacity * sizeof(Cell);
+   if (bytes < HUGE_RAVEL_BYTES)   delete [] (char *)ravel;
+   else                            munmap(ravel, bytes);
+
+   VALUE_LOCK(total_ravel_count -= capacity)
+}
+//-----------------------------------------------------------------------------
+bool
+Value::append_ravel(const Value & B, const char * loc)
+{
+   // only the simple case vector , scalar-or-vector is done in place. The
+   // prototype of an empty A could change, so A must not be empty.
+   //
+   if (get_rank() != 1 || is_empty() || !is_complete())   return false;
+   if (B.get_rank() > 1)                                 return false;
+   if (B.get_lval_cellowner())                           return false;
+
+const ShapeItem len_A = element_count();
+const ShapeItem len_B = B.element_count();
+const ShapeItem len_Z = len_A + len_B;
+   if (len_B == 0)   return true;   // A,⍬ is A
+
+const ShapeItem capacity = ravel_capacity ? ravel_capacity
+                                          : ShapeItem(SHORT_VALUE_LENGTH_WANTED);
+   if (len_Z > capacity)
+      {
+        // grow the ravel geometrically so that repeated appends take
+        // amortized constant time per item.
+        //
+        ShapeItem new_capacity = 2*capacity;
+        if (new_capacity < len_Z)   new_capacity = len_Z;
+
+        if (ravel_count_limit_reached(new_capacity, false))
+           return false;   // let the normal catenate report the error
+
+        Cell * new_ravel;
+        try
+           {
+             new_ravel = alloc_ravel(new_capacity);
+           }
+        catch (...)
+           {
+             throw_apl_error(E_WS_FULL, loc);
+           }
+
+        // cells are moved (not copied) so that the owner counts of nested
+        // sub-values remain valid.
+        //
+        memcpy(new_ravel, ravel, len_A * sizeof(Cell));
+        if (ravel != short_value)   free_ravel(ravel, ravel_capacity);
+
+        ravel = new_ravel;
+        ravel_capacity = new_capacity;
+      }
+
+   Cell::copy_ravel(ravel + len_A, &B.get_ravel(0), len_B, *this);
+
+   set_shape_item(0, len_Z);
+   if (valid_ravel_items == len_A)   valid_ravel_items = len_Z;
+   return true;
+}
+//-----------------------------------------------------------------------------
 Value_P
 Value::get_cellrefs(const char * loc)
 {
@@ -416,6 +671,8 @@ void
 Value::unmark() const
 {
    clear_marked();
+   if (is_lazy())   return;   // no ravel
+   if (is_fused())   { fusion->unmark();   return; }
 
 const ShapeItem ec = nz_element_count();
 const Cell * C = &get_ravel(0);
@@ -652,18 +909,26 @@ ShapeItem ec = element_count();
          const Cell & cell = get_ravel(c);
          if (cell.is_pointer_cell())
             {
-              cell.get_pointer_value()->enlist(dest, dest_owner, left);
+              // the cells of a left value will be modified, so they must
+              // not be shared.
+              //
+              if (left)   const_cast<Cell &>(cell)
+                             .get_unshared_pointer_value(LOC)
+                             ->enlist(dest, dest_owner, left);
+              else        cell.get_pointer_value()
+                             ->enlist(dest, dest_owner, left);
             }
          else if (left && cell.is_lval_cell())
             {
-              const Cell * cp = cell.get_lval_value();
+              Cell * cp = cell.get_lval_value();
               if (cp == 0)
                  {
                    CERR << "0-pointer at " LOC << endl;
                  }
               else if (cp->is_pointer_cell())
                  {
-                   cp->get_pointer_value()->enlist(dest, dest_owner, left);
+                   cp->get_unshared_pointer_value(LOC)
+                     ->enlist(dest, dest_owner, left);
                  }
               else 
                  {
@@ -987,11 +1252,40 @@ Value::index(Value_P X) const
 
    if (!X)   return clone(LOC);   // elided index
 
-const Shape shape_Z(X->get_shape());
-Value_P Z(shape_Z, LOC);
 const ShapeItem max_idx = element_count();
 const APL_Integer qio = Workspace::get_IO();
 
+   if (X->is_lazy())   // e.g. A[⍳N]: only the first and last index matter
+      {
+        const ShapeItem len_Z = X->element_count();
+        const ShapeItem step = X->get_lazy_step();
+        const ShapeItem first = X->get_lazy_start() - qio;
+        const ShapeItem last = first + (len_Z - 1)*step;
+        if (first >= 0 && first < max_idx && last >= 0 && last < max_idx)
+           {
+             Value_P Z(len_Z, LOC);
+             if (step == 1)
+                {
+                  Cell::copy_ravel(Z->next_ravels(len_Z), &get_ravel(first),
+                                   len_Z, Z.getref());
+                }
+             else
+                {
+                  loop(z, len_Z)   Z->next_ravel()->init(
+                                      get_ravel(first + z*step), Z.getref(), LOC);
+                }
+
+             Z->set_default(*this);
+             Z->check_value(LOC);
+             return Z;
+           }
+
+        X->materialize();   // INDEX ERROR below
+      }
+
+const Shape shape_Z(X->get_shape());
+Value_P Z(shape_Z, LOC);
+
 const Cell * cI = &X->get_ravel(0);
 
    while (Z->more())
@@ -1590,7 +1884,8 @@ Cell * c = &get_ravel(0);
 
    loop(e, ec)
       {
-        if (c->is_pointer_cell())          c->get_pointer_value()->to_proto();
+        if (c->is_pointer_cell())
+           c->get_unshared_pointer_value(LOC)->to_proto();
         else if (c->is_character_cell())   new (c) CharCell(UNI_ASCII_SPACE);
         else                               new (c) IntCell(0);
         ++c;
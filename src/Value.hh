@@ -41,6 +41,7 @@ using namespace std;
 class CDR_string;
 class IndexExpr;
 class PrintBuffer;
+class ScalarFusion;
 class Value_P;
 class Thread_context;
 
@@ -53,6 +54,7 @@ class Value : public DynamicObject
 {
    friend class Value_P;
    friend class PointerCell;   // needs &cell_owner
+   friend class ScalarFusion;  // creates fused values
 
 protected:
    // constructors. Values should not be constructed directly but via their
@@ -82,6 +84,12 @@ protected:
    /// constructor: a character matrix from a PrintBuffer
    Value(const PrintBuffer & pb, const char * loc);
 
+   /// constructor: a lazy integer vector start + step × 0...len-1
+   Value(ShapeItem len, APL_Integer start, APL_Integer step, const char * loc);
+
+   /// constructor: a fused value (computed later by \b fusion)
+   Value(const Shape & sh, ScalarFusion * fusion, const char * loc);
+
 public:
    /// destructor
    virtual ~Value();
@@ -205,6 +213,10 @@ public:
    void set_shape(const Shape & sh)
       { Assert(sh.get_volume() <= shape.get_volume());   shape = sh; }
 
+   /// append the items of B (a scalar or vector) to \b this vector in place
+   /// (for A←A,B). Return \b false if that is not possible.
+   bool append_ravel(const Value & B, const char * loc);
+
    /// return the position of cell in the ravel of \b this value.
    ShapeItem get_offset(const Cell * cell) const
       { return cell - &get_ravel(0); }
@@ -332,6 +344,15 @@ public:
    Cell * next_ravel()
       { return more() ? &ravel[valid_ravel_items++] : 0; }
 
+   /// return the next \b count ravel cells to be initialized
+   Cell * next_ravels(ShapeItem count)
+      {
+        Assert1(valid_ravel_items + count <= element_count());
+        Cell * ret = ravel + valid_ravel_items;
+        valid_ravel_items += count;
+        return ret;
+      }
+
    /// return the NOTCHAR property of the value. NOTCHAR is false for simple
    /// char arrays and true if any element is numeric or nested. The NOTCHAR
    /// property of empty arrays is the NOTCHAR property of its prototype.
@@ -408,8 +429,54 @@ public:
 
 # define clear_marked()   CLEAR_marked(_LOC)
 
+# define set_lazy()       SET_lazy(_LOC)
+# define clear_lazy()     CLEAR_lazy(_LOC)
+
+# define set_fused()      SET_fused(_LOC)
+# define clear_fused()    CLEAR_fused(_LOC)
+
+# define set_leaf()       SET_leaf(_LOC)
+
    VF_flag(complete)
    VF_flag(marked)
+   VF_flag(lazy)
+   VF_flag(fused)
+   VF_flag(leaf)
+
+   /// the largest magnitude of the items of a lazy vector (so that the
+   /// difference of two items cannot overflow)
+   static const APL_Integer LAZY_MAX = 0x4000000000000000LL;
+
+   /// return the integer vector start + step × 0...len-1 (with
+   /// len = ⍴⍳N). A long vector is lazy: its ravel is not computed
+   /// until some function needs it (see is_lazy())
+   static Value_P progression(ShapeItem len, APL_Integer start,
+                              APL_Integer step, const char * loc);
+
+   /// return the first item of a lazy vector (see is_lazy())
+   APL_Integer get_lazy_start() const
+      { return lazy_start; }
+
+   /// return the difference between adjacent items of a lazy vector
+   APL_Integer get_lazy_step() const
+      { return lazy_step; }
+
+   /// return the functions that compute a fused value (see is_fused())
+   const ScalarFusion * get_fusion() const
+      { return fusion; }
+
+   /// compute the ravel of a lazy vector (see is_lazy()) or of a fused
+   /// value (see is_fused()). A lazy value (as produced by ⍳N) has only a
+   /// shape, a start, and a step; a fused value has only a shape and a
+   /// chain of scalar functions. The ravel is computed when the value is
+   /// fetched from a Token (Token::get_apl_val()) by a function that does
+   /// not handle such values (see Function::accepts_lazy() and
+   /// Function::accepts_fused()).
+   void materialize();
+
+   /// return a new value with the ravel of this fused value, which itself
+   /// remains fused (used by )SAVE, see XML_Saving_Archive)
+   Value_P fused_copy(const char * loc) const;
 
    /// mark all values, except static values
    static void mark_all_dynamic_values();
@@ -493,9 +560,31 @@ public:
    /// print stale Values, and return the number of stale Values.
    static int print_stale(ostream & out);
 
-   /// total nz_element_counts of all non-short values
+   /// total capacity (in cells) of all non-short ravels
    static ShapeItem total_ravel_count;
 
+   /// the number of bytes used by all values and their (non-short) ravels
+   static uint64_t total_bytes()
+      { uint64_t bytes;
+        VALUE_LOCK(bytes = total_ravel_count*sizeof(Cell)
+                         + value_count*sizeof(Value))
+        return bytes; }
+
+   /// return \b true if \b length more ravel cells would exceed the limit
+   /// on the total ravel size (as set in ⎕SYL). If \b report then also
+   /// explain that in )MORE, clear the limit (so that we don't get stuck),
+   /// and raise an interrupt.
+   static bool ravel_count_limit_reached(ShapeItem length, bool report);
+
+   /// return a new (uninitialized) ravel for \b capacity cells and add
+   /// them to total_ravel_count. Throw bad_alloc if that fails or would
+   /// exceed the WORKSPACE_QUOTA preference
+   static Cell * alloc_ravel(ShapeItem capacity);
+
+   /// release \b ravel for \b capacity cells (from alloc_ravel()) and
+   /// subtract them from total_ravel_count
+   static void free_ravel(Cell * ravel, ShapeItem capacity);
+
    /// the number of values created
    static ShapeItem value_count;
 
@@ -540,6 +629,19 @@ protected:
    /// The ravel of \b this value.
    Cell * ravel;
 
+   /// the number of cells allocated for a long \b ravel (0 for short_value).
+   /// May exceed the element count after append_ravel() or set_shape().
+   ShapeItem ravel_capacity;
+
+   /// the first item of a lazy vector (only valid if is_lazy())
+   APL_Integer lazy_start;
+
+   /// the difference between adjacent items of a lazy vector
+   APL_Integer lazy_step;
+
+   /// the functions computing a fused value (only valid if is_fused())
+   ScalarFusion * fusion;
+
    /// the cells of a short (i.e. ⍴,value ≤ SHORT_VALUE_LENGTH_WANTED) value
    Cell short_value[SHORT_VALUE_LENGTH_WANTED];
 
@@ -552,6 +654,12 @@ protected:
    /// max. number values that have been deleted
    enum { deleted_values_MAX = 10000 };
 
+   /// ravels of at least that many bytes are mmap()ed (with huge pages)
+   enum { HUGE_RAVEL_BYTES = 2*1024*1024 };
+
+   /// the size (and alignment) of a (transparent) huge page
+   enum { HUGE_PAGE_BYTES = 2*1024*1024 };
+
 #if 1 // enable/disable deleted values chain for faster memory allocation
 
    /// allocate space for a new Value. For performance reasons, a pool of
@@ -559,30 +667,29 @@ protected:
    /// before calling new().
    static void * operator new(size_t sz)
       {
-        if (deleted_values)   // we have deleted values: recycle one
-           {
-             --deleted_values_count;
-             void * ret = deleted_values;
-             deleted_values = *(void **)deleted_values;
-             return ret;
-           }
-
-        return malloc(sz);
+        void * ret = 0;
+        VALUE_LOCK(if (deleted_values)   // we have deleted values: recycle one
+                      {
+                        --deleted_values_count;
+                        ret = deleted_values;
+                        deleted_values = *(void **)deleted_values;
+                      })
+
+        return ret ? ret : malloc(sz);
       }
 
    /// free space for a new Value
    static void operator delete(void * ptr)
       {
-        if (deleted_values_count < deleted_values_MAX)   // we have space
-           {
-             ++deleted_values_count;
-             *(void **)ptr = deleted_values;
-             deleted_values = ptr;
-           }
-        else                                             // no more space
-           {
-             free(ptr);
-           }
+        VALUE_LOCK(if (deleted_values_count < deleted_values_MAX)   // space
+                      {
+                        ++deleted_values_count;
+                        *(void **)ptr = deleted_values;
+                        deleted_values = ptr;
+                        ptr = 0;
+                      })
+
+        if (ptr)   free(ptr);   // no more space
       }
 
 #endif
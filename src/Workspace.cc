@@ -21,6 +21,8 @@
 #include <errno.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <fstream>
 
@@ -32,6 +34,7 @@ using namespace std;
 #include "IO_Files.hh"
 #include "LibPaths.hh"
 #include "Output.hh"
+#include "Parallel.hh"
 #include "Quad_FX.hh"
 #include "Quad_TF.hh"
 #include "SystemVariable.hh"
@@ -57,7 +60,11 @@ Workspace::Workspace()
    : WS_name("CLEAR WS"),
 //   prompt("-----> "),
      prompt("      "),
-     top_SI(0)
+     top_SI(0),
+     saved_length(0),
+     saved_base_length(0),
+     saved_deltas(0),
+     async_save_pid(0)
 {
 #define ro_sv_def(x, str, _txt)                                   \
    if (*str) { UCS_string q(UNI_Quad_Quad);   q.append_utf8(str); \
@@ -179,6 +186,21 @@ Workspace::SI_top_error()
    return 0;   // no context with an error
 }
 //-----------------------------------------------------------------------------
+UCS_string &
+Workspace::core_more_error()
+{
+vector<UCS_string> & info = the_workspace.core_more_error_info;
+const pthread_t self = pthread_self();
+   loop(c, info.size())
+      {
+        if (pthread_equal(self, Thread_context::get_context(CoreNumber(c))
+                                                          ->thread))
+           return info[c];
+      }
+
+   return the_workspace.more_error_info;   // not a thread of the pool
+}
+//-----------------------------------------------------------------------------
 Token
 Workspace::immediate_execution(bool exit_on_error)
 {
@@ -517,6 +539,7 @@ Workspace::clear_WS(ostream & out, bool silent)
    Quad_FIO::fun->clear();
 
    set_WS_name(UCS_string("CLEAR WS"));
+   the_workspace.saved_file.clear();
    if (!silent)   out << "CLEAR WS" << endl;
 }
 //-----------------------------------------------------------------------------
@@ -546,6 +569,19 @@ Workspace::save_WS(ostream & out, vector<UCS_string> & lib_ws)
    // )SAVE
    // )SAVE wsname
    // )SAVE libnum wsname
+   //
+   // each optionally followed by ASYNC
+
+   // a previous background )SAVE could still write the same file
+   //
+   poll_async_save(out, true);
+
+bool async = false;
+   if (lib_ws.size() && lib_ws.back().compare(UCS_string("ASYNC")) == 0)
+      {
+        async = true;
+        lib_ws.pop_back();
+      }
 
 bool name_from_WSID = false;
    if (lib_ws.size() == 0)   // no argument: use )WSID value
@@ -599,27 +635,93 @@ const bool file_exists = access(filename.c_str(), W_OK) == 0;
            }
       }
 
-   if (uprefs.backup_before_save && backup_existing_file(filename.c_str()))
+   if (async)
       {
-        COUT << "NOT SAVED: COULD NOT CREATE BACKUP FILE "
-             << filename << endl;
-        return;
+        the_workspace.WS_name = wname;
+        save_WS_async(out, filename);
+        if (the_workspace.async_save_pid == 0)   return;   // fork() failed
       }
-
-   // at this point it is OK to rename and save the workspace
-   //
-ofstream outf(filename.c_str(), ofstream::out);
-   if (!outf.is_open())   // open failed
+   else if (can_save_delta(filename.c_str()))
       {
-        CERR << "Unable to )SAVE workspace '" << wname
-             << "'. " << strerror(errno) << endl;
-        return;
+        // incremental )SAVE: append the changed symbols to the file
+        // (overwriting its trailing 0s). The file is not backed up since
+        // its current content remains unchanged.
+        //
+        {
+          ofstream outf(filename.c_str(), ofstream::in | ofstream::out);
+          if (!outf.is_open())   // open failed
+             {
+               CERR << "Unable to )SAVE workspace '" << wname
+                    << "'. " << strerror(errno) << endl;
+               return;
+             }
+
+          the_workspace.WS_name = wname;
+          outf.seekp(the_workspace.saved_length - 5);
+          XML_Saving_Archive ar(outf);
+          ar.save_delta();
+        }
+
+        set_saved_file(filename.c_str(), the_workspace.saved_deltas + 1,
+                       the_workspace.saved_base_length);
       }
+   else
+      {
+        // at this point it is OK to rename and save the workspace. Like
+        // save_WS_async(), it is written into a temporary file which then
+        // replaces filename, so that a failed )SAVE (e.g. WS FULL) leaves
+        // an existing file unchanged.
+        //
+        UTF8_string temp_filename = filename;
+        temp_filename.append_str(".tmp");
+        {
+          ofstream outf(temp_filename.c_str(), ofstream::out);
+          if (!outf.is_open())   // open failed
+             {
+               CERR << "Unable to )SAVE workspace '" << wname
+                    << "'. " << strerror(errno) << endl;
+               return;
+             }
+
+          the_workspace.WS_name = wname;
+
+          try
+             {
+               XML_Saving_Archive ar(outf);   // closes outf when done
+               ar.save();
+             }
+          catch (...)
+             {
+               unlink(temp_filename.c_str());
+               throw;
+             }
+
+          if (outf.fail())   // write or close failed
+             {
+               CERR << "Unable to )SAVE workspace '" << wname
+                    << "'. " << strerror(errno) << endl;
+               unlink(temp_filename.c_str());
+               return;
+             }
+        }
+
+        const int err = replace_WS_file(temp_filename, filename);
+        if (err == SAVE_BACKUP_FAILED)
+           {
+             COUT << "NOT SAVED: COULD NOT CREATE BACKUP FILE "
+                  << filename << endl;
+             return;
+           }
 
-   the_workspace.WS_name = wname;
+        if (err)
+           {
+             CERR << "Unable to )SAVE workspace '" << wname
+                  << "'. " << strerror(err) << endl;
+             return;
+           }
 
-XML_Saving_Archive ar(outf);
-   ar.save();
+        set_saved_file(filename.c_str(), 0, -1);
+      }
 
    // print time and date to COUT
    {
@@ -641,6 +743,150 @@ XML_Saving_Archive ar(outf);
    }
 }
 //-----------------------------------------------------------------------------
+void
+Workspace::save_WS_async(ostream & out, UTF8_string filename)
+{
+   // fork() gives the child a copy-on-write snapshot of the workspace. The
+   // child writes it into a temporary file and then renames it to
+   // filename, so that filename is never left incomplete.
+   //
+const pid_t pid = fork();
+   if (pid == -1)   // fork() failed
+      {
+        out << "NOT SAVED: " << strerror(errno) << endl;
+        return;
+      }
+
+   if (pid)   // parent
+      {
+        the_workspace.async_save_pid = pid;
+        the_workspace.async_save_file = filename;
+
+        // the file will not contain the symbols changed after the fork(),
+        // so the next )SAVE cannot append to it
+        //
+        the_workspace.saved_file.clear();
+        return;
+      }
+
+   // child. The worker threads of the parent do not exist in the child,
+   // therefore values (e.g. fused ones) must be computed sequentially.
+   // The child must only _exit() since exit() would, for example, flush
+   // the output buffers that the parent has copied to the child.
+   //
+   Parallel::run_parallel = false;
+
+UTF8_string temp_filename = filename;
+   temp_filename.append_str(".tmp");
+
+   {
+     ofstream outf(temp_filename.c_str(), ofstream::out);
+     if (!outf.is_open())   _exit(errno ? errno : EIO);
+
+     XML_Saving_Archive ar(outf);
+     ar.save();
+     outf.close();
+     if (outf.fail())   _exit(errno ? errno : EIO);
+   }
+
+   _exit(replace_WS_file(temp_filename, filename));
+}
+//-----------------------------------------------------------------------------
+int
+Workspace::replace_WS_file(UTF8_string temp_filename, UTF8_string filename)
+{
+   if (uprefs.backup_before_save && backup_existing_file(filename.c_str()))
+      {
+        unlink(temp_filename.c_str());
+        return SAVE_BACKUP_FAILED;
+      }
+
+   if (rename(temp_filename.c_str(), filename.c_str()))
+      {
+        const int err = errno ? errno : EIO;
+        unlink(temp_filename.c_str());
+        return err;
+      }
+
+   return 0;
+}
+//-----------------------------------------------------------------------------
+void
+Workspace::poll_async_save(ostream & out, bool wait)
+{
+   if (the_workspace.async_save_pid == 0)   return;   // no background )SAVE
+
+int status = 0;
+const pid_t pid = waitpid(the_workspace.async_save_pid, &status,
+                          wait ? 0 : WNOHANG);
+   if (pid == 0)   return;   // still running
+
+   the_workspace.async_save_pid = 0;
+
+   out << "ASYNC )SAVE " << the_workspace.async_save_file;
+   if (pid == -1)
+      out << " LOST: " << strerror(errno) << endl;
+   else if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+      out << " COMPLETED" << endl;
+   else if (WIFEXITED(status) && WEXITSTATUS(status) == SAVE_BACKUP_FAILED)
+      out << " FAILED: COULD NOT CREATE BACKUP FILE" << endl;
+   else if (WIFEXITED(status))
+      out << " FAILED: " << strerror(WEXITSTATUS(status)) << endl;
+   else
+      out << " FAILED: killed by signal " << WTERMSIG(status) << endl;
+}
+//-----------------------------------------------------------------------------
+bool
+Workspace::can_save_delta(const char * filename)
+{
+   if (uprefs.incremental_save <= 0)                       return false;
+   if (the_workspace.saved_file.size() == 0)               return false;
+   if (strcmp(the_workspace.saved_file.c_str(), filename))   return false;
+
+   // the SI is only saved by a full )SAVE
+   //
+   if (SI_entry_count())   return false;
+
+   // compact the file after uprefs.incremental_save deltas, or when the
+   // deltas have become larger than the full )SAVE
+   //
+   if (the_workspace.saved_deltas >= uprefs.incremental_save)   return false;
+   if (the_workspace.saved_length > 2*the_workspace.saved_base_length)
+      return false;
+
+   // the file must be unchanged since the last )SAVE or )LOAD
+   //
+struct stat st;
+   if (stat(filename, &st))                          return false;
+   if (st.st_size != the_workspace.saved_length)   return false;
+
+char tail[5];
+ifstream in(filename);
+   in.seekg(-5, ios_base::end);
+   if (!in.read(tail, sizeof(tail)))                  return false;
+   return !memcmp(tail, "\0\0\0\0\n", sizeof(tail));
+}
+//-----------------------------------------------------------------------------
+void
+Workspace::set_saved_file(const char * filename, int deltas,
+                          int64_t base_length)
+{
+   the_workspace.symbol_table.clear_dirty();
+
+struct stat st;
+   if (SI_entry_count() || stat(filename, &st))   // no incremental )SAVE
+      {
+        the_workspace.saved_file.clear();
+        return;
+      }
+
+   the_workspace.saved_file = UTF8_string(filename);
+   the_workspace.saved_length = st.st_size;
+   the_workspace.saved_base_length = base_length < 0 ? st.st_size
+                                                      : base_length;
+   the_workspace.saved_deltas = deltas;
+}
+//-----------------------------------------------------------------------------
 bool
 Workspace::backup_existing_file(const char * filename)
 {
@@ -1004,6 +1250,8 @@ XML_Loading_Archive in(filename.c_str(), dump_fd);
         //
         the_workspace.clear_WS(out, true);
         in.read_Workspace(silent);
+        set_saved_file(filename.c_str(), in.get_delta_count(),
+                       in.get_base_length());
       }
 
    if (Workspace::get_LX().size())  quad_lx = Workspace::get_LX();
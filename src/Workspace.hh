@@ -126,9 +126,26 @@ public:
    static Error * get_error()
       { return SI_top() ? &SI_top()->get_error() : 0; }
 
-   /// return reference to more info about last error
+   /// return reference to more info about last error. While worker threads
+   /// evaluate the items of ¨ or ∘. (see Parallel::concurrent_values) every
+   /// core has its own (see core_more_error()).
    static UCS_string & more_error()
-      { return the_workspace.more_error_info; }
+      { return Parallel::concurrent_values ? core_more_error()
+                                           : the_workspace.more_error_info; }
+
+   /// return reference to more info about the last error of the calling core
+   static UCS_string & core_more_error();
+
+   /// clear the more infos of \b cores cores (before the workers start)
+   static void init_core_more_error(CoreCount cores)
+      { the_workspace.core_more_error_info.clear();
+        the_workspace.core_more_error_info.resize(cores); }
+
+   /// take over the more info of core \b core (if any) after the workers
+   /// have finished
+   static void take_core_more_error(CoreNumber core)
+      { const UCS_string & info = the_workspace.core_more_error_info[core];
+        if (info.size())   the_workspace.more_error_info = info; }
 
    /// erase the symbols in \b symbols from the symbol table
    static void erase_symbols(ostream & out, const vector<UCS_string> & symbols)
@@ -204,9 +221,38 @@ public:
    /// save this workspace
    static void save_WS(ostream & out, vector<UCS_string> & lib_ws);
 
+   /// save this workspace into \b filename in a forked child process
+   /// (the parent continues while the child writes the file)
+   static void save_WS_async(ostream & out, UTF8_string filename);
+
+   /// the result of replace_WS_file() (and the exit status of the
+   /// save_WS_async() child) if the backup of an existing file failed.
+   /// Other failures return (or exit with) their errno.
+   enum { SAVE_BACKUP_FAILED = 255 };
+
+   /// replace \b filename (after a backup, if configured) by the completely
+   /// written \b temp_filename. Return 0 if OK, SAVE_BACKUP_FAILED or the
+   /// errno of rename(). \b temp_filename is removed if it fails.
+   static int replace_WS_file(UTF8_string temp_filename,
+                              UTF8_string filename);
+
+   /// report the completion of a background )SAVE (if any). If \b wait is
+   /// true then wait until it has completed.
+   static void poll_async_save(ostream & out, bool wait);
+
    /// backup an existing file \b filename, return true on error
    static bool backup_existing_file(const char * filename);
 
+   /// return true if the next )SAVE into \b filename may only append the
+   /// symbols that were changed since the last )SAVE or )LOAD
+   static bool can_save_delta(const char * filename);
+
+   /// remember that \b filename contains the current workspace: a full
+   /// )SAVE of \b base_length bytes (-1 for the entire file) followed by
+   /// \b deltas incremental )SAVEs
+   static void set_saved_file(const char * filename, int deltas,
+                              int64_t base_length);
+
    /// dump this workspace
    static void dump_WS(ostream & out, vector<UCS_string> & lib_ws,
                        bool html, bool silent);
@@ -289,12 +335,34 @@ protected:
    /// more info about last error
    UCS_string more_error_info;
 
+   /// more info about the last error of every core (see core_more_error())
+   vector<UCS_string> core_more_error_info;
+
    /// the SI stack. Initially top_SI is 0 (empty stack)
    StateIndicator * top_SI;
 
    /// )LOAD, )QLOAD, )CLEAR, or )SIC
    UCS_string pushed_command;
 
+   /// the file that contains the current workspace (after )SAVE or )LOAD),
+   /// or empty if the next )SAVE must write the entire workspace
+   UTF8_string saved_file;
+
+   /// the length of saved_file
+   int64_t saved_length;
+
+   /// the length of the full )SAVE at the start of saved_file
+   int64_t saved_base_length;
+
+   /// the number of incremental )SAVEs appended to saved_file
+   int saved_deltas;
+
+   /// the process that performs a background )SAVE, or 0 if none
+   pid_t async_save_pid;
+
+   /// the file being written by async_save_pid
+   UTF8_string async_save_file;
+
    /// the current workspace (for objects that need one but don't have one).
    static Workspace the_workspace;
 };
@@ -114,6 +114,78 @@ Value_P Z(ucs, loc);
    return Z.get();
 }
 
+//-----------------------------------------------------------------------------
+/// a new value with given rank and shape for the bulk constructors below.
+/// The caller initializes the ravel and calls finish_array().
+static Value_P
+new_array(int rank, const int64_t * shape, const char * loc)
+{
+const Shape sh(rank, shape);
+Value_P Z(sh, loc);
+   return Z;
+}
+//-----------------------------------------------------------------------------
+/// finish a value returned by new_array()
+static APL_value
+finish_array(Value_P Z, const char * loc)
+{
+   Z->check_value(LOC);
+   Value_P::increment_owner_count(Z.get(), loc);   // keep value
+   return Z.get();
+}
+//-----------------------------------------------------------------------------
+/// A new APL value with given rank, shape, and integer ravel data
+APL_value
+int_array(int rank, const int64_t * shape, const int64_t * data,
+          const char * loc)
+{
+Value_P Z = new_array(rank, shape, loc);
+const ShapeItem len = Z->element_count();
+Cell * C = &Z->get_ravel(0);
+   loop(z, len)   new (C + z) IntCell(data[z]);
+   if (len == 0)   new (C) IntCell(0);   // prototype
+   return finish_array(Z, loc);
+}
+//-----------------------------------------------------------------------------
+/// A new APL value with given rank, shape, and double ravel data
+APL_value
+double_array(int rank, const int64_t * shape, const double * data,
+             const char * loc)
+{
+Value_P Z = new_array(rank, shape, loc);
+const ShapeItem len = Z->element_count();
+Cell * C = &Z->get_ravel(0);
+   loop(z, len)   new (C + z) FloatCell(data[z]);
+   if (len == 0)   new (C) IntCell(0);   // prototype
+   return finish_array(Z, loc);
+}
+//-----------------------------------------------------------------------------
+/// A new APL value with given rank, shape, and Unicode ravel data
+APL_value
+char_array(int rank, const int64_t * shape, const uint32_t * data,
+           const char * loc)
+{
+Value_P Z = new_array(rank, shape, loc);
+const ShapeItem len = Z->element_count();
+Cell * C = &Z->get_ravel(0);
+   loop(z, len)   new (C + z) CharCell((Unicode)data[z]);
+   if (len == 0)   new (C) CharCell(UNI_ASCII_SPACE);   // prototype
+   return finish_array(Z, loc);
+}
+//-----------------------------------------------------------------------------
+/// A new APL value with given rank, shape, and byte ravel data
+APL_value
+byte_array(int rank, const int64_t * shape, const uint8_t * data,
+           const char * loc)
+{
+Value_P Z = new_array(rank, shape, loc);
+const ShapeItem len = Z->element_count();
+Cell * C = &Z->get_ravel(0);
+   loop(z, len)   new (C + z) IntCell(data[z]);
+   if (len == 0)   new (C) IntCell(0);   // prototype
+   return finish_array(Z, loc);
+}
+
 /******************************************************************************
    2. APL value destructor function. All non-0 APL_values must be released
       at some point in time (even const ones). release_value(0) is not needed
@@ -215,6 +287,78 @@ Value_P sub = val->get_ravel(idx).get_pointer_value();
 }
 
 
+//-----------------------------------------------------------------------------
+/// copy the integer ravel of val into dest
+int64_t
+get_ints(const APL_value val, int64_t * dest, uint64_t dest_len)
+{
+const ShapeItem len = val->element_count();
+const ShapeItem count = (uint64_t)len < dest_len ? len : dest_len;
+const Cell * C = &val->get_ravel(0);
+   loop(c, len)
+      {
+        if (C[c].get_cell_type() != CT_INT)   return -1;
+        if (c < count)   dest[c] = C[c].get_int_value();
+      }
+
+   return len;
+}
+//-----------------------------------------------------------------------------
+/// copy the integer or double ravel of val into dest
+int64_t
+get_doubles(const APL_value val, double * dest, uint64_t dest_len)
+{
+const ShapeItem len = val->element_count();
+const ShapeItem count = (uint64_t)len < dest_len ? len : dest_len;
+const Cell * C = &val->get_ravel(0);
+   loop(c, len)
+      {
+        const CellType ct = C[c].get_cell_type();
+        if (ct != CT_INT && ct != CT_FLOAT)   return -1;
+        if (c < count)   dest[c] = C[c].get_real_value();
+      }
+
+   return len;
+}
+//-----------------------------------------------------------------------------
+/// copy the character ravel of val into dest
+int64_t
+get_chars(const APL_value val, uint32_t * dest, uint64_t dest_len)
+{
+const ShapeItem len = val->element_count();
+const ShapeItem count = (uint64_t)len < dest_len ? len : dest_len;
+const Cell * C = &val->get_ravel(0);
+   loop(c, len)
+      {
+        if (C[c].get_cell_type() != CT_CHAR)   return -1;
+        if (c < count)   dest[c] = C[c].get_char_value();
+      }
+
+   return len;
+}
+//-----------------------------------------------------------------------------
+/// copy the byte ravel (integers or characters 0...255) of val into dest
+int64_t
+get_bytes(const APL_value val, uint8_t * dest, uint64_t dest_len)
+{
+const ShapeItem len = val->element_count();
+const ShapeItem count = (uint64_t)len < dest_len ? len : dest_len;
+const Cell * C = &val->get_ravel(0);
+   loop(c, len)
+      {
+        const CellType ct = C[c].get_cell_type();
+        APL_Integer byte;
+        if      (ct == CT_INT)    byte = C[c].get_int_value();
+        else if (ct == CT_CHAR)   byte = C[c].get_char_value();
+        else                      return -1;
+
+        if (byte < 0 || byte > 255)   return -1;
+        if (c < count)   dest[c] = byte;
+      }
+
+   return len;
+}
+
 /******************************************************************************
    4. write access to APL values. All ravel indices count from ⎕IO←0.
  */
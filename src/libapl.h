@@ -127,6 +127,26 @@ inline APL_value apl_cube(int64_t blocks, int64_t rows, int64_t cols,
 
 extern APL_value char_vector(const char * str, const char * loc);
 
+/// A new APL value with given rank and shape. The ravel elements are the
+/// ×/shape integers in data.
+extern APL_value int_array(int rank, const int64_t * shape,
+                           const int64_t * data, const char * loc);
+
+/// A new APL value with given rank and shape. The ravel elements are the
+/// ×/shape doubles in data.
+extern APL_value double_array(int rank, const int64_t * shape,
+                              const double * data, const char * loc);
+
+/// A new APL value with given rank and shape. The ravel elements are the
+/// ×/shape (32-bit Unicode) characters in data.
+extern APL_value char_array(int rank, const int64_t * shape,
+                            const uint32_t * data, const char * loc);
+
+/// A new APL value with given rank and shape. The ravel elements are the
+/// ×/shape bytes in data (as integers 0...255, like ⎕FIO does).
+extern APL_value byte_array(int rank, const int64_t * shape,
+                            const uint8_t * data, const char * loc);
+
 /******************************************************************************
    2. APL value destructor function. All non-0 APL_values must be released
       at some point in time (even const ones). release_value(0) is not needed
@@ -196,6 +216,28 @@ extern double get_imag(const APL_value val, uint64_t idx);
 ///
 extern APL_value get_value(const APL_value val, uint64_t idx);
 
+/// The following functions copy the entire ravel of val into dest, which has
+/// room for dest_len items. At most dest_len items are copied. Return the
+/// number of ravel elements of val (which can be larger than dest_len), or
+/// -1 if some ravel element of val has the wrong type (and then dest is
+/// undefined).
+
+/// copy a ravel of integers
+extern int64_t get_ints(const APL_value val, int64_t * dest,
+                        uint64_t dest_len);
+
+/// copy a ravel of integers or doubles
+extern int64_t get_doubles(const APL_value val, double * dest,
+                           uint64_t dest_len);
+
+/// copy a ravel of characters
+extern int64_t get_chars(const APL_value val, uint32_t * dest,
+                         uint64_t dest_len);
+
+/// copy a ravel of integers 0...255 or characters ⎕UCS 0...255
+extern int64_t get_bytes(const APL_value val, uint8_t * dest,
+                         uint64_t dest_len);
+
 /******************************************************************************
    4. write access to APL values. All ravel indices count from ⎕IO←0.
  */
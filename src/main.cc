@@ -36,6 +36,7 @@
 #include "makefile.h"
 #include "Output.hh"
 #include "NativeFunction.hh"
+#include "Performance.hh"
 #include "Workspace.hh"
 #include "UserPreferences.hh"
 
@@ -316,6 +317,8 @@ const bool log_startup = uprefs.parse_argv_1();
 
    if (uprefs.do_Color)   Output::toggle_color("ON");
 
+   if (uprefs.calibrate_parallel)   Performance::calibrate_thresholds(CERR);
+
    if (uprefs.latent_expression.size())
       {
         // there was a --LX expression on the command line
@@ -70,6 +70,10 @@ No such process
    own native function. It implements all function signatures supported by
    GNU APL and simply returns ia character vector telling how it was called.
 
+   Native functions that process large simple values should use the helpers
+   at the end of Native_interface.hh (Native_span, native_value(), and
+   native_parallel()) rather than accessing the ravel cell by cell.
+
 **/
 
 // mandatory functios
@@ -130,29 +130,82 @@ print_phrases(FILE * out)
                 "   *** phrase table ***/\n\n");
 }
 //-----------------------------------------------------------------------------
-int test_modu(int modu)
+/// one state of the phrase automaton, i.e. a prefix (top of stack first)
+/// of one or more phrases
+struct _state
 {
-int * tab = new int[modu];
+   int next[TC_MAX_PHRASE];   // the state for the next token class (or 0)
+   int phrase;                // the phrase that ends in this state (or -1)
+   int depth;                 // the length of the prefix
+   int parent;                // the state for the prefix without its last token
+   int tc;                    // the last token class of the prefix
+};
 
-   for (int m = 0; m < modu; ++m)   tab[m] = -1;
+vector<_state> states;
 
-   for (int ph = 0; ph < PHRASE_COUNT; ++ph)
+//-----------------------------------------------------------------------------
+/// build the phrase automaton: state 0 is the empty prefix and every other
+/// state is reached from its parent state by one more token class.
+void
+build_states()
+{
+_state initial;
+   memset(&initial, 0, sizeof(initial));
+   initial.phrase = -1;
+   initial.parent = -1;
+   initial.tc = TC_INVALID;
+   states.push_back(initial);
+
+   // number the states breadth first, so that shorter prefixes come first
+   //
+   for (int depth = 0; depth < MAX_PHRASE_LEN; ++depth)
+   for (int ph = 1; ph < PHRASE_COUNT; ++ph)   // phrase 0 is the empty phrase
        {
          const _phrase & e = phrase_tab[ph];
-         const int idx = e.hash % modu;
-         if (tab[idx] == -1)   // free entry
+         if (e.len <= depth)   continue;
+
+         // find the state for the first depth token classes of e
+         //
+         int st = 0;
+         for (int l = 0; l < depth; ++l)   st = states[st].next[e.phrase[l]];
+         assert(st || depth == 0);
+
+         const int tc = e.phrase[depth];
+         if (states[st].next[tc] == 0)   // new state
             {
-              tab[idx] = ph;
+              _state state;
+              memset(&state, 0, sizeof(state));
+              state.phrase = -1;
+              state.depth = depth + 1;
+              state.parent = st;
+              state.tc = tc;
+              states[st].next[tc] = states.size();
+              states.push_back(state);
             }
-         else                  // collision
+
+         if (e.len == depth + 1)
             {
-              delete [] tab;
-              return false;
+              const int end = states[st].next[tc];
+              assert(states[end].phrase == -1);   // phrases are different
+              states[end].phrase = ph;
             }
        }
 
-   delete [] tab;
-   return true;
+   // the tables use uint8_t and int8_t
+   //
+   assert(states.size() < 256);
+   assert(PHRASE_COUNT < 128);
+}
+//-----------------------------------------------------------------------------
+/// return 1 if the reduction of \b e can be prevented by the next token
+/// (i.e. if Prefix::dont_reduce() can return true for it), or else 0
+int
+lookahead(const _phrase & e)
+{
+   if (e.phrase[0] == TC_VALUE || e.phrase[0] == TC_FUN12)
+      return e.prio < BS_OP_RO;
+
+   return 0;
 }
 //-----------------------------------------------------------------------------
 void
@@ -180,21 +233,74 @@ char nam[100];   snprintf(nam, sizeof(nam), "%s %s %s %s",
 char fun[100];   snprintf(fun, sizeof(fun), "%s_%s_%s_%s", 
                           e.rn1, e.names[1], e.names[2], e.names[3]);
 
-   fprintf(out, "  PH( %-12s ,  %5d,   %2d,   %d,  %d, %-12s )\n",
-                nam, e.hash, e.prio, e.misc, e.len, fun);
+   fprintf(out, "  PH( %-12s ,  %6d,   %2d,   %d,  %d,    %d,   %-12s )\n",
+                nam, e.hash, e.prio, e.misc, e.len, lookahead(e), fun);
+}
+//-----------------------------------------------------------------------------
+/// the short name (as in phrase_gen.def) of token class \b tc
+const char *
+short_name(int tc)
+{
+   switch(tc)
+      {
+        case TC_ASSIGN:   return "ASS";
+        case TC_R_ARROW:  return "GOTO";
+        case TC_L_BRACK:  return "LBRA";
+        case TC_R_BRACK:  return "RBRA";
+        case TC_END:      return "END";
+        case TC_FUN0:     return "N";
+        case TC_FUN12:    return "F";
+        case TC_INDEX:    return "C";
+        case TC_OPER1:    return "M";
+        case TC_OPER2:    return "D";
+        case TC_L_PARENT: return "LPAR";
+        case TC_R_PARENT: return "RPAR";
+        case TC_RETURN:   return "RETC";
+        case TC_SYMBOL:   return "V";
+        case TC_VALUE:    return "B";
+        case TC_PINDEX:   return "I";
+        case TC_VOID:     return "VOID";
+      }
+
+   assert(0);
+   return 0;
 }
 //-----------------------------------------------------------------------------
 void
-print_table(FILE * out)
+print_state(FILE * out, int st)
 {
-   // find smallest modulus for wrapping hash_table.
+const _state & state = states[st];
+
+   // the prefix of the state, e.g. "B F"
    //
-int MODU = TC_MAX_PHRASE;
-   for (;; ++MODU)
+char prefix[100] = "";
+   {
+     const char * names[MAX_PHRASE_LEN];
+     int s = st;
+     for (int l = state.depth - 1; l >= 0; --l)
+         {
+           names[l] = short_name(states[s].tc);
+           s = states[s].parent;
+         }
+
+     for (int l = 0; l < state.depth; ++l)
+         {
+           if (l)   strncat(prefix, " ", sizeof(prefix) - strlen(prefix) - 1);
+           strncat(prefix, names[l], sizeof(prefix) - strlen(prefix) - 1);
+         }
+   }
+
+   fprintf(out, "  /* %3d: %-15s */ { {", st, prefix);
+   for (int tc = 0; tc < TC_MAX_PHRASE; ++tc)
        {
-         if (test_modu(MODU))   break;
+         fprintf(out, "%s%3d", tc ? "," : "", state.next[tc]);
        }
-
+   fprintf(out, " }, %3d },\n", state.phrase);
+}
+//-----------------------------------------------------------------------------
+void
+print_table(FILE * out)
+{
    fprintf(out,
 "\n"
 "#ifndef PH\n"
@@ -209,9 +315,9 @@ int MODU = TC_MAX_PHRASE;
    fprintf(out,
 "\n"
 "   enum { PHRASE_COUNT   = %d,      ///< number of phrases\n"
-"          PHRASE_MODU    = %d,     ///< hash table size\n"
+"          PHRASE_STATES  = %d,      ///< number of phrase automaton states\n"
 "          MAX_PHRASE_LEN = %d };     ///< max. number of token in a phrase\n"
-           , PHRASE_COUNT, MODU, MAX_PHRASE_LEN);
+           , PHRASE_COUNT, int(states.size()), MAX_PHRASE_LEN);
 
    fprintf(out,
 "\n"
@@ -223,37 +329,49 @@ int MODU = TC_MAX_PHRASE;
 "        int            prio;            ///< phrase priority\n"
 "        int            misc;            ///< 1 if MISC phrase\n"
 "        int            phrase_len;      ///< phrase length\n"
+"        int            lookahead;       ///< 1 if dont_reduce() can be true\n"
 "        void (Prefix::*reduce_fun)();   ///< reduce function\n"
 "        const char *   reduce_name;     ///< reduce function name\n"
 "      };\n"
 "\n"
-"      /// a hash table with all valid phrases (and many invalid entries)\n"
-"      static const Phrase hash_table[PHRASE_MODU];\n"
+"   /// one state of the phrase automaton. The automaton starts in state 0\n"
+"   /// and reads the token classes at0(), at1(), ... of the stack. The\n"
+"   /// last state with a phrase is the longest phrase that matches.\n"
+"   struct Phrase_state\n"
+"      {\n"
+"        uint8_t next[TC_MAX_PHRASE];   ///< next state (0 if none)\n"
+"        int8_t  phrase;                ///< phrase matched (-1 if none)\n"
+"      };\n"
+"\n"
+"   /// all valid phrases\n"
+"   static const Phrase phrase_table[PHRASE_COUNT];\n"
+"\n"
+"   /// the phrase automaton\n"
+"   static const Phrase_state phrase_states[PHRASE_STATES];\n"
 "\n"
 "#else  // PH defined\n"
 "\n"
-"const Prefix::Phrase Prefix::hash_table[PHRASE_MODU] =\n"
+"const Prefix::Phrase Prefix::phrase_table[PHRASE_COUNT] =\n"
 "{\n"
-"  //  phrase_name      hash  prio misc len  reduce_XXX()\n"
-"  //  --------------------------------------------------\n");
+"  //  phrase_name       hash  prio misc len look  reduce_XXX()\n"
+"  //  -------------------------------------------------------\n");
 
-   {
-     const _phrase ** table = new const _phrase *[MODU];
-     for (int i = 0; i < MODU; ++i)   table[i] = phrase_tab;
-
-     for (int i = 0; i < PHRASE_COUNT; ++i)
-         {
-           _phrase & e = phrase_tab[i];
-           table[e.hash % MODU] = phrase_tab + i;
-         }
+   for (int ph = 0; ph < PHRASE_COUNT; ++ph)
+       {
+         print_entry_macro(out, phrase_tab[ph]);
+       }
 
-     for (int i = 0; i < MODU; ++i)
-         {
-           print_entry_macro(out, *table[i]);
-         }
-      delete [] table;
-   }
+   fprintf(out,
+"};\n"
+"\n"
+"const Prefix::Phrase_state Prefix::phrase_states[PHRASE_STATES] =\n"
+"{\n"
+"  //       prefix                next state for token class 0 ... %d,"
+" phrase\n"
+"  //  ----------------------------------------------------------------\n",
+           TC_MAX_PHRASE - 1);
 
+   for (size_t st = 0; st < states.size(); ++st)   print_state(out, st);
 
    fprintf(out,
 "};\n"
@@ -332,6 +450,7 @@ main(int argc, char * argv[])
        }
 
    check_phrases();
+   build_states();
    print_phrases(stdout);
    print_table(stdout);
 